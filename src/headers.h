@@ -8,23 +8,51 @@
 #ifndef HEADERS_H
 #define HEADERS_H
 
+#include <algorithm>
+#include <array>
+#include <exception>
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <string_view>
 #include <utility>
 #include <vector>
 #include <typeinfo>
+#include <unordered_map>
 
 #include <cstdio>
 #include <stdlib.h>
 #include <cstdint>
 #include <cstring>
 
+#include "lib/hex.h"
+#include "lib/result.h"
+#include "lib/output_buffer.h"
+#include "lib/mapped_file.h"
+#include "lib/byte_reader.h"
+#include "lib/string_table.h"
+#include "lib/flag_table.h"
+#include "lib/cpu_features.h"
+#include "lib/crc32c.h"
+#include "lib/md5.h"
+#include "lib/sha1.h"
+#include "lib/sha256.h"
+#include "lib/multi_hasher.h"
+#include "lib/md5_multi.h"
+#include "lib/blake3.h"
+#include "lib/dedupe_filter.h"
+#include "lib/scan_result.h"
+#include "lib/hash_policy.h"
 #include "lib/file_io.h"
+#include "lib/thread_pool.h"
+#include "lib/batch.h"
+#include "lib/tree_walker.h"
+#include "lib/options.h"
 #include "lib/pe.h"
 #include "lib/elf.h"
 #include "lib/macho.h"
-#include "lib/md5.h"
-#include "lib/sha1.h"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,241 @@
+/**
+ * @file batch.cpp
+ * @brief  Implements BatchScanner, parsing many files on a thread pool.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "../headers.h"
+
+/**
+ * @brief Starts the worker pool.
+ *
+ * @param jobs number of worker threads, 0 uses all cores.
+ * @param order whether output follows completion or input order.
+ * @param out stream receiving each file's parsed information.
+ * @param err stream receiving each file's error message.
+ * @param policy hashes computed for each file, by format and size.
+ */
+BatchScanner::BatchScanner(unsigned jobs, outputOrder order,
+                           std::ostream& out, std::ostream& err,
+                           const HashPolicy& policy)
+    : order(order), policy(policy), out(out), err(err), pool(jobs) {
+  // bounds memory held by queued paths and reports waiting for their turn.
+  inFlightLimit = uint64_t(pool.size()) * 64;
+
+  // workers share the cores, a file hashed with BLAKE3 gets its share
+  // instead of starting a thread per core of its own.
+  if (this->policy.threads == 0) {
+    this->policy.threads =
+        std::max(1u, std::thread::hardware_concurrency() / pool.size());
+  }
+}
+
+BatchScanner::~BatchScanner() = default;
+
+/**
+ * @brief Turns duplicate detection on or off, must be called before the
+ * first file is added. With it on, a file with the same content as one
+ * added earlier (finished earlier, for AS_COMPLETED) is reported as a
+ * duplicate of it, without digests or parsing.
+ *
+ * @param enabled whether duplicates are skipped.
+ *
+ * @return none.
+ */
+void BatchScanner::setDedupe(bool enabled) {
+  dedupe = enabled ? std::make_unique<DedupeFilter>(order == INPUT_ORDER)
+                   : nullptr;
+}
+
+/**
+ * @brief Picks the tables printed on top of each file's headers, must be
+ * called before the first file is added.
+ *
+ * @param shown a combination of FileIO::details values.
+ *
+ * @return none.
+ */
+void BatchScanner::setDetails(uint32_t shown) {
+  details = shown;
+}
+
+/**
+ * @brief Queues a file to be parsed, blocks while too many files are
+ * queued or waiting to be written.
+ *
+ * @param path name of a file to be parsed.
+ *
+ * @return none.
+ */
+void BatchScanner::add(const std::string& path) {
+  std::unique_lock<std::mutex> guard(outputLock);
+  slotFree.wait(guard, [this] { return submitted - emitted < inFlightLimit; });
+  uint64_t index = submitted++;
+
+  // submitted in index order, the pool starts them in that order and a
+  // dedupe claim never waits for a file that hasn't started.
+  pool.submit([this, index, path] { scan(index, path); });
+}
+
+/**
+ * @brief Queues every line of a stream as a file name, empty lines are
+ * skipped.
+ *
+ * @param list A stream with one file name per line (a file list or stdin).
+ *
+ * @return none.
+ */
+void BatchScanner::addList(std::istream& list) {
+  std::string line;
+  while (std::getline(list, line)) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (!line.empty()) add(line);
+  }
+}
+
+/**
+ * @brief Waits for all queued files and writes any output still held back.
+ *
+ * @return none.
+ */
+void BatchScanner::finish() {
+  pool.wait();
+  out.flush();
+  err.flush();
+}
+
+uint64_t BatchScanner::getFileCount() const {
+  return this->submitted;
+}
+uint64_t BatchScanner::getFailures() const {
+  return this->failures;
+}
+
+/**
+ * @brief Number of files that failed for a given reason, files that
+ * failed for reasons other than an ErrorCode count as NONE.
+ *
+ * @param code the reason.
+ *
+ * @return the number of files.
+ */
+uint64_t BatchScanner::getFailures(ErrorCode code) const {
+  auto found = failuresByCode.find(code);
+  return found == failuresByCode.end() ? 0 : found->second;
+}
+
+uint64_t BatchScanner::getDuplicates() const {
+  return dedupe ? dedupe->getDuplicates() : 0;
+}
+
+/**
+ * @brief Scans a single file on a worker thread, the rendered result and
+ * error messages are captured and handed to emit(). Known duplicates are
+ * only fingerprinted, files the policy doesn't hash aren't fingerprinted
+ * and give up their dedupe turn.
+ *
+ * @param index position of the file in input order.
+ * @param path name of the file.
+ *
+ * @return none.
+ */
+void BatchScanner::scan(uint64_t index, const std::string& path) {
+  // each worker formats into its own buffer, grown once and reused.
+  thread_local OutputBuffer output;
+  output.clear();
+  Report report;
+  Error error;
+  bool claimed = false;
+
+  try {
+    MappedFile file;
+    error = file.tryOpen(path);
+    if (!error) {
+      std::string first;
+      if (dedupe && isHashed(file.bytes())) {
+        claimed = true;
+        first = dedupe->claim(index, file.bytes(), path, policy.threads);
+      }
+      if (!first.empty()) {
+        output << "Reading " << path << std::endl
+               << "  Duplicate of " << first << std::endl;
+      } else {
+        ScanResult result = FileIO::scan(file.bytes(), path, policy);
+        FileIO::render(result, output, details);
+        error = std::move(result.error);
+      }
+    }
+  } catch (std::exception& except) {
+    // out of memory and the like, nothing wrong with the file itself.
+    report.error = std::string("Exception: ") + except.what() + "\n";
+  }
+  if (dedupe && !claimed) dedupe->pass(index);
+
+  if (error) {
+    report.code = error.code;
+    report.error = "Exception: " + error.message + "\n";
+  }
+  report.output.assign(output.view());
+  emit(index, std::move(report));
+}
+
+/**
+ * @brief Tells whether the hash policy would compute any digest of a
+ * file, only its magic bytes are read.
+ *
+ * @param content the file's bytes.
+ *
+ * @return true if the file gets at least one digest.
+ */
+bool BatchScanner::isHashed(std::span<const std::byte> content) const {
+  uint32_t magic = FileIO::getMagicBytes(
+      reinterpret_cast<const uint8_t*>(content.data()), content.size());
+  return policy.digestsFor(FileIO::classify(magic), content.size()) != 0;
+}
+
+/**
+ * @brief Writes a finished report, or holds it back until all reports
+ * before it are written when input order is requested.
+ *
+ * @param index position of the file in input order.
+ * @param report captured output of the file.
+ *
+ * @return none.
+ */
+void BatchScanner::emit(uint64_t index, Report&& report) {
+  std::lock_guard<std::mutex> guard(outputLock);
+  if (!report.error.empty()) {
+    failures++;
+    failuresByCode[report.code]++;
+  }
+
+  if (order == AS_COMPLETED) {
+    write(report);
+    emitted++;
+  } else {
+    pending.emplace(index, std::move(report));
+    while (!pending.empty() && pending.begin()->first == emitted) {
+      write(pending.begin()->second);
+      pending.erase(pending.begin());
+      emitted++;
+    }
+  }
+  slotFree.notify_all();
+}
+
+/**
+ * @brief Writes one file's report, called with outputLock held.
+ *
+ * @param report captured output of the file.
+ *
+ * @return none.
+ */
+void BatchScanner::write(const Report& report) {
+  out.write(report.output.data(), std::streamsize(report.output.size()));
+  if (!report.error.empty()) {
+    out.flush();
+    err << report.error;
+  }
+}
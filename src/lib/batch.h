@@ -0,0 +1,76 @@
+/**
+ * @file batch.h
+ * @brief  Definitions for BatchScanner, which parses many files across
+ *      all cores and writes their output in a chosen order.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "../headers.h"
+
+/**
+ * @brief BatchScanner hands every file to a ThreadPool worker, each file's
+ * output is collected in memory and written out as a whole, either as soon
+ * as it's done or in the order files were added.
+ */
+class BatchScanner {
+ public:
+  // disabling move/copy constructors
+  BatchScanner(BatchScanner&) = delete;
+  BatchScanner(BatchScanner&&) = delete;
+  BatchScanner& operator=(BatchScanner&) = delete;
+
+  enum outputOrder { AS_COMPLETED = 0, INPUT_ORDER };
+
+  BatchScanner(unsigned, outputOrder, std::ostream&, std::ostream&,
+               const HashPolicy& = HashPolicy());
+  ~BatchScanner();
+
+  void setDedupe(bool);
+  void setDetails(uint32_t);
+  void add(const std::string&);
+  void addList(std::istream&);
+  void finish();
+
+  uint64_t getFileCount() const;
+  uint64_t getFailures() const;
+  uint64_t getFailures(ErrorCode) const;
+  uint64_t getDuplicates() const;
+
+ private:
+  struct Report {
+    std::string output;
+    std::string error;
+    ErrorCode code = ErrorCode::NONE;
+  };
+
+  void scan(uint64_t, const std::string&);
+  bool isHashed(std::span<const std::byte>) const;
+  void emit(uint64_t, Report&&);
+  void write(const Report&);
+
+  outputOrder order;
+  HashPolicy policy;
+  std::ostream& out;
+  std::ostream& err;
+
+  std::mutex outputLock;
+  std::condition_variable slotFree;
+  std::map<uint64_t, Report> pending;  // finished out of order
+  uint64_t submitted = 0;
+  uint64_t emitted = 0;
+  uint64_t failures = 0;
+  std::map<ErrorCode, uint64_t> failuresByCode;
+  uint64_t inFlightLimit;
+  std::unique_ptr<DedupeFilter> dedupe;  // set when duplicates are skipped
+  uint32_t details = 0;                  // see FileIO::details
+
+  // declared last, workers are joined before the members above go away.
+  ThreadPool pool;
+};
+
+#endif
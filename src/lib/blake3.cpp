@@ -0,0 +1,496 @@
+/**
+ * @file blake3.cpp
+ * @brief  BLAKE3 hashing: the compression function, chunk and parent
+ *      nodes, and the tree walk that spreads subtrees over threads.
+ *
+ * The compression function is written once for a generic word type, it
+ * runs on plain uint32_t for single chunks and parent nodes, and on GCC
+ * vector types for groups of whole chunks in functions carrying the
+ * matching target attribute.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "../headers.h"
+
+#include <bit>
+#include <future>
+#include <utility>
+
+namespace {
+
+typedef uint32_t Vector4 __attribute__((vector_size(16)));
+typedef uint32_t Vector8 __attribute__((vector_size(32)));
+typedef uint32_t Vector16 __attribute__((vector_size(64)));
+
+typedef void (*chunkFunction)(const uint8_t*, uint64_t, uint32_t (*)[8]);
+
+constexpr uint32_t initialState[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+                                      0xa54ff53a, 0x510e527f, 0x9b05688c,
+                                      0x1f83d9ab, 0x5be0cd19};
+
+constexpr uint64_t BLOCK_BYTES = 64;
+constexpr uint64_t CHUNK_BYTES = BLAKE3::chunkSize;
+constexpr uint64_t LEAF_CHUNKS = 64;  // chunks hashed before merging
+
+enum nodeFlags { CHUNK_START = 1 << 0,
+                 CHUNK_END = 1 << 1,
+                 PARENT = 1 << 2,
+                 ROOT = 1 << 3 };
+
+/**
+ * @brief Message word order of each of the 7 rounds. Every round applies
+ * the same permutation to the previous round's order.
+ */
+constexpr std::array<std::array<uint8_t, 16>, 7> makeSchedule() {
+  constexpr uint8_t permutation[16] = {2, 6,  3,  10, 7, 0,  4,  13,
+                                       1, 11, 12, 5,  9, 14, 15, 8};
+  std::array<std::array<uint8_t, 16>, 7> schedule{};
+  for (uint8_t word = 0; word < 16; word++) {
+    schedule[0][word] = word;
+  }
+  for (size_t round = 1; round < 7; round++) {
+    for (size_t word = 0; word < 16; word++) {
+      schedule[round][word] = schedule[round - 1][permutation[word]];
+    }
+  }
+  return schedule;
+}
+
+constexpr std::array<std::array<uint8_t, 16>, 7> schedule = makeSchedule();
+
+// rotates in place, vectors aren't returned by value outside their target.
+template <typename W>
+[[gnu::always_inline]] inline void rotateRight(W& value, int bits) {
+  value = (value >> bits) | (value << (32 - bits));
+}
+
+/**
+ * @brief The G function, mixes two message words into one column or
+ * diagonal of the state.
+ */
+template <int A, int B, int C, int D, typename W>
+[[gnu::always_inline]] inline void mix(W (&s)[16], const W& x, const W& y) {
+  s[A] += s[B] + x;
+  s[D] ^= s[A];
+  rotateRight(s[D], 16);
+  s[C] += s[D];
+  s[B] ^= s[C];
+  rotateRight(s[B], 12);
+  s[A] += s[B] + y;
+  s[D] ^= s[A];
+  rotateRight(s[D], 8);
+  s[C] += s[D];
+  s[B] ^= s[C];
+  rotateRight(s[B], 7);
+}
+
+/**
+ * @brief Round R: the four columns, then the four diagonals.
+ */
+template <int R, typename W>
+[[gnu::always_inline]] inline void compressRound(W (&s)[16],
+                                                 const W (&m)[16]) {
+  constexpr const std::array<uint8_t, 16>& order = schedule[R];
+  mix<0, 4, 8, 12>(s, m[order[0]], m[order[1]]);
+  mix<1, 5, 9, 13>(s, m[order[2]], m[order[3]]);
+  mix<2, 6, 10, 14>(s, m[order[4]], m[order[5]]);
+  mix<3, 7, 11, 15>(s, m[order[6]], m[order[7]]);
+  mix<0, 5, 10, 15>(s, m[order[8]], m[order[9]]);
+  mix<1, 6, 11, 12>(s, m[order[10]], m[order[11]]);
+  mix<2, 7, 8, 13>(s, m[order[12]], m[order[13]]);
+  mix<3, 4, 9, 14>(s, m[order[14]], m[order[15]]);
+}
+
+/**
+ * @brief The 7 rounds of the compression function on a state that is
+ * already set up, W is uint32_t or a vector of one word per lane.
+ */
+template <typename W, int... R>
+[[gnu::always_inline]] inline void compressRounds(
+    W (&s)[16], const W (&m)[16], std::integer_sequence<int, R...>) {
+  (compressRound<R>(s, m), ...);
+}
+
+template <typename W>
+[[gnu::always_inline]] inline void compressRounds(W (&s)[16],
+                                                  const W (&m)[16]) {
+  compressRounds(s, m, std::make_integer_sequence<int, 7>());
+}
+
+/**
+ * @brief The last compression of a node, kept unevaluated since the root
+ * node is compressed again with the ROOT flag.
+ */
+struct Output {
+  uint32_t cv[8];
+  uint32_t block[16];
+  uint64_t counter;
+  uint32_t blockLength;
+  uint32_t flags;
+};
+
+/**
+ * @brief Compresses one block, 'out' receives all 16 words of the
+ * resulting state, the first 8 are the new chaining value.
+ */
+void compress(const uint32_t cv[8], const uint32_t (&block)[16],
+              uint64_t counter, uint32_t blockLength, uint32_t flags,
+              uint32_t out[16]) {
+  uint32_t s[16] = {cv[0], cv[1], cv[2], cv[3], cv[4], cv[5],
+                    cv[6], cv[7], initialState[0], initialState[1],
+                    initialState[2], initialState[3], uint32_t(counter),
+                    uint32_t(counter >> 32), blockLength, flags};
+  compressRounds(s, block);
+  for (int word = 0; word < 8; word++) {
+    out[word] = s[word] ^ s[word + 8];
+    out[word + 8] = s[word + 8] ^ cv[word];
+  }
+}
+
+/**
+ * @brief Loads up to one block as little endian words, zero padded.
+ */
+void loadBlock(const uint8_t* data, size_t length, uint32_t block[16]) {
+  uint8_t padded[BLOCK_BYTES] = {};
+  memcpy(padded, data, length);
+  for (int word = 0; word < 16; word++) {
+    const uint8_t* bytes = padded + 4 * word;
+    block[word] = uint32_t(bytes[0]) | uint32_t(bytes[1]) << 8 |
+                  uint32_t(bytes[2]) << 16 | uint32_t(bytes[3]) << 24;
+  }
+}
+
+/**
+ * @brief Hashes all blocks of a chunk but the last one.
+ *
+ * @param data chunk bytes.
+ * @param length 0 to 1024 bytes, only the input's last chunk is short.
+ * @param counter index of the chunk in the input.
+ */
+Output chunkOutput(const uint8_t* data, size_t length, uint64_t counter) {
+  Output output;
+  memcpy(output.cv, initialState, sizeof(output.cv));
+  uint32_t flags = CHUNK_START;
+
+  for (; length > BLOCK_BYTES; data += BLOCK_BYTES, length -= BLOCK_BYTES) {
+    uint32_t state[16];
+    loadBlock(data, BLOCK_BYTES, output.block);
+    compress(output.cv, output.block, counter, BLOCK_BYTES, flags, state);
+    memcpy(output.cv, state, sizeof(output.cv));
+    flags = 0;
+  }
+
+  loadBlock(data, length, output.block);
+  output.counter = counter;
+  output.blockLength = uint32_t(length);
+  output.flags = flags | CHUNK_END;
+  return output;
+}
+
+Output parentOutput(const uint32_t left[8], const uint32_t right[8]) {
+  Output output;
+  memcpy(output.cv, initialState, sizeof(output.cv));
+  memcpy(output.block, left, 8 * sizeof(uint32_t));
+  memcpy(output.block + 8, right, 8 * sizeof(uint32_t));
+  output.counter = 0;
+  output.blockLength = BLOCK_BYTES;
+  output.flags = PARENT;
+  return output;
+}
+
+void chainingValue(const Output& output, uint32_t cv[8]) {
+  uint32_t state[16];
+  compress(output.cv, output.block, output.counter, output.blockLength,
+           output.flags, state);
+  memcpy(cv, state, 8 * sizeof(uint32_t));
+}
+
+BLAKE3::Digest rootDigest(const Output& output) {
+  uint32_t state[16];
+  compress(output.cv, output.block, 0, output.blockLength,
+           output.flags | ROOT, state);
+
+  BLAKE3::Digest digest;
+  for (size_t word = 0; word < 8; word++) {
+    for (size_t byte = 0; byte < 4; byte++) {
+      digest[4 * word + byte] = uint8_t(state[word] >> (8 * byte));
+    }
+  }
+  return digest;
+}
+
+/**
+ * @brief Size of the left subtree: the largest power of two number of
+ * whole chunks that leaves at least one byte to the right.
+ */
+uint64_t leftLength(uint64_t length) {
+  return std::bit_floor((length - 1) / CHUNK_BYTES) * CHUNK_BYTES;
+}
+
+/**
+ * @brief Combines the chaining values of 'count' consecutive chunks the
+ * way the tree does, the left side always gets a power of two.
+ */
+void mergeChunks(const uint32_t (*cvs)[8], uint64_t count, uint32_t cv[8]) {
+  if (count == 1) {
+    memcpy(cv, cvs[0], 8 * sizeof(uint32_t));
+    return;
+  }
+  uint64_t left = std::bit_floor(count - 1);
+  uint32_t leftCv[8], rightCv[8];
+  mergeChunks(cvs, left, leftCv);
+  mergeChunks(cvs + left, count - left, rightCv);
+  chainingValue(parentOutput(leftCv, rightCv), cv);
+}
+
+void subtree(const uint8_t*, uint64_t, uint64_t, unsigned, chunkFunction,
+             unsigned, uint32_t[8]);
+
+/**
+ * @brief Chaining values of both children of a node, the left one is
+ * hashed on a new thread if the node is large enough and threads remain.
+ */
+void children(const uint8_t* data, uint64_t length, uint64_t counter,
+              unsigned threads, chunkFunction lanesFunction, unsigned lanes,
+              uint32_t left[8], uint32_t right[8]) {
+  uint64_t split = leftLength(length);
+  const uint8_t* rightData = data + split;
+  uint64_t rightCounter = counter + split / CHUNK_BYTES;
+
+  if (threads < 2 || length < 2 * BLAKE3::parallelGrain) {
+    subtree(data, split, counter, 1, lanesFunction, lanes, left);
+    subtree(rightData, length - split, rightCounter, 1, lanesFunction, lanes,
+            right);
+    return;
+  }
+
+  // threads are shared in proportion to the bytes on each side.
+  unsigned leftThreads = unsigned(std::clamp<uint64_t>(
+      threads * split / length, 1, threads - 1));
+  auto leftDone = std::async(std::launch::async, [&] {
+    subtree(data, split, counter, leftThreads, lanesFunction, lanes, left);
+  });
+  subtree(rightData, length - split, rightCounter, threads - leftThreads,
+          lanesFunction, lanes, right);
+  leftDone.get();
+}
+
+/**
+ * @brief Chaining value of a subtree that isn't the root. Small subtrees
+ * are hashed chunk by chunk, whole chunks go through the lanes first.
+ *
+ * @param data first byte of the subtree.
+ * @param length bytes in the subtree, more than 0.
+ * @param counter index of its first chunk.
+ * @param threads threads it may use.
+ * @param lanesFunction hashes 'lanes' whole chunks at once, or nullptr.
+ * @param lanes chunks per lanesFunction call.
+ * @param cv receives the chaining value.
+ */
+void subtree(const uint8_t* data, uint64_t length, uint64_t counter,
+             unsigned threads, chunkFunction lanesFunction, unsigned lanes,
+             uint32_t cv[8]) {
+  if (length > LEAF_CHUNKS * CHUNK_BYTES) {
+    uint32_t left[8], right[8];
+    children(data, length, counter, threads, lanesFunction, lanes, left,
+             right);
+    chainingValue(parentOutput(left, right), cv);
+    return;
+  }
+
+  uint32_t cvs[LEAF_CHUNKS][8];
+  uint64_t count = (length + CHUNK_BYTES - 1) / CHUNK_BYTES;
+  uint64_t whole = length / CHUNK_BYTES;
+  uint64_t chunk = 0;
+  if (lanesFunction != nullptr) {
+    for (; chunk + lanes <= whole; chunk += lanes) {
+      lanesFunction(data + chunk * CHUNK_BYTES, counter + chunk, cvs + chunk);
+    }
+  }
+  for (; chunk < count; chunk++) {
+    uint64_t offset = chunk * CHUNK_BYTES;
+    chainingValue(chunkOutput(data + offset,
+                              std::min(CHUNK_BYTES, length - offset),
+                              counter + chunk),
+                  cvs[chunk]);
+  }
+  mergeChunks(cvs, count, cv);
+}
+
+/**
+ * @brief Hashes L whole consecutive chunks with one chunk per lane of
+ * vector type V. Each block is gathered into a transposed buffer (word i
+ * of all lanes side by side) before the rounds.
+ */
+template <typename V, size_t L>
+[[gnu::always_inline]] inline void hashChunkLanes(const uint8_t* data,
+                                                  uint64_t counter,
+                                                  uint32_t (*cvs)[8]) {
+  alignas(64) uint32_t words[16][L];
+  alignas(64) uint32_t counters[2][L];
+  for (size_t lane = 0; lane < L; lane++) {
+    counters[0][lane] = uint32_t(counter + lane);
+    counters[1][lane] = uint32_t((counter + lane) >> 32);
+  }
+
+  V cv[8], counterLow, counterHigh;
+  for (int word = 0; word < 8; word++) {
+    cv[word] = V{} + initialState[word];
+  }
+  memcpy(&counterLow, counters[0], sizeof(V));
+  memcpy(&counterHigh, counters[1], sizeof(V));
+
+  for (uint64_t block = 0; block < CHUNK_BYTES / BLOCK_BYTES; block++) {
+    for (size_t lane = 0; lane < L; lane++) {
+      const uint8_t* bytes = data + lane * CHUNK_BYTES + block * BLOCK_BYTES;
+      for (int word = 0; word < 16; word++) {
+        memcpy(&words[word][lane], bytes + 4 * word, 4);
+      }
+    }
+
+    V m[16];
+    for (int word = 0; word < 16; word++) {
+      memcpy(&m[word], words[word], sizeof(V));
+    }
+
+    uint32_t flags = (block == 0 ? CHUNK_START : 0) |
+                     (block == CHUNK_BYTES / BLOCK_BYTES - 1 ? CHUNK_END : 0);
+    V s[16] = {cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+               V{} + initialState[0], V{} + initialState[1],
+               V{} + initialState[2], V{} + initialState[3],
+               counterLow, counterHigh, V{} + uint32_t(BLOCK_BYTES),
+               V{} + flags};
+    compressRounds(s, m);
+    for (int word = 0; word < 8; word++) {
+      cv[word] = s[word] ^ s[word + 8];
+    }
+  }
+
+  for (int word = 0; word < 8; word++) {
+    memcpy(words[word], &cv[word], sizeof(V));
+    for (size_t lane = 0; lane < L; lane++) {
+      cvs[lane][word] = words[word][lane];
+    }
+  }
+}
+
+}  // namespace
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("sse2"), flatten)) void BLAKE3::hashChunksSse2(
+    const uint8_t* data, uint64_t counter, uint32_t (*cvs)[8]) {
+  hashChunkLanes<Vector4, 4>(data, counter, cvs);
+}
+
+__attribute__((target("avx2"), flatten)) void BLAKE3::hashChunksAvx2(
+    const uint8_t* data, uint64_t counter, uint32_t (*cvs)[8]) {
+  hashChunkLanes<Vector8, 8>(data, counter, cvs);
+}
+
+__attribute__((target("avx512f"), flatten)) void BLAKE3::hashChunksAvx512(
+    const uint8_t* data, uint64_t counter, uint32_t (*cvs)[8]) {
+  hashChunkLanes<Vector16, 16>(data, counter, cvs);
+}
+
+#else
+
+void BLAKE3::hashChunksSse2(const uint8_t* data, uint64_t counter,
+                            uint32_t (*cvs)[8]) {
+  hashChunkLanes<Vector4, 4>(data, counter, cvs);
+}
+
+void BLAKE3::hashChunksAvx2(const uint8_t* data, uint64_t counter,
+                            uint32_t (*cvs)[8]) {
+  hashChunkLanes<Vector8, 8>(data, counter, cvs);
+}
+
+void BLAKE3::hashChunksAvx512(const uint8_t* data, uint64_t counter,
+                              uint32_t (*cvs)[8]) {
+  hashChunkLanes<Vector16, 16>(data, counter, cvs);
+}
+
+#endif
+
+/**
+ * @brief Returns the widest lane count the CPU supports, checked once.
+ *
+ * @return an implementation, SCALAR on CPUs without usable vectors.
+ */
+BLAKE3::implementation BLAKE3::bestImplementation() {
+  static const implementation best = isSupported(AVX512) ? AVX512
+                                     : isSupported(AVX2) ? AVX2
+                                     : isSupported(SSE2) ? SSE2
+                                                         : SCALAR;
+  return best;
+}
+
+/**
+ * @brief Tells whether an implementation can run on this CPU.
+ *
+ * @param impl the implementation.
+ *
+ * @return true if it can be used.
+ */
+bool BLAKE3::isSupported(implementation impl) {
+  const CpuFeatures& cpu = CpuFeatures::get();
+  switch (impl) {
+    case SCALAR:
+      return true;
+    case SSE2:
+      return cpu.sse2;
+    case AVX2:
+      return cpu.avx2;
+    case AVX512:
+      return cpu.avx512f;
+  }
+  return false;
+}
+
+/**
+ * @brief Hashes a buffer with the widest implementation available.
+ *
+ * @param content bytes to be hashed.
+ * @param threads most threads to use, inputs under 2 * parallelGrain
+ *      are hashed on the calling thread.
+ *
+ * @return the 32 byte digest.
+ */
+BLAKE3::Digest BLAKE3::hash(std::span<const std::byte> content,
+                            unsigned threads) {
+  return hash(content, threads, bestImplementation());
+}
+
+/**
+ * @brief Hashes a buffer with a given implementation, falling back to one
+ * chunk at a time when it isn't supported. The result doesn't depend on
+ * the implementation or the number of threads.
+ *
+ * @param content bytes to be hashed.
+ * @param threads most threads to use.
+ * @param impl the implementation to use.
+ *
+ * @return the 32 byte digest.
+ */
+BLAKE3::Digest BLAKE3::hash(std::span<const std::byte> content,
+                            unsigned threads, implementation impl) {
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(content.data());
+  uint64_t length = content.size();
+
+  if (length <= CHUNK_BYTES) {
+    return rootDigest(chunkOutput(data, length, 0));
+  }
+
+  if (!isSupported(impl)) impl = SCALAR;
+  chunkFunction lanesFunction = impl == AVX512 ? hashChunksAvx512
+                                : impl == AVX2 ? hashChunksAvx2
+                                : impl == SSE2 ? hashChunksSse2
+                                               : nullptr;
+
+  uint32_t left[8], right[8];
+  children(data, length, 0, std::max(threads, 1u), lanesFunction,
+           unsigned(impl), left, right);
+  return rootDigest(parentOutput(left, right));
+}
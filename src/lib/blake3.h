@@ -0,0 +1,51 @@
+/**
+ * @file blake3.h
+ * @brief  Definitions for BLAKE3, a tree hash whose chunks can be hashed
+ *      in parallel, across threads and across SIMD lanes.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ * @ref https://github.com/BLAKE3-team/BLAKE3-specs
+ *
+ * @author Abdullah Ada
+ */
+#ifndef BLAKE3_H
+#define BLAKE3_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief BLAKE3 cuts its input in 1 KB chunks, hashes every chunk on its
+ * own and combines the results in a binary tree. Chunks don't depend on
+ * each other, so 4, 8 or 16 of them run side by side in the lanes of a
+ * vector register, and large subtrees are handed to other threads. The
+ * whole input must be in memory (usually a MappedFile), there's no
+ * incremental interface.
+ */
+class BLAKE3 {
+ public:
+  // the value of each implementation is its number of lanes.
+  enum implementation { SCALAR = 1, SSE2 = 4, AVX2 = 8, AVX512 = 16 };
+
+  typedef std::array<uint8_t, 32> Digest;
+
+  static Digest hash(std::span<const std::byte>, unsigned threads = 1);
+  static Digest hash(std::span<const std::byte>, unsigned threads,
+                     implementation);
+
+  static implementation bestImplementation();
+  static bool isSupported(implementation);
+
+  static constexpr uint64_t chunkSize = 1024;
+  // subtrees smaller than this are never split across threads.
+  static constexpr uint64_t parallelGrain = 1 << 20;
+
+ private:
+  static void hashChunksSse2(const uint8_t*, uint64_t, uint32_t (*)[8]);
+  static void hashChunksAvx2(const uint8_t*, uint64_t, uint32_t (*)[8]);
+  static void hashChunksAvx512(const uint8_t*, uint64_t, uint32_t (*)[8]);
+};
+
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file byte_reader.cpp
+ * @brief  Out of line parts of ByteReader.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "byte_reader.h"
+
+#include <stdexcept>
+
+/**
+ * @brief Creates a reader over an existing buffer, the buffer must outlive
+ * the reader.
+ *
+ * @param data start of the buffer.
+ * @param size number of readable bytes.
+ */
+ByteReader::ByteReader(const uint8_t* data, uint64_t size)
+    : base(data), length(size) {}
+
+/**
+ * @brief Creates a reader over the whole content of a mapped file.
+ *
+ * @param file an already opened MappedFile.
+ */
+ByteReader::ByteReader(const MappedFile& file)
+    : base(file.data()), length(file.size()) {}
+
+/**
+ * @brief Creates a reader over an image held in a caller's buffer, offsets
+ * are relative to the start of the image. Nothing is copied, the buffer
+ * has to outlive the reader.
+ *
+ * @param buffer bytes holding the image.
+ * @param offset where the image starts inside the buffer.
+ */
+ByteReader::ByteReader(std::span<const std::byte> buffer, uint64_t offset)
+    : base(reinterpret_cast<const uint8_t*>(buffer.data())),
+      length(buffer.size()) {
+  if (offset > length) {
+    throw std::out_of_range("Image offset " + std::to_string(offset) +
+                            " is past the end of a " +
+                            std::to_string(length) + " byte buffer");
+  }
+  base += offset;
+  length -= offset;
+}
+
+/**
+ * @brief Reports a read that doesn't fit in the buffer.
+ *
+ * @param count number of bytes that were requested.
+ *
+ * @return never returns, throws std::out_of_range.
+ */
+void ByteReader::outOfRange(uint64_t count) const {
+  throw std::out_of_range("Truncated file: reading " + std::to_string(count) +
+                          " bytes at offset " + std::to_string(position));
+}
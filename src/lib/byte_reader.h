@@ -0,0 +1,213 @@
+/**
+ * @file byte_reader.h
+ * @brief  Definitions for ByteReader, a bounds-checked cursor over bytes
+ *      already in memory (a MappedFile or a caller's buffer).
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef BYTE_READER_H
+#define BYTE_READER_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "mapped_file.h"
+
+/**
+ * @brief ByteReader decodes integers from a memory buffer, it mirrors the
+ * seek/tell/read interface parsers used with std::ifstream, but every read
+ * is a plain load. Reading past the end throws std::out_of_range.
+ */
+class ByteReader {
+ public:
+  ByteReader(const uint8_t*, uint64_t);
+  explicit ByteReader(const MappedFile&);
+  explicit ByteReader(std::span<const std::byte>, uint64_t = 0);
+
+  uint8_t read_u8();
+  uint16_t read_u16(bool);
+  uint32_t read_u32(bool);
+  uint64_t read_u64(bool);
+  const uint8_t* read_bytes(uint64_t);
+  const uint8_t* read_table(uint64_t, uint64_t);
+  std::string_view read_string(uint64_t = UINT64_MAX);
+
+  template <typename T, std::endian Order = std::endian::little>
+  T read();
+  template <typename T, std::endian Order = std::endian::little>
+  static T decode(const uint8_t*);
+  template <typename T>
+  static constexpr T byteSwap(T);
+
+  void seek(uint64_t offset) { position = offset; }
+  void skip(uint64_t count) { position += count; }
+  uint64_t tell() const { return position; }
+  uint64_t size() const { return length; }
+  const uint8_t* data() const { return base; }
+
+ private:
+  const uint8_t* take(uint64_t count) {
+    if (position > length || count > length - position) outOfRange(count);
+    const uint8_t* ptr = base + position;
+    position += count;
+    return ptr;
+  }
+  [[noreturn]] void outOfRange(uint64_t) const;
+
+  const uint8_t* base;
+  uint64_t length;
+  uint64_t position = 0;
+};
+
+/**
+ * @brief Reads unsigned 8 bits and returns them.
+ *
+ * @return an 8 bit unsigned integer.
+ */
+inline uint8_t ByteReader::read_u8() {
+  return *take(1);
+}
+
+/**
+ * @brief Reads unsigned 16 bits in the given byte order. Parsers that know
+ * the byte order up front use read<uint16_t, Order>() instead.
+ *
+ * @param littleEnd Indicates byte order, True: Little end. False: Big end.
+ *
+ * @return a 16 bit unsigned integer.
+ */
+inline uint16_t ByteReader::read_u16(bool littleEnd) {
+  return littleEnd ? read<uint16_t>() : read<uint16_t, std::endian::big>();
+}
+
+/**
+ * @brief Reads unsigned 32 bits in the given byte order.
+ *
+ * @param littleEnd Indicates byte order, True: Little end. False: Big end.
+ *
+ * @return a 32 bit unsigned integer.
+ */
+inline uint32_t ByteReader::read_u32(bool littleEnd) {
+  return littleEnd ? read<uint32_t>() : read<uint32_t, std::endian::big>();
+}
+
+/**
+ * @brief Reads unsigned 64 bits in the given byte order.
+ *
+ * @param littleEnd Indicates byte order, True: Little end. False: Big end.
+ *
+ * @return a 64 bit unsigned integer.
+ */
+inline uint64_t ByteReader::read_u64(bool littleEnd) {
+  return littleEnd ? read<uint64_t>() : read<uint64_t, std::endian::big>();
+}
+
+/**
+ * @brief Reads an unsigned integer stored in a byte order known at compile
+ * time: one bounds check, one load and a byte swap when the order isn't
+ * the host's.
+ *
+ * @return the integer in host byte order.
+ */
+template <typename T, std::endian Order>
+inline T ByteReader::read() {
+  return decode<T, Order>(take(sizeof(T)));
+}
+
+/**
+ * @brief Decodes an unsigned integer from memory that was already bounds
+ * checked, the byte order is known at compile time.
+ *
+ * @param ptr first byte of the integer, no alignment needed.
+ *
+ * @return the integer in host byte order.
+ */
+template <typename T, std::endian Order>
+inline T ByteReader::decode(const uint8_t* ptr) {
+  static_assert(Order == std::endian::little || Order == std::endian::big);
+  T value;
+  std::memcpy(&value, ptr, sizeof(T));
+  if constexpr (Order != std::endian::native) value = byteSwap(value);
+  return value;
+}
+
+/**
+ * @brief Reverses the byte order of an unsigned integer.
+ *
+ * @param value an 8, 16, 32 or 64 bit unsigned integer.
+ *
+ * @return value with its bytes reversed.
+ */
+template <typename T>
+constexpr T ByteReader::byteSwap(T value) {
+  static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 ||
+                sizeof(T) == 8);
+  if constexpr (sizeof(T) == 2) return T(__builtin_bswap16(value));
+  if constexpr (sizeof(T) == 4) return T(__builtin_bswap32(value));
+  if constexpr (sizeof(T) == 8) return T(__builtin_bswap64(value));
+  return value;
+}
+
+/**
+ * @brief Returns a pointer to the next 'count' bytes and moves past them,
+ * no copy is made.
+ *
+ * @param count number of bytes needed.
+ *
+ * @return pointer into the underlying buffer.
+ */
+inline const uint8_t* ByteReader::read_bytes(uint64_t count) {
+  return take(count);
+}
+
+/**
+ * @brief Returns a pointer to a table of fixed size records and moves past
+ * it. The whole table is bounds checked once, so records can be decoded
+ * with decode() in a tight loop.
+ *
+ * @param count number of records.
+ * @param stride size of a record, including any padding.
+ *
+ * @return pointer to the first record.
+ */
+inline const uint8_t* ByteReader::read_table(uint64_t count, uint64_t stride) {
+  if (stride != 0 && count > length / stride) outOfRange(count * stride);
+  return take(count * stride);
+}
+
+/**
+ * @brief Returns the NUL terminated string at the current position and
+ * moves past its NUL, no copy is made. At most maxLength + 1 bytes are
+ * searched for the NUL.
+ *
+ * @param maxLength longest string accepted, NUL not included.
+ *
+ * @return a view of the string, without the NUL. throws
+ * std::runtime_error if the string is longer than maxLength.
+ */
+inline std::string_view ByteReader::read_string(uint64_t maxLength) {
+  if (position >= length) outOfRange(1);
+  uint64_t left = length - position;
+  uint64_t searched = maxLength < left ? maxLength + 1 : left;
+  const uint8_t* start = base + position;
+  const void* end = std::memchr(start, '\0', searched);
+  if (end == nullptr && searched == left) outOfRange(left + 1);
+  if (end == nullptr) {
+    throw std::runtime_error("string longer than " +
+                             std::to_string(maxLength) + " bytes");
+  }
+
+  uint64_t count = uint64_t(static_cast<const uint8_t*>(end) - start);
+  position += count + 1;
+  return {reinterpret_cast<const char*>(start), count};
+}
+
+#endif
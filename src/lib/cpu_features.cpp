@@ -0,0 +1,55 @@
+/**
+ * @file cpu_features.cpp
+ * @brief  Detects instruction set extensions of the running CPU.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "cpu_features.h"
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+/**
+ * @brief Asks the CPU (cpuid, or the kernel's hwcaps on ARM) which
+ * extensions it has. AVX flags are only set when the OS saves the wider
+ * registers, __builtin_cpu_supports checks that for us.
+ *
+ * @return detected features.
+ */
+static CpuFeatures detect() {
+  CpuFeatures features;
+
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  features.sse2 = __builtin_cpu_supports("sse2");
+  features.ssse3 = __builtin_cpu_supports("ssse3");
+  features.sse41 = __builtin_cpu_supports("sse4.1");
+  features.sse42 = __builtin_cpu_supports("sse4.2");
+  features.pclmul = __builtin_cpu_supports("pclmul");
+  features.avx2 = __builtin_cpu_supports("avx2");
+  features.avx512f = __builtin_cpu_supports("avx512f");
+  features.sha = __builtin_cpu_supports("sha");
+#elif defined(__aarch64__) && defined(__linux__)
+  unsigned long hwcaps = getauxval(AT_HWCAP);
+  features.armSha1 = hwcaps & HWCAP_SHA1;
+  features.armSha2 = hwcaps & HWCAP_SHA2;
+  features.armCrc32 = hwcaps & HWCAP_CRC32;
+#endif
+
+  return features;
+}
+
+/**
+ * @brief Returns the features of the CPU we're running on, detected on the
+ * first call.
+ *
+ * @return detected features.
+ */
+const CpuFeatures& CpuFeatures::get() {
+  static const CpuFeatures features = detect();
+  return features;
+}
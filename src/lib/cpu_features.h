@@ -0,0 +1,37 @@
+/**
+ * @file cpu_features.h
+ * @brief  Definitions for CpuFeatures, the instruction set extensions the
+ *      hashing code can pick from at run time.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+/**
+ * @brief CpuFeatures is filled in once, the first time get() is called, and
+ * read-only afterwards. Every flag is false on CPUs/builds where the
+ * extension doesn't exist.
+ */
+struct CpuFeatures {
+  // x86
+  bool sse2 = false;
+  bool ssse3 = false;
+  bool sse41 = false;
+  bool sse42 = false;
+  bool pclmul = false;
+  bool avx2 = false;
+  bool avx512f = false;
+  bool sha = false;  // SHA-1/SHA-256 extensions (SHA-NI)
+
+  // ARMv8 crypto extensions
+  bool armSha1 = false;
+  bool armSha2 = false;
+  bool armCrc32 = false;
+
+  static const CpuFeatures& get();
+};
+
+#endif
@@ -0,0 +1,204 @@
+/**
+ * @file crc32c.cpp
+ * @brief  CRC32C (polynomial 0x1EDC6F41, reflected), a slicing-by-8 table
+ *      version and one using the SSE4.2 crc32 instruction.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "crc32c.h"
+#include "cpu_features.h"
+#include "hex.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr uint32_t POLYNOMIAL = 0x82F63B78;  // 0x1EDC6F41 bit reversed
+
+/**
+ * @brief table[0] is the usual byte at a time table, table[k] advances a
+ * byte k positions further, so 8 bytes are folded with 8 loads.
+ */
+constexpr std::array<std::array<uint32_t, 256>, 8> makeTables() {
+  std::array<std::array<uint32_t, 256>, 8> table{};
+  for (uint32_t value = 0; value < 256; value++) {
+    uint32_t crc = value;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (crc & 1 ? POLYNOMIAL : 0);
+    }
+    table[0][value] = crc;
+  }
+  for (size_t slice = 1; slice < 8; slice++) {
+    for (uint32_t value = 0; value < 256; value++) {
+      uint32_t previous = table[slice - 1][value];
+      table[slice][value] = (previous >> 8) ^ table[0][previous & 0xff];
+    }
+  }
+  return table;
+}
+
+constexpr std::array<std::array<uint32_t, 256>, 8> tables = makeTables();
+
+}  // namespace
+
+/**
+ * @brief Portable update, eight bytes per step.
+ *
+ * @param crc running value, already inverted.
+ * @param data bytes to add.
+ * @param length number of bytes.
+ *
+ * @return the new running value.
+ */
+uint32_t CRC32C::updateScalar(uint32_t crc, const uint8_t* data,
+                              size_t length) {
+  for (; length >= 8; data += 8, length -= 8) {
+    uint32_t low = crc ^ (uint32_t(data[0]) | uint32_t(data[1]) << 8 |
+                          uint32_t(data[2]) << 16 | uint32_t(data[3]) << 24);
+    crc = tables[7][low & 0xff] ^ tables[6][(low >> 8) & 0xff] ^
+          tables[5][(low >> 16) & 0xff] ^ tables[4][low >> 24] ^
+          tables[3][data[4]] ^ tables[2][data[5]] ^ tables[1][data[6]] ^
+          tables[0][data[7]];
+  }
+  for (; length > 0; data++, length--) {
+    crc = (crc >> 8) ^ tables[0][(crc ^ *data) & 0xff];
+  }
+  return crc;
+}
+
+#if defined(__x86_64__)
+
+/**
+ * @brief Update using the crc32 instruction, eight bytes per step.
+ *
+ * @param crc running value, already inverted.
+ * @param data bytes to add.
+ * @param length number of bytes.
+ *
+ * @return the new running value.
+ */
+__attribute__((target("sse4.2"))) uint32_t CRC32C::updateSse42(
+    uint32_t crc, const uint8_t* data, size_t length) {
+  uint64_t wide = crc;
+  for (; length >= 8; data += 8, length -= 8) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    wide = _mm_crc32_u64(wide, word);
+  }
+  crc = uint32_t(wide);
+  for (; length > 0; data++, length--) {
+    crc = _mm_crc32_u8(crc, *data);
+  }
+  return crc;
+}
+
+#else
+
+uint32_t CRC32C::updateSse42(uint32_t crc, const uint8_t* data,
+                             size_t length) {
+  return updateScalar(crc, data, length);
+}
+
+#endif
+
+/**
+ * @brief Returns the fastest update function the CPU supports, checked
+ * once.
+ *
+ * @return an implementation.
+ */
+CRC32C::implementation CRC32C::bestImplementation() {
+  static const implementation best = isSupported(SSE42) ? SSE42 : SCALAR;
+  return best;
+}
+
+/**
+ * @brief Tells whether an update function can run on this CPU.
+ *
+ * @param impl the implementation.
+ *
+ * @return true if it can be used.
+ */
+bool CRC32C::isSupported(implementation impl) {
+  switch (impl) {
+    case SCALAR:
+      return true;
+    case SSE42:
+#if defined(__x86_64__)
+      return CpuFeatures::get().sse42;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+CRC32C::CRC32C() : CRC32C(bestImplementation()) {}
+
+/**
+ * @brief Creates a checksum using a given update function, unsupported
+ * ones fall back to the portable one.
+ *
+ * @param impl the implementation.
+ */
+CRC32C::CRC32C(implementation impl) : crc(0xFFFFFFFF) {
+  updater = isSupported(impl) && impl == SSE42 ? updateSse42 : updateScalar;
+}
+
+/**
+ * @brief Adds bytes to the message.
+ *
+ * @param data bytes to be checksummed.
+ * @param length number of bytes.
+ */
+void CRC32C::update(const uint8_t* data, size_t length) {
+  crc = updater(crc, data, length);
+}
+
+void CRC32C::update(std::span<const std::byte> data) {
+  update(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+/**
+ * @brief Returns the checksum of the message, the object is then reset
+ * for a new message.
+ *
+ * @return the CRC.
+ */
+uint32_t CRC32C::finalValue() {
+  uint32_t value = ~crc;
+  crc = 0xFFFFFFFF;
+  return value;
+}
+
+/**
+ * @brief Same as finalValue(), formatted with toString().
+ *
+ * @return the formatted CRC.
+ */
+std::string CRC32C::final() {
+  return toString(finalValue());
+}
+
+/**
+ * @brief Formats a CRC as 8 lowercase hex characters, most significant
+ * first.
+ *
+ * @param value a CRC.
+ *
+ * @return the formatted CRC.
+ */
+std::string CRC32C::toString(uint32_t value) {
+  const uint8_t bytes[4] = {uint8_t(value >> 24), uint8_t(value >> 16),
+                            uint8_t(value >> 8), uint8_t(value)};
+  std::string hex(8, '0');
+  Hex::encode(bytes, sizeof(bytes), hex.data());
+  return hex;
+}
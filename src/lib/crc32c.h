@@ -0,0 +1,52 @@
+/**
+ * @file crc32c.h
+ * @brief  Definitions for CRC32C, the Castagnoli CRC used as a cheap
+ *      content fingerprint.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+/**
+ * @brief CRC32C checksums a message incrementally. It isn't a
+ * cryptographic digest, it is meant to tell files apart quickly: with the
+ * SSE4.2 crc32 instruction it runs several times faster than MD5.
+ */
+class CRC32C {
+ public:
+  /* Update functions, the fastest one the CPU supports is picked */
+  enum implementation { SCALAR = 0, SSE42 };
+
+  CRC32C();
+  explicit CRC32C(implementation impl);
+  void update(const uint8_t* data, size_t length);
+  void update(std::span<const std::byte> data);
+  uint32_t finalValue();
+  std::string final();
+
+  static std::string toString(uint32_t value);
+  static implementation bestImplementation();
+  static bool isSupported(implementation impl);
+
+ private:
+  typedef uint32_t (*updateFunction)(uint32_t crc, const uint8_t* data,
+                                     size_t length);
+
+  static uint32_t updateScalar(uint32_t crc, const uint8_t* data,
+                               size_t length);
+  static uint32_t updateSse42(uint32_t crc, const uint8_t* data,
+                              size_t length);
+
+  updateFunction updater;
+  uint32_t crc;
+};
+
+#endif
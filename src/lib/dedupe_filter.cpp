@@ -0,0 +1,107 @@
+/**
+ * @file dedupe_filter.cpp
+ * @brief  Implements DedupeFilter, duplicate detection by size and CRC32C
+ *      confirmed by a BLAKE3 digest.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "../headers.h"
+
+/**
+ * @brief Starts with no files seen.
+ *
+ * @param inputOrder whether the first copy in input order is the original,
+ * rather than the first copy claimed.
+ */
+DedupeFilter::DedupeFilter(bool inputOrder) : inputOrder(inputOrder) {}
+
+/**
+ * @brief Fingerprints a file's content and tells whether an earlier file
+ * has the same content. The CRC and digest are computed right away, in
+ * input order the lookup waits until every earlier file's turn is over and
+ * every file number has to be given to claim() or pass() exactly once.
+ *
+ * @param index position of the file in input order.
+ * @param content the file's bytes.
+ * @param name name of the file, kept if it is the first with its content.
+ * @param threads number of threads the BLAKE3 digest may use.
+ *
+ * @return the name of the first file with the same content, or an empty
+ * string if there was none.
+ */
+std::string DedupeFilter::claim(uint64_t index,
+                                std::span<const std::byte> content,
+                                const std::string& name, unsigned threads) {
+  CRC32C crc;
+  crc.update(content);
+  Key key(content.size(), crc.finalValue());
+  BLAKE3::Digest digest = BLAKE3::hash(content, threads);
+
+  std::unique_lock<std::mutex> guard(lock);
+  if (inputOrder) {
+    turnTaken.wait(guard, [this, index] { return nextTurn == index; });
+  }
+
+  std::string first;
+  try {
+    std::vector<Original>& candidates = seen[key];
+    for (const Original& candidate : candidates) {
+      if (candidate.digest == digest) {
+        first = candidate.name;
+        break;
+      }
+    }
+    if (first.empty()) {
+      candidates.push_back(Original{digest, name});
+    } else {
+      duplicates++;
+    }
+  } catch (...) {
+    if (inputOrder) endTurn(index);
+    throw;
+  }
+  if (inputOrder) endTurn(index);
+  return first;
+}
+
+/**
+ * @brief Gives up the turn of a file that isn't fingerprinted, because it
+ * couldn't be read or isn't hashed. It doesn't wait for earlier files.
+ *
+ * @param index position of the file in input order.
+ *
+ * @return none.
+ */
+void DedupeFilter::pass(uint64_t index) {
+  if (!inputOrder) return;
+  std::lock_guard<std::mutex> guard(lock);
+  endTurn(index);
+}
+
+/**
+ * @brief Marks a file's turn as over and moves on to the first file still
+ * waiting for its turn. The lock has to be held.
+ *
+ * @param index position of the file in input order.
+ *
+ * @return none.
+ */
+void DedupeFilter::endTurn(uint64_t index) {
+  if (index != nextTurn) {
+    finished.insert(index);
+    return;
+  }
+  nextTurn++;
+  while (!finished.empty() && *finished.begin() == nextTurn) {
+    finished.erase(finished.begin());
+    nextTurn++;
+  }
+  turnTaken.notify_all();
+}
+
+uint64_t DedupeFilter::getDuplicates() const {
+  std::lock_guard<std::mutex> guard(lock);
+  return this->duplicates;
+}
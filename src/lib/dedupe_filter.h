@@ -0,0 +1,71 @@
+/**
+ * @file dedupe_filter.h
+ * @brief  Definitions for DedupeFilter, which spots repeated files by a
+ *      cheap fingerprint before they are hashed and parsed.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef DEDUPE_FILTER_H
+#define DEDUPE_FILTER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief DedupeFilter remembers the size and CRC32C of every file it is
+ * shown, along with the BLAKE3 digest and name of the files that had them.
+ * A CRC32C is easily forged, so equal keys are only a hint: a file is
+ * reported as a duplicate only when its digest matches too. Nothing is
+ * read back from disk, earlier files may be gone or changed by then.
+ * Files that match nothing need the digests of the hash policy and
+ * parsing.
+ *
+ * In input order, files are numbered and their claims are settled in that
+ * order, the first copy in the input is always the original whichever
+ * worker fingerprints it first. Fingerprints are computed before a claim
+ * waits for its turn, the turn only covers the lookup. Otherwise the first
+ * copy claimed is the original and claims don't wait. It can be shared by
+ * any number of threads.
+ */
+class DedupeFilter {
+ public:
+  // disabling move/copy constructors
+  DedupeFilter(DedupeFilter&) = delete;
+  DedupeFilter(DedupeFilter&&) = delete;
+  DedupeFilter& operator=(DedupeFilter&) = delete;
+
+  explicit DedupeFilter(bool inputOrder = true);
+
+  std::string claim(uint64_t, std::span<const std::byte>,
+                    const std::string&, unsigned = 1);
+  void pass(uint64_t);
+  uint64_t getDuplicates() const;
+
+ private:
+  typedef std::pair<uint64_t, uint32_t> Key;  // size, CRC32C
+  struct Original {
+    BLAKE3::Digest digest;
+    std::string name;
+  };
+
+  void endTurn(uint64_t);
+
+  const bool inputOrder;  // claims are settled in file number order
+  mutable std::mutex lock;
+  std::condition_variable turnTaken;
+  std::map<Key, std::vector<Original>> seen;  // originals, by key
+  uint64_t nextTurn = 0;        // lowest file whose turn isn't over
+  std::set<uint64_t> finished;  // later files done out of turn
+  uint64_t duplicates = 0;
+};
+
+#endif
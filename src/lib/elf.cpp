@@ -29,351 +29,361 @@ ELF::ELF(std::string filename) {
  * @return none.
  */
 void ELF::init(std::string filename) {
-  std::ifstream file(filename, std::ios::binary);
-
-  magicBytes_u32 = FileIO::read_u32(file, false);
-  ei_class_u8 =  FileIO::read_u8(file);
-  ei_data_u8  = FileIO::read_u8(file);
-  ei_version_u8 = FileIO::read_u8(file);
-  ei_osabi_u8 = FileIO::read_u8(file);
-
-  // skipping e_ident field.
-  file.seekg(0x10);
-  
-  if (ei_class_u8 & 1) {
-    parse32(file, ei_data_u8);
-  } else if (ei_class_u8 & 2) {
-    parse64(file, ei_data_u8);
-  }
-
-  mapFlags();
+  MappedFile mapped(filename);
+  init(mapped.bytes());
 }
 
 /**
- * @brief Saves integer IDs and their meanings into mappings.
+ * @brief Parses an image already in memory, without copying it or touching
+ * the file system. The buffer is only read during the call.
+ *
+ * @param image bytes holding the image.
+ * @param base offset of the image inside the buffer, file offsets found in
+ * the headers are relative to it.
  *
  * @return none.
  */
-void ELF::mapFlags() {
-  using namespace std;
-  etypeFlags.try_emplace(0, "NONE");
-  etypeFlags.try_emplace(1, "ET_REL");
-  etypeFlags.try_emplace(2, "ET_EXEC");
-  etypeFlags.try_emplace(3, "Dynamic / Position Independant ET_DYN");
-  etypeFlags.try_emplace(4, "ET_CORE");
-  etypeFlags.try_emplace(5, "ET_LOOS");
-
-
-  emachineFlags.try_emplace(40, "ARM (EM_ARM)");
-  emachineFlags.try_emplace(41, "EM_ALPHA");
-  emachineFlags.try_emplace(50, "EM_IA_64");
-  emachineFlags.try_emplace(51, "EM_MIPS_X");
-  emachineFlags.try_emplace(62, "64bit (EM_X86_64)");
-  emachineFlags.try_emplace(3, "Intel 386 (EM_386)");
-  emachineFlags.try_emplace(8, "MIPS (EM_MIPS)");
-  emachineFlags.try_emplace(10, "EM_MIPS_RS3_LE");
-
-  eclassFlags.try_emplace(1, "32bit (ELFCLASS32)");
-  eclassFlags.try_emplace(2, "64bit (ELFCLASS64)");
-
-  edataFlags.try_emplace(1, "Least Significant Byte (LSB)");
-  edataFlags.try_emplace(2, "Most Significant Byte (MSB)");
-
-  eiosabiFlags.try_emplace(0, "NONE");
-  eiosabiFlags.try_emplace(1, "HPUX");
-  eiosabiFlags.try_emplace(2, "NETBSD");
-  eiosabiFlags.try_emplace(3, "Linux");
-  eiosabiFlags.try_emplace(6, "SOLARIS");
-  eiosabiFlags.try_emplace(7, "AIX");
-  eiosabiFlags.try_emplace(8, "IRIX");
-  eiosabiFlags.try_emplace(9, "FREEBSD");
-  eiosabiFlags.try_emplace(10, "TRU64");
-  eiosabiFlags.try_emplace(12, "OPENBSD");
-  eiosabiFlags.try_emplace(64, "ARM_AEABI");
-  eiosabiFlags.try_emplace(97, "ARM");
-  
-  programHeaderType_m.try_emplace(0, "PT_NULL");
-  programHeaderType_m.try_emplace(1, "PT_LOAD");
-  programHeaderType_m.try_emplace(2, "PT_DYNAMIC");
-  programHeaderType_m.try_emplace(3, "PT_INTERP");
-  programHeaderType_m.try_emplace(4, "PT_NOTE");
-  programHeaderType_m.try_emplace(5, "PT_SHLIB");
-  programHeaderType_m.try_emplace(6, "PT_PHDR");
-  programHeaderType_m.try_emplace(7, "PT_TLS");
-  programHeaderType_m.try_emplace(8, "PT_NUM");
-  programHeaderType_m.try_emplace(0x60000000, "PT_LOOS");
-  programHeaderType_m.try_emplace(0x6474e550, "PT_GNU_EH_FRAME");
-  programHeaderType_m.try_emplace(0x6474e551, "PT_GNU_STACK");
-  programHeaderType_m.try_emplace(0x6474e552, "PT_GNU_RELRO");
-  programHeaderType_m.try_emplace(0x6474e553, "PT_GNU_PROPERTY");
-  programHeaderType_m.try_emplace(0x6ffffffa, "PT_LOSUNW");
-  programHeaderType_m.try_emplace(0x6ffffffa, "PT_SUNWBSS");
-  programHeaderType_m.try_emplace(0x6ffffffb, "PT_SUNWSTACK");
-  programHeaderType_m.try_emplace(0x6fffffff, "PT_HISUNW");
-  programHeaderType_m.try_emplace(0x6fffffff, "PT_HIOS");
-  programHeaderType_m.try_emplace(0x70000000, "PT_LOPROC");
-  programHeaderType_m.try_emplace(0x7fffffff, "PT_HIPROC");
-  
-  programHeaderFlag_m.try_emplace(0, "None");
-  programHeaderFlag_m.try_emplace(1, "Execute (PF_X)");
-  programHeaderFlag_m.try_emplace(2, "Write (PF_W)");
-  programHeaderFlag_m.try_emplace(3, "Write/Execute (PF_WX)");
-  programHeaderFlag_m.try_emplace(4, "Read (PF_R)");
-  programHeaderFlag_m.try_emplace(5, "Read/Execute (PF_RX)");
-  programHeaderFlag_m.try_emplace(6, "Read/Write (PF_RW)");
-  programHeaderFlag_m.try_emplace(7, "Read/Write/Execute (PF_RWX)");
-  programHeaderFlag_m.try_emplace(0x0ff00000, "PF_MASKOS");
-  programHeaderFlag_m.try_emplace(0xf0000000, "PF_MASKPROC");
-
-  sectionHeaderType_m.try_emplace(0, "SHT_NULL");
-  sectionHeaderType_m.try_emplace(1, "SHT_PROGBITS");
-  sectionHeaderType_m.try_emplace(2, "SHT_SYMTAB");
-  sectionHeaderType_m.try_emplace(3, "SHT_STRTAB");
-  sectionHeaderType_m.try_emplace(4, "SHT_RELA");
-  sectionHeaderType_m.try_emplace(5, "SHT_HASH");
-  sectionHeaderType_m.try_emplace(6, "SHT_DYNAMIC");
-  sectionHeaderType_m.try_emplace(7, "SHT_NOTE");
-  sectionHeaderType_m.try_emplace(8, "SHT_NOBITS");
-  sectionHeaderType_m.try_emplace(9, "SHT_REL");
-  sectionHeaderType_m.try_emplace(10, "SHT_SHLIB");
-  sectionHeaderType_m.try_emplace(11, "SHT_DYNSYM");
-  sectionHeaderType_m.try_emplace(14, "SHT_INIT_ARRAY");
-  sectionHeaderType_m.try_emplace(15, "SHT_FINI_ARRAY");
-  sectionHeaderType_m.try_emplace(16, "SHT_PREINIT_ARRAY");
-  sectionHeaderType_m.try_emplace(17, "SHT_GROUP");
-  sectionHeaderType_m.try_emplace(18, "SHT_SYMTAB_SHNDX");
-  sectionHeaderType_m.try_emplace(19, "SHT_NUM");
-  sectionHeaderType_m.try_emplace(0x60000000, "SHT_LOOS");
-  sectionHeaderType_m.try_emplace(0x6ffffff5, "SHT_GNU_ATTRIBUTES");
-  sectionHeaderType_m.try_emplace(0x6ffffff6, "SHT_GNU_HASH");
-  sectionHeaderType_m.try_emplace(0x6ffffff7, "SHT_GNU_LIBLIST");
-  sectionHeaderType_m.try_emplace(0x6ffffff8, "SHT_CHECKSUM");
-  sectionHeaderType_m.try_emplace(0x6ffffffa, "SHT_LOSUNW");
-  sectionHeaderType_m.try_emplace(0x6ffffffa, "SHT_SUNW_move");
-  sectionHeaderType_m.try_emplace(0x6ffffffb, "SHT_SUNW_COMDAT");
-  sectionHeaderType_m.try_emplace(0x6ffffffc, "SHT_SUNW_syminfo");
-  sectionHeaderType_m.try_emplace(0x6ffffffd, "SHT_GNU_verdef");
-  sectionHeaderType_m.try_emplace(0x6ffffffe, "SHT_GNU_verneed");
-  sectionHeaderType_m.try_emplace(0x6fffffff, "SHT_GNU_versym");
-  sectionHeaderType_m.try_emplace(0x6fffffff, "SHT_HISUNW");
-  sectionHeaderType_m.try_emplace(0x6fffffff, "SHT_HIOS");
-  sectionHeaderType_m.try_emplace(0x70000000, "SHT_LOPROC");
-  sectionHeaderType_m.try_emplace(0x7fffffff, "SHT_HIPROC");
-  sectionHeaderType_m.try_emplace(0x80000000, "SHT_LOUSER");
-  sectionHeaderType_m.try_emplace(0x8fffffff, "SHT_HIUSER");
-
-  sectionHeaderFlag_m.try_emplace(0, "UNDEF");
-  sectionHeaderFlag_m.try_emplace(0xff00, "LORESERVE");
-  sectionHeaderFlag_m.try_emplace(0xff00, "LOPROC");
-  sectionHeaderFlag_m.try_emplace(0xff00, "BEFORE");
-  sectionHeaderFlag_m.try_emplace(0xff01, "AFTER");
-  sectionHeaderFlag_m.try_emplace(0xff1f, "HIPROC");
-  sectionHeaderFlag_m.try_emplace(0xff20, "LOOS");
-  sectionHeaderFlag_m.try_emplace(0xff3f, "HIOS");
-  sectionHeaderFlag_m.try_emplace(0xfff1, "ABS");
-  sectionHeaderFlag_m.try_emplace(0xfff2, "COMMON");
-  sectionHeaderFlag_m.try_emplace(0xffff, "XINDEX");
-  sectionHeaderFlag_m.try_emplace(0xffff, "HIRESERVE");
-  
+void ELF::init(std::span<const std::byte> image, uint64_t base) {
+  ByteReader file(image, base);
+  parse(file);
 }
 
 /**
- * @brief Given an ifstream file object, it parses ELF header, segments, and
- * sections. then prints out basic info parsed.
+ * @brief Reads e_ident fields and parses the rest of the file based on
+ * the ELF class found.
  *
- * @param file An std::ifstream object with ELF file already opened,
- * assumption here is that the stream object is at offset after e_ident.
- * @param littleEndian Indicates True little end byte order.
+ * @param file A ByteReader over the ELF file content,
+ * assumption here is that the reader is at offset 0.
  *
  * @return none.
  */
-void ELF::parse32(std::ifstream& file, bool littleEndian) {
-  file.seekg(0x10);
-  // Elf header
-  e_type_u16 = FileIO::read_u16(file, littleEndian);
-  e_machine_u16 = FileIO::read_u16(file, littleEndian);
-  e_version_u32 = FileIO::read_u32(file, littleEndian);
-  e_entry_u64 = FileIO::read_u32(file, littleEndian);
-  e_phoff_u64 = FileIO::read_u32(file, littleEndian);
-  e_shoff_u64 = FileIO::read_u32(file, littleEndian);
-  e_flags_u32 = FileIO::read_u32(file, littleEndian);
-  e_ehsize_u16 = FileIO::read_u16(file, littleEndian);
-
-  // reading size of entries in program header and their numbers
-  e_phentsize_u16 = FileIO::read_u16(file, littleEndian);
-  e_phnum_u16 = FileIO::read_u16(file, littleEndian);
-
-  // reading size of entries in section header and their numbers
-  e_shentsize_u16 = FileIO::read_u16(file, littleEndian);
-  e_shnum_u16 = FileIO::read_u16(file, littleEndian);
-
-  e_shstrndx_u16 = FileIO::read_u16(file, littleEndian);
-
-  // file seek to program header
-  file.seekg(e_phoff_u64);
-  /* read 'e_phnum_u16' of entries sized 'e_phentsize_u16'
-  * program headers size:
-  *            in 32bit: 32 byte long (n) arrays
-  *            in 64bit: 56 byte long (n) arrays
-  * ref https://wiki.osdev.org/ELF#Header
-  */
+void ELF::parse(ByteReader& file) {
+  magicBytes_u32 = file.read<uint32_t, std::endian::big>();
+  ei_class_u8 =  file.read_u8();
+  ei_data_u8  = file.read_u8();
+  ei_version_u8 = file.read_u8();
+  ei_osabi_u8 = file.read_u8();
 
-  for(uint32_t idx = 0; idx < e_phnum_u16; idx++) {
-    u_int64_t cur_offset = file.tellg();
-    ProgramHeader pHeader;
-    pHeader.setP_type(FileIO::read_u32(file, littleEndian));
-    pHeader.setP_offset(FileIO::read_u32(file, littleEndian));
-    pHeader.setP_vaddr(FileIO::read_u32(file, littleEndian));
-    pHeader.setP_paddr(FileIO::read_u32(file, littleEndian));
-    pHeader.setP_filesz(FileIO::read_u32(file, littleEndian));
-    pHeader.setP_memsz(FileIO::read_u32(file, littleEndian));
-    pHeader.setP_flags(FileIO::read_u32(file, littleEndian));
-    pHeader.setP_align(FileIO::read_u32(file, littleEndian));
-
-    programHeader.push_back(pHeader);
-    // skip from where we started reading plus size of entry, to avoid wrong offsets
-    file.seekg(cur_offset + e_phentsize_u16);
-  }
+  // skipping e_ident field.
+  file.seek(0x10);
   
-  // file seek to section header
-  file.seekg(e_shoff_u64);
-  // read 'e_shentsize_u16' of entries sized 'e_shnum_u16'
-  for(uint32_t idx = 0; idx < e_shentsize_u16; idx++) {
-    u_int64_t cur_offset = file.tellg();
-    SectionHeader sHeader;
-
-    sHeader.setSh_name(FileIO::read_u32(file, littleEndian));
-    sHeader.setSh_type(FileIO::read_u32(file, littleEndian));
-    sHeader.setSh_flags(FileIO::read_u32(file, littleEndian));
-    sHeader.setSh_addr(FileIO::read_u32(file, littleEndian));
-    sHeader.setSh_offset(FileIO::read_u32(file, littleEndian));
-    sHeader.setSh_size(FileIO::read_u32(file, littleEndian));
-    sHeader.setSh_link(FileIO::read_u32(file, littleEndian));
-    sHeader.setSh_info(FileIO::read_u32(file, littleEndian));
-    sHeader.setSh_addralign(FileIO::read_u32(file, littleEndian));
-    sHeader.setSh_entsize(FileIO::read_u32(file, littleEndian));
-    sectionHeader.push_back(sHeader);
-    // skip from where we started reading plus size of entry, to avoid wrong offsets
-    file.seekg(cur_offset + e_shentsize_u16);
+  // EI_DATA: 1 little endian, 2 big endian.
+  bool bigEndian = ei_data_u8 == 2;
+  if (ei_class_u8 & 1) {
+    if (bigEndian) parseImage<std::endian::big, uint32_t>(file);
+    else parseImage<std::endian::little, uint32_t>(file);
+  } else if (ei_class_u8 & 2) {
+    if (bigEndian) parseImage<std::endian::big, uint64_t>(file);
+    else parseImage<std::endian::little, uint64_t>(file);
   }
 
-  // fill sections names
-  file.clear();
-  for(uint32_t idx = 0; idx < e_shnum_u16; idx++) {   
-    uint32_t name_index = sectionHeader[idx].getSh_name();
-    uint32_t table_offset = sectionHeader[e_shstrndx_u16].getSh_offset();
-    std::string name = getSectionHeaderName(name_index, table_offset, file);
-    sectionHeader[idx].setSh_name(name);
-  }
 }
 
-/**
- * @brief Given an ifstream file object, it parses ELF header, segments, and
- * sections. then prints out basic info parsed.
+namespace {
+
+// names of ELF header values, shared by every ELF object. When a value is
+// listed twice the first name is used.
+
+// e_type
+constexpr FlagTable etypeFlags({
+    {0, "NONE"},
+    {1, "ET_REL"},
+    {2, "ET_EXEC"},
+    {3, "Dynamic / Position Independant ET_DYN"},
+    {4, "ET_CORE"},
+    {5, "ET_LOOS"},
+});
+
+// e_machine
+constexpr FlagTable emachineFlags({
+    {40, "ARM (EM_ARM)"},
+    {41, "EM_ALPHA"},
+    {50, "EM_IA_64"},
+    {51, "EM_MIPS_X"},
+    {62, "64bit (EM_X86_64)"},
+    {3, "Intel 386 (EM_386)"},
+    {8, "MIPS (EM_MIPS)"},
+    {10, "EM_MIPS_RS3_LE"},
+});
+
+// e_ident[EI_CLASS]
+constexpr FlagTable eclassFlags({
+    {1, "32bit (ELFCLASS32)"},
+    {2, "64bit (ELFCLASS64)"},
+});
+
+// e_ident[EI_DATA]
+constexpr FlagTable edataFlags({
+    {1, "Least Significant Byte (LSB)"},
+    {2, "Most Significant Byte (MSB)"},
+});
+
+// e_ident[EI_OSABI]
+constexpr FlagTable eiosabiFlags({
+    {0, "NONE"},
+    {1, "HPUX"},
+    {2, "NETBSD"},
+    {3, "Linux"},
+    {6, "SOLARIS"},
+    {7, "AIX"},
+    {8, "IRIX"},
+    {9, "FREEBSD"},
+    {10, "TRU64"},
+    {12, "OPENBSD"},
+    {64, "ARM_AEABI"},
+    {97, "ARM"},
+});
+
+// p_type
+constexpr FlagTable programHeaderTypes({
+    {0, "PT_NULL"},
+    {1, "PT_LOAD"},
+    {2, "PT_DYNAMIC"},
+    {3, "PT_INTERP"},
+    {4, "PT_NOTE"},
+    {5, "PT_SHLIB"},
+    {6, "PT_PHDR"},
+    {7, "PT_TLS"},
+    {8, "PT_NUM"},
+    {0x60000000, "PT_LOOS"},
+    {0x6474e550, "PT_GNU_EH_FRAME"},
+    {0x6474e551, "PT_GNU_STACK"},
+    {0x6474e552, "PT_GNU_RELRO"},
+    {0x6474e553, "PT_GNU_PROPERTY"},
+    {0x6ffffffa, "PT_LOSUNW"},
+    {0x6ffffffa, "PT_SUNWBSS"},
+    {0x6ffffffb, "PT_SUNWSTACK"},
+    {0x6fffffff, "PT_HISUNW"},
+    {0x6fffffff, "PT_HIOS"},
+    {0x70000000, "PT_LOPROC"},
+    {0x7fffffff, "PT_HIPROC"},
+});
+
+// p_flags
+constexpr FlagTable programHeaderFlags({
+    {0, "None"},
+    {1, "Execute (PF_X)"},
+    {2, "Write (PF_W)"},
+    {3, "Write/Execute (PF_WX)"},
+    {4, "Read (PF_R)"},
+    {5, "Read/Execute (PF_RX)"},
+    {6, "Read/Write (PF_RW)"},
+    {7, "Read/Write/Execute (PF_RWX)"},
+    {0x0ff00000, "PF_MASKOS"},
+    {0xf0000000, "PF_MASKPROC"},
+});
+
+// sh_type
+constexpr FlagTable sectionHeaderTypes({
+    {0, "SHT_NULL"},
+    {1, "SHT_PROGBITS"},
+    {2, "SHT_SYMTAB"},
+    {3, "SHT_STRTAB"},
+    {4, "SHT_RELA"},
+    {5, "SHT_HASH"},
+    {6, "SHT_DYNAMIC"},
+    {7, "SHT_NOTE"},
+    {8, "SHT_NOBITS"},
+    {9, "SHT_REL"},
+    {10, "SHT_SHLIB"},
+    {11, "SHT_DYNSYM"},
+    {14, "SHT_INIT_ARRAY"},
+    {15, "SHT_FINI_ARRAY"},
+    {16, "SHT_PREINIT_ARRAY"},
+    {17, "SHT_GROUP"},
+    {18, "SHT_SYMTAB_SHNDX"},
+    {19, "SHT_NUM"},
+    {0x60000000, "SHT_LOOS"},
+    {0x6ffffff5, "SHT_GNU_ATTRIBUTES"},
+    {0x6ffffff6, "SHT_GNU_HASH"},
+    {0x6ffffff7, "SHT_GNU_LIBLIST"},
+    {0x6ffffff8, "SHT_CHECKSUM"},
+    {0x6ffffffa, "SHT_LOSUNW"},
+    {0x6ffffffa, "SHT_SUNW_move"},
+    {0x6ffffffb, "SHT_SUNW_COMDAT"},
+    {0x6ffffffc, "SHT_SUNW_syminfo"},
+    {0x6ffffffd, "SHT_GNU_verdef"},
+    {0x6ffffffe, "SHT_GNU_verneed"},
+    {0x6fffffff, "SHT_GNU_versym"},
+    {0x6fffffff, "SHT_HISUNW"},
+    {0x6fffffff, "SHT_HIOS"},
+    {0x70000000, "SHT_LOPROC"},
+    {0x7fffffff, "SHT_HIPROC"},
+    {0x80000000, "SHT_LOUSER"},
+    {0x8fffffff, "SHT_HIUSER"},
+});
+
+// special section indexes
+constexpr FlagTable sectionHeaderFlags({
+    {0, "UNDEF"},
+    {0xff00, "LORESERVE"},
+    {0xff00, "LOPROC"},
+    {0xff00, "BEFORE"},
+    {0xff01, "AFTER"},
+    {0xff1f, "HIPROC"},
+    {0xff20, "LOOS"},
+    {0xff3f, "HIOS"},
+    {0xfff1, "ABS"},
+    {0xfff2, "COMMON"},
+    {0xffff, "XINDEX"},
+    {0xffff, "HIRESERVE"},
+});
+
+}  // namespace
+
+
+/**
+ * @brief Given a ByteReader over the file, it parses ELF header, segments, and
+ * sections. Instantiated once per byte order and ELF class, so fields are
+ * decoded without checking either at runtime.
  *
- * @param file An std::ifstream object with ELF file already opened,
- * assumption here is that the stream object is at offset after e_ident.
- * @param littleEndian Indicate byte order. True: little end, False: Big end.
+ * @tparam Order byte order given by e_ident[EI_DATA].
+ * @tparam Word uint32_t for ELFCLASS32, uint64_t for ELFCLASS64 files.
+ * @param file A ByteReader over the ELF file content.
  *
  * @return none.
  */
-void ELF::parse64(std::ifstream& file, bool littleEndian) {
-  file.seekg(0x10);
+template <std::endian Order, typename Word>
+void ELF::parseImage(ByteReader& file) {
+  constexpr bool is64 = sizeof(Word) == 8;
+
+  file.seek(0x10);
   // Elf header
-  e_type_u16 = FileIO::read_u16(file, littleEndian);
-  e_machine_u16 = FileIO::read_u16(file, littleEndian);
-  e_version_u32 = FileIO::read_u32(file, littleEndian);
-  e_entry_u64 = FileIO::read_u64(file, littleEndian);
-  e_phoff_u64 = FileIO::read_u64(file, littleEndian);
-  e_shoff_u64 = FileIO::read_u64(file, littleEndian);
-  e_flags_u32 = FileIO::read_u32(file, littleEndian);
-  e_ehsize_u16 = FileIO::read_u16(file, littleEndian);
+  e_type_u16 = file.read<uint16_t, Order>();
+  e_machine_u16 = file.read<uint16_t, Order>();
+  e_version_u32 = file.read<uint32_t, Order>();
+  e_entry_u64 = file.read<Word, Order>();
+  e_phoff_u64 = file.read<Word, Order>();
+  e_shoff_u64 = file.read<Word, Order>();
+  e_flags_u32 = file.read<uint32_t, Order>();
+  e_ehsize_u16 = file.read<uint16_t, Order>();
 
   // reading size of entries in program header and their numbers
-  e_phentsize_u16 = FileIO::read_u16(file, littleEndian);
-  e_phnum_u16 = FileIO::read_u16(file, littleEndian);
+  e_phentsize_u16 = file.read<uint16_t, Order>();
+  e_phnum_u16 = file.read<uint16_t, Order>();
 
   // reading size of entries in section header and their numbers
-  e_shentsize_u16 = FileIO::read_u16(file, littleEndian);
-  e_shnum_u16 = FileIO::read_u16(file, littleEndian);
+  e_shentsize_u16 = file.read<uint16_t, Order>();
+  e_shnum_u32 = file.read<uint16_t, Order>();
 
-  e_shstrndx_u16 = FileIO::read_u16(file, littleEndian);
+  e_shstrndx_u32 = file.read<uint16_t, Order>();
+
+  // both tables are bounds checked once and decoded record by record,
+  // entries may be padded beyond the standard sizes given below.
+  constexpr uint64_t W = sizeof(Word);
+  constexpr uint64_t programEntrySize = is64 ? 56 : 32;
+  constexpr uint64_t sectionEntrySize = 16 + 6 * W;
 
-  // file seek to program header
-  file.seekg(e_phoff_u64);
   /* read 'e_phnum_u16' of entries sized 'e_phentsize_u16'
   * program headers size:
   *            in 32bit: 32 byte long (n) arrays
   *            in 64bit: 56 byte long (n) arrays
+  *  p_flags follows p_type in 64bit entries, and p_memsz in 32bit ones.
   * ref https://wiki.osdev.org/ELF#Header
   */
+  if (e_phnum_u16 > 0) {
+    if (e_phentsize_u16 < programEntrySize) {
+      throw std::runtime_error("Malformed ELF program header table");
+    }
+    file.seek(e_phoff_u64);
+    const uint8_t* table = file.read_table(e_phnum_u16, e_phentsize_u16);
+    constexpr uint64_t at = is64 ? 8 : 4;  // p_offset
+
+    programHeader.reserve(e_phnum_u16);
+    for (uint32_t idx = 0; idx < e_phnum_u16; idx++) {
+      const uint8_t* entry = table + idx * uint64_t(e_phentsize_u16);
+      ProgramHeader pHeader;
+      pHeader.setP_type(ByteReader::decode<uint32_t, Order>(entry));
+      pHeader.setP_offset(ByteReader::decode<Word, Order>(entry + at));
+      pHeader.setP_vaddr(ByteReader::decode<Word, Order>(entry + at + W));
+      pHeader.setP_paddr(ByteReader::decode<Word, Order>(entry + at + 2 * W));
+      pHeader.setP_filesz(ByteReader::decode<Word, Order>(entry + at + 3 * W));
+      pHeader.setP_memsz(ByteReader::decode<Word, Order>(entry + at + 4 * W));
+      if constexpr (is64) {
+        pHeader.setP_flags(ByteReader::decode<uint32_t, Order>(entry + 4));
+        pHeader.setP_align(ByteReader::decode<Word, Order>(entry + 48));
+      } else {
+        pHeader.setP_flags(ByteReader::decode<uint32_t, Order>(entry + 24));
+        pHeader.setP_align(ByteReader::decode<Word, Order>(entry + 28));
+      }
+      programHeader.push_back(pHeader);
+    }
+  }
 
-  for(uint32_t idx = 0; idx < e_phnum_u16; idx++) {
-    u_int64_t cur_offset = file.tellg();
-    ProgramHeader pHeader;
-    pHeader.setP_type(FileIO::read_u32(file, littleEndian));
-    pHeader.setP_flags(FileIO::read_u32(file, littleEndian));
-    pHeader.setP_offset(FileIO::read_u64(file, littleEndian));
-    pHeader.setP_vaddr(FileIO::read_u64(file, littleEndian));
-    pHeader.setP_paddr(FileIO::read_u64(file, littleEndian));
-    pHeader.setP_filesz(FileIO::read_u64(file, littleEndian));
-    pHeader.setP_memsz(FileIO::read_u64(file, littleEndian));
-    pHeader.setP_align(FileIO::read_u64(file, littleEndian));
-
-    programHeader.push_back(pHeader);
-    // skip from where we started reading plus size of entry, to avoid wrong offsets
-    file.seekg(cur_offset + e_phentsize_u16);
+  /* 0xff00 sections or more don't fit e_shnum, it is 0 then and the
+  * first section header holds the count in sh_size. e_shstrndx is
+  * SHN_XINDEX (0xffff) when the index doesn't fit, the first section
+  * header holds it in sh_link.
+  * ref https://refspecs.linuxfoundation.org/elf/gabi4+/ch4.sheader.html
+  */
+  if (e_shnum_u32 == 0 && e_shoff_u64 != 0) {
+    if (e_shentsize_u16 < sectionEntrySize) {
+      throw std::runtime_error("Malformed ELF section header table");
+    }
+    file.seek(e_shoff_u64);
+    const uint8_t* first = file.read_table(1, e_shentsize_u16);
+    uint64_t count = ByteReader::decode<Word, Order>(first + 8 + 3 * W);
+    if (count > UINT32_MAX) {
+      throw std::runtime_error("Malformed ELF section header table");
+    }
+    e_shnum_u32 = uint32_t(count);
   }
-  
-  // file seek to section header
-  file.seekg(e_shoff_u64);
-  // read 'e_shentsize_u16' of entries sized 'e_shnum_u16'
-  for(uint32_t idx = 0; idx < e_shentsize_u16; idx++) {
-    u_int64_t cur_offset = file.tellg();
-    SectionHeader sHeader;
-
-    sHeader.setSh_name(FileIO::read_u32(file, littleEndian));
-    sHeader.setSh_type(FileIO::read_u32(file, littleEndian));
-    sHeader.setSh_flags(FileIO::read_u64(file, littleEndian));
-    sHeader.setSh_addr(FileIO::read_u64(file, littleEndian));
-    sHeader.setSh_offset(FileIO::read_u64(file, littleEndian));
-    sHeader.setSh_size(FileIO::read_u64(file, littleEndian));
-    sHeader.setSh_link(FileIO::read_u32(file, littleEndian));
-    sHeader.setSh_info(FileIO::read_u32(file, littleEndian));
-    sHeader.setSh_addralign(FileIO::read_u64(file, littleEndian));
-    sHeader.setSh_entsize(FileIO::read_u64(file, littleEndian));
-    
-    sectionHeader.push_back(sHeader);
-    // skip from where we started reading plus size of entry, to avoid wrong offsets
-    file.seekg(cur_offset + e_shentsize_u16);
+
+  // read 'e_shnum_u32' of entries sized 'e_shentsize_u16'
+  if (e_shnum_u32 > 0) {
+    if (e_shentsize_u16 < sectionEntrySize) {
+      throw std::runtime_error("Malformed ELF section header table");
+    }
+    file.seek(e_shoff_u64);
+    const uint8_t* table = file.read_table(e_shnum_u32, e_shentsize_u16);
+
+    sectionHeader.reserve(e_shnum_u32);
+    for (uint32_t idx = 0; idx < e_shnum_u32; idx++) {
+      const uint8_t* entry = table + idx * uint64_t(e_shentsize_u16);
+      SectionHeader sHeader;
+      sHeader.setSh_name(ByteReader::decode<uint32_t, Order>(entry));
+      sHeader.setSh_type(ByteReader::decode<uint32_t, Order>(entry + 4));
+      sHeader.setSh_flags(ByteReader::decode<Word, Order>(entry + 8));
+      sHeader.setSh_addr(ByteReader::decode<Word, Order>(entry + 8 + W));
+      sHeader.setSh_offset(ByteReader::decode<Word, Order>(entry + 8 + 2 * W));
+      sHeader.setSh_size(ByteReader::decode<Word, Order>(entry + 8 + 3 * W));
+      sHeader.setSh_link(ByteReader::decode<uint32_t, Order>(entry + 8 + 4 * W));
+      sHeader.setSh_info(ByteReader::decode<uint32_t, Order>(entry + 12 + 4 * W));
+      sHeader.setSh_addralign(ByteReader::decode<Word, Order>(entry + 16 + 4 * W));
+      sHeader.setSh_entsize(ByteReader::decode<Word, Order>(entry + 16 + 5 * W));
+      sectionHeader.push_back(sHeader);
+    }
   }
 
-  // fill sections names
-  file.clear();
-  for(uint32_t idx = 0; idx < e_shnum_u16; idx++) {   
-    uint32_t name_index = sectionHeader[idx].getSh_name();
-    uint32_t table_offset = sectionHeader[e_shstrndx_u16].getSh_offset();
-    std::string name = getSectionHeaderName(name_index, table_offset, file);
-    sectionHeader[idx].setSh_name(name);
+  if (e_shstrndx_u32 == 0xffff && !sectionHeader.empty()) {
+    e_shstrndx_u32 = sectionHeader[0].getSh_link();
+  }
+
+  // load the section name table once, names are views into it.
+  uint32_t nameIndex = e_shstrndx_u32;
+  if (nameIndex != 0 && nameIndex < sectionHeader.size()) {
+    const SectionHeader& names = sectionHeader[nameIndex];
+    uint64_t offset = names.getSh_offset();
+    if (offset <= file.size() && names.getSh_size() <= file.size() - offset) {
+      sectionNames.assign(file.data() + offset, names.getSh_size());
+    }
+  }
+
+  for (SectionHeader& header : sectionHeader) {
+    header.setSh_name(getSectionHeaderName(header.getSh_name()));
   }
-  
 }
 
 /**
- * @brief Given an ifstream file object, read the first 16 bytes.
+ * @brief Given a ByteReader over the file, read the first 16 bytes.
  *
- * @param file An std::ifstream object with ELF file already opened,
- * assumption here is that the stream object is at offset 0.
+ * @param file A ByteReader over the ELF file content,
+ * assumption here is that the reader is at offset 0.
  *
  * @return none.
  */
-void ELF::readE_ident(std::ifstream& file) {
-  unsigned char bytes[2];
-
-  for (int idx = 0; idx < 16; idx++) {
-    file.get(reinterpret_cast<char*>(bytes), 1);
-    e_ident[idx] = bytes[0];
-  }
+void ELF::readE_ident(ByteReader& file) {
+  std::memcpy(e_ident, file.read_bytes(16), 16);
 }
 
 /**
@@ -451,132 +461,112 @@ uint16_t ELF::getEi_osabi() const {
 }
 
 /**
- * @brief Returns ELF's e_class flag bytes.
- * @param none
- */
-std::map<uint16_t, std::string> ELF::getEclassFlags() const {
-  return this->eclassFlags; 
-}
-
-/**
- * @brief Returns ELF's e_data flag bytes.
- * @param none
- */
-std::map<uint16_t, std::string> ELF::getEdataFlags() const {
-  return this->edataFlags;
-}
-
-/**
- * @brief Returns ELF's magic bytes.
- * @param none
- */
-std::map<uint16_t, std::string> ELF::getEiosabiFlags() const {
-  return this->eiosabiFlags; 
-}
-
-/**
- * @brief Returns ELF's e_type flag bytes.
- * @param none
- */
-std::map<uint16_t, std::string> ELF::getEtypeFlags() const {
-  return this->etypeFlags;
-}
-
-/**
- * @brief Returns ELF's e_machine flag bytes.
- * @param none
- */
-std::map<uint16_t, std::string> ELF::getEmachineFlags() const {
-  return this->emachineFlags;
+ * @brief Returns the name of an ELF header value.
+ *
+ * @param flag which kind of value it is, one of flags.
+ * @param value the value.
+ *
+ * @return the name, or an empty view for unknown values.
+ */
+std::string_view ELF::getFlagName(uint32_t flag, uint64_t value) {
+  switch (flag) {
+    case ETYPE: return etypeFlags.find(value);
+    case EMACHINE: return emachineFlags.find(value);
+    case ECLASS: return eclassFlags.find(value);
+    case EDATA: return edataFlags.find(value);
+    case EIOSABI: return eiosabiFlags.find(value);
+    case SECTIONTYPE: return sectionHeaderTypes.find(value);
+    case SECTIONFLAG: return sectionHeaderFlags.find(value);
+    case PROGRAMTYPE: return programHeaderTypes.find(value);
+    case PROGRAMFLAG: return programHeaderFlags.find(value);
+  }
+  return {};
 }
 
 /**
  * @brief Prints ELF's flag representation as a string to output.
  *
+ * @param out The buffer to print to.
  * @param flag The ELF flag type to resolve (e.i. E_class, e_data...etc).
  * @param type The flag value, can be zero sometimes, or the value to be retrived
- * from the mapped strings in function mapFlags().
+ * from the ELF flag tables.
  * 
  * @return none.
  */
-void ELF::printFlag(uint32_t flag, uint32_t type) {
-  if (flag == ECLASS)
-      std::cout << this->eclassFlags[ei_class_u8] << std::endl;
-  else if (flag == EDATA)
-      std::cout << this->edataFlags[ei_data_u8] << std::endl;
-  else if (flag == EMACHINE)
-      std::cout << this->emachineFlags[e_machine_u16] << std::endl;
-  else if (flag == EIOSABI)
-      std::cout << this->eiosabiFlags[ei_osabi_u8] << std::endl;
-  else if (flag == ETYPE)
-      std::cout << this->etypeFlags[e_type_u16] << std::endl;
-  else if (flag == SECTIONTYPE)
-      std::cout << this->sectionHeaderType_m[type] << std::endl;
-  else if (flag == SECTIONFLAG)
-      std::cout << this->sectionHeaderFlag_m[type] << std::endl;
-  else if (flag == PROGRAMFLAG)
-      std::cout << this->programHeaderFlag_m[type] << std::endl;
-  else if (flag == PROGRAMTYPE)
-      std::cout << this->programHeaderType_m[type] << std::endl;
+void ELF::printFlag(OutputBuffer& out, uint32_t flag, uint32_t type) const {
+  uint64_t value = type;
+  switch (flag) {
+    case ECLASS: value = ei_class_u8; break;
+    case EDATA: value = ei_data_u8; break;
+    case EMACHINE: value = e_machine_u16; break;
+    case EIOSABI: value = ei_osabi_u8; break;
+    case ETYPE: value = e_type_u16; break;
+    case SECTIONTYPE:
+    case SECTIONFLAG:
+    case PROGRAMFLAG:
+    case PROGRAMTYPE: break;
+    default: return;
+  }
+  out << getFlagName(flag, value) << std::endl;
 }
 
 /**
  * @brief Prints an ELF file's parsed information.
- * @param none
+ * @param out The buffer to print to.
  * @return none
  */
-void ELF::printElf() {
+void ELF::printElf(OutputBuffer& out) const {
   using namespace std;
-  cout << "Magic bytes: \t0x" << uppercase << hex << this->getMagicBytes() << " | ";
-  this->printFlag(ECLASS, 0); 
-  cout << "byte order: \t";
-  this->printFlag(EDATA, 0);
-  cout << "OS ABI: \t"; 
-  this->printFlag(EIOSABI, 0);
-  cout << "Type: \t";
-  this->printFlag(ETYPE, 0);
-  cout << "Machine: \t";
-  this->printFlag(EMACHINE, 0);
-  cout << "Entry Point: \t0x" << hex << this->getE_entry() << endl;
-  cout << "Program headers offset : \t0x" << hex << this->getE_phoff() << endl;
-  cout << "Program header entry size: \t0x" << this->getE_phentsize() << endl;
-  cout << "total entries: \t0x" << this->getE_phnum() <<  endl;
-  cout << "Section header offset: \t0x" << hex << this->getE_shoff() << endl;
-  cout << "Section header entry size: \t0x" << this->getE_shentsize() << endl;
-  cout << "total entries: \t0x" << this->getE_shnum() << endl << endl;
-
-  cout << "---------------------------------\n";
-  cout << "Program section entries\n";
+  out << "Magic bytes: \t0x" << uppercase << hex << this->getMagicBytes() << " | ";
+  this->printFlag(out, ECLASS, 0); 
+  out << "byte order: \t";
+  this->printFlag(out, EDATA, 0);
+  out << "OS ABI: \t"; 
+  this->printFlag(out, EIOSABI, 0);
+  out << "Type: \t";
+  this->printFlag(out, ETYPE, 0);
+  out << "Machine: \t";
+  this->printFlag(out, EMACHINE, 0);
+  out << "Entry Point: \t0x" << hex << this->getE_entry() << endl;
+  out << "Program headers offset : \t0x" << hex << this->getE_phoff() << endl;
+  out << "Program header entry size: \t0x" << this->getE_phentsize() << endl;
+  out << "total entries: \t0x" << this->getE_phnum() <<  endl;
+  out << "Section header offset: \t0x" << hex << this->getE_shoff() << endl;
+  out << "Section header entry size: \t0x" << this->getE_shentsize() << endl;
+  out << "total entries: \t0x" << this->getE_shnum() << endl << endl;
+
+  out << "---------------------------------\n";
+  out << "Program section entries\n";
   for (int idx = 0; idx < e_phnum_u16; idx++) {
-    cout << "programHeader[" << dec << idx << "]\n";
-    cout << "  Type: \t";
-    this->printFlag(PROGRAMTYPE, programHeader[idx].getP_type());
-    cout << "  Flags: \t";
-    this->printFlag(PROGRAMFLAG, programHeader[idx].getP_flags()) ;
-    cout << "  Offset: \t0x" << programHeader[idx].getP_offset() << endl;
-    cout << "  Virtual Address: \t0x" << programHeader[idx].getP_vaddr() << endl;
-    cout << "  Physical Address: \t0x" << programHeader[idx].getP_paddr() << endl;
-    cout << "  Segment file length: \t0x" <<  programHeader[idx].getP_filesz() << endl;
-    cout << "  Segment memory length: \t0x" <<  programHeader[idx].getP_memsz() << endl;
-    cout << "  Alignment: \t0x" <<  programHeader[idx].getP_align() << endl << endl;
+    out << "programHeader[" << dec << idx << "]\n";
+    out << "  Type: \t";
+    this->printFlag(out, PROGRAMTYPE, programHeader[idx].getP_type());
+    out << "  Flags: \t";
+    this->printFlag(out, PROGRAMFLAG, programHeader[idx].getP_flags()) ;
+    out << "  Offset: \t0x" << programHeader[idx].getP_offset() << endl;
+    out << "  Virtual Address: \t0x" << programHeader[idx].getP_vaddr() << endl;
+    out << "  Physical Address: \t0x" << programHeader[idx].getP_paddr() << endl;
+    out << "  Segment file length: \t0x" <<  programHeader[idx].getP_filesz() << endl;
+    out << "  Segment memory length: \t0x" <<  programHeader[idx].getP_memsz() << endl;
+    out << "  Alignment: \t0x" <<  programHeader[idx].getP_align() << endl << endl;
   }
 
-  cout << "\n---------------------------------\n";
-  cout << "Section section entries\n";
-  for (int idx = 0; idx < e_shnum_u16; idx++) {
-    cout << "sectionHeader[" << dec << idx << "]\n";
-    cout << "  Name: \t" << sectionHeader[idx].getS_name() << endl;
-    cout << "  Type: \t";
-    this->printFlag(SECTIONTYPE, sectionHeader[idx].getSh_type());
-    cout << "  flags: \t";
-    this->printFlag(SECTIONTYPE, sectionHeader[idx].getSh_flags());
-    cout << "  Address: \t0x" << sectionHeader[idx].getSh_addr() << endl;
-    cout << "  Offset: \t0x" << sectionHeader[idx].getSh_offset() << endl;
-    cout << "  size: \t0x" << sectionHeader[idx].getSh_size() << endl;
-    cout << "  link: \t0x" << sectionHeader[idx].getSh_link() << endl;
-    cout << "  info: \t0x" << sectionHeader[idx].getSh_info() << endl;
-    cout << "  Address alignment: \t0x" << sectionHeader[idx].getSh_addralign() << endl;
-    cout << "  Section size: \t0x" << sectionHeader[idx].getSh_entsize() << endl << endl;
+  out << "\n---------------------------------\n";
+  out << "Section section entries\n";
+  for (uint32_t idx = 0; idx < e_shnum_u32; idx++) {
+    out << "sectionHeader[" << dec << idx << "]\n";
+    out << "  Name: \t" << sectionHeader[idx].getS_name() << endl;
+    out << "  Type: \t";
+    this->printFlag(out, SECTIONTYPE, sectionHeader[idx].getSh_type());
+    out << "  flags: \t";
+    this->printFlag(out, SECTIONTYPE, sectionHeader[idx].getSh_flags());
+    out << "  Address: \t0x" << sectionHeader[idx].getSh_addr() << endl;
+    out << "  Offset: \t0x" << sectionHeader[idx].getSh_offset() << endl;
+    out << "  size: \t0x" << sectionHeader[idx].getSh_size() << endl;
+    out << "  link: \t0x" << sectionHeader[idx].getSh_link() << endl;
+    out << "  info: \t0x" << sectionHeader[idx].getSh_info() << endl;
+    out << "  Address alignment: \t0x" << sectionHeader[idx].getSh_addralign() << endl;
+    out << "  Section size: \t0x" << sectionHeader[idx].getSh_entsize() << endl << endl;
   }
 }
 
@@ -585,7 +575,7 @@ void ELF::printElf() {
  * @param none
  * @return 64 bits unsigned int.
  */
-uint64_t ELF::getE_shoff() {
+uint64_t ELF::getE_shoff() const {
   return this->e_shoff_u64;
 }
 
@@ -594,7 +584,7 @@ uint64_t ELF::getE_shoff() {
  * @param none
  * @return 16 bits unsigned int.
  */
-uint16_t ELF::getE_phentsize() {
+uint16_t ELF::getE_phentsize() const {
   return this->e_phentsize_u16;
 }
 
@@ -603,7 +593,7 @@ uint16_t ELF::getE_phentsize() {
  * @param none
  * @return 16 bits unsigned int.
  */
-uint16_t ELF::getE_phnum() {
+uint16_t ELF::getE_phnum() const {
   return this->e_phnum_u16;
 }
 
@@ -612,52 +602,31 @@ uint16_t ELF::getE_phnum() {
  * @param none
  * @return 16 bits unsigned int.
  */
-uint16_t ELF::getE_shentsize() {
+uint16_t ELF::getE_shentsize() const {
   return this->e_shentsize_u16;
 }
 
 /**
- * @brief Returns an ELF's number of section headers value.
+ * @brief Returns an ELF's number of section headers, taken from the first
+ * section header when e_shnum is 0.
  * @param none
- * @return 16 bits unsigned int.
+ * @return 32 bits unsigned int.
  */
-uint16_t ELF::getE_shnum() {
-  return this->e_shnum_u16;
+uint32_t ELF::getE_shnum() const {
+  return this->e_shnum_u32;
 }
 
 /**
  * @brief Returns the name of a section header.
  * 
- * @param nameOffset The offset in a file of where to read the name.
- * @param tableIndx The index of a section header that will contain an array of string names.
- * @param file A ifstream file object that is already opened for reading in binary.
- * 
- * @return a string object of type std::string.
- */
-std::string ELF::getSectionHeaderName(uint32_t nameOffset, uint32_t tableIndx, std::ifstream& file) {
-  // loop over vector of sections
-  // if s_name and e_shntndex isn't zero
-  // find the name of sectionHeader by offset
-  // offset of name = sectionHeader[e_shstrndx_u16].sh_offset_u64[s_name];
-  std::string name;
-
-  if (nameOffset != 0) {
-      file.clear();
-      file.seekg(nameOffset + tableIndx, std::ios_base::beg);
-      
-      char ch;
-      while(file.get(ch)){
-          if (ch != '\0') {
-            name += ch;
-        } else {
-            break;
-        }
-      }
-      name += '\0';
-  } else {
-      return "None";
-  }
-      return name;
+ * @param nameOffset The section's sh_name, an offset into the section name table.
+ * 
+ * @return a view into the section name table, "None" for sections without
+ * a name and empty if the name is outside the table.
+ */
+std::string_view ELF::getSectionHeaderName(uint32_t nameOffset) const {
+  if (nameOffset == 0) return "None";
+  return sectionNames.at(nameOffset);
 }
 
 std::vector<SectionHeader> ELF::getSectionHeaders() const {
@@ -761,7 +730,7 @@ void ProgramHeader::setP_align(uint64_t value) {
  * 
  * @return None.
  */
-uint32_t ProgramHeader::getP_type() {
+uint32_t ProgramHeader::getP_type() const {
   return this->p_type_u32;
 }
 
@@ -770,7 +739,7 @@ uint32_t ProgramHeader::getP_type() {
  * 
  * @return The 4 bytes value to be set
  */
-uint32_t ProgramHeader::getP_flags() {
+uint32_t ProgramHeader::getP_flags() const {
   return this->p_flags_u32;  
 }
 
@@ -779,7 +748,7 @@ uint32_t ProgramHeader::getP_flags() {
  * 
  * @return The 8 bytes value to be set
  */
-uint64_t ProgramHeader::getP_offset() {
+uint64_t ProgramHeader::getP_offset() const {
   return this->p_offset_u64;
 }
 
@@ -788,7 +757,7 @@ uint64_t ProgramHeader::getP_offset() {
  * 
  * @return The 8 bytes value to be set
  */
-uint64_t ProgramHeader::getP_vaddr() {
+uint64_t ProgramHeader::getP_vaddr() const {
   return this->p_vaddr_u64;  
 }
 
@@ -797,7 +766,7 @@ uint64_t ProgramHeader::getP_vaddr() {
  * 
  * @return The 8 bytes value to be set
  */
-uint64_t ProgramHeader::getP_paddr() {
+uint64_t ProgramHeader::getP_paddr() const {
   return this->p_paddr_u64;  
 }
 
@@ -806,7 +775,7 @@ uint64_t ProgramHeader::getP_paddr() {
  * 
  * @return The 8 bytes value to be set
  */
-uint64_t ProgramHeader::getP_filesz() {
+uint64_t ProgramHeader::getP_filesz() const {
   return this->p_filesz_u64;  
 }
 
@@ -815,7 +784,7 @@ uint64_t ProgramHeader::getP_filesz() {
  * 
  * @return The 8 bytes value to be set
  */
-uint64_t ProgramHeader::getP_memsz() {
+uint64_t ProgramHeader::getP_memsz() const {
   return this->p_memsz_u64;  
 }
 
@@ -824,7 +793,7 @@ uint64_t ProgramHeader::getP_memsz() {
  * 
  * @return The 8 bytes value to be set
  */
-uint64_t ProgramHeader::getP_align() {
+uint64_t ProgramHeader::getP_align() const {
   return this->p_align_u64;
 }
 
@@ -835,16 +804,16 @@ void SectionHeader::setSh_name(uint32_t value) {
 void SectionHeader::setSh_type(uint32_t value) {
   this->sh_type_u32 = value;
 }
-void SectionHeader::setSh_flags(uint32_t value) {
+void SectionHeader::setSh_flags(uint64_t value) {
   this->sh_flags_u64 = value;
 }
-void SectionHeader::setSh_addr(uint32_t value) {
+void SectionHeader::setSh_addr(uint64_t value) {
   this->sh_addr_u64 = value;
 }
-void SectionHeader::setSh_offset(uint32_t value) {
+void SectionHeader::setSh_offset(uint64_t value) {
   this->sh_offset_u64 = value;
 }
-void SectionHeader::setSh_size(uint32_t value) {
+void SectionHeader::setSh_size(uint64_t value) {
   this->sh_size_u64 = value;
 }
 void SectionHeader::setSh_link(uint32_t value) {
@@ -853,60 +822,60 @@ void SectionHeader::setSh_link(uint32_t value) {
 void SectionHeader::setSh_info(uint32_t value) {
   this->sh_info_u32 = value;
 }
-void SectionHeader::setSh_addralign(uint32_t value) {
+void SectionHeader::setSh_addralign(uint64_t value) {
   this->sh_addralign_u64 = value;
 }
-void SectionHeader::setSh_entsize(uint32_t value) {
+void SectionHeader::setSh_entsize(uint64_t value) {
   this->sh_entsize_u64 = value;
 }
 
-uint32_t SectionHeader::getSh_name() {
+uint32_t SectionHeader::getSh_name() const {
   return this->sh_name_u32;
 }
-uint32_t SectionHeader::getSh_type() {
+uint32_t SectionHeader::getSh_type() const {
   return this->sh_type_u32;
 }
-uint32_t SectionHeader::getSh_flags() {
+uint64_t SectionHeader::getSh_flags() const {
   return this->sh_flags_u64;
 }
-uint32_t SectionHeader::getSh_addr() {
+uint64_t SectionHeader::getSh_addr() const {
   return this->sh_addr_u64;
 }
-uint32_t SectionHeader::getSh_offset() {
+uint64_t SectionHeader::getSh_offset() const {
   return this->sh_offset_u64;
 }
-uint32_t SectionHeader::getSh_size() {
+uint64_t SectionHeader::getSh_size() const {
   return this->sh_size_u64;
 }
-uint32_t SectionHeader::getSh_link() {
+uint32_t SectionHeader::getSh_link() const {
   return this->sh_link_u32;
 }
-uint32_t SectionHeader::getSh_info() {
+uint32_t SectionHeader::getSh_info() const {
   return this->sh_info_u32;
 }
-uint32_t SectionHeader::getSh_addralign() {
+uint64_t SectionHeader::getSh_addralign() const {
   return this->sh_addralign_u64;
 }
-uint32_t SectionHeader::getSh_entsize() {
+uint64_t SectionHeader::getSh_entsize() const {
   return this->sh_entsize_u64;
 }
 
 /**
  * @brief Sets a section header's name.
  * 
- * @param name a string object containing the name.
+ * @param name a view of the name, the memory has to outlive the header.
  * 
  * @return None.
  */
-void SectionHeader::setSh_name(std::string& name) {
+void SectionHeader::setSh_name(std::string_view name) {
   this->name = name;
 }
 
 /**
  * @brief Gets the name of a section header.
  * 
- * @return A string object containing the name of section header
+ * @return A view of the name, valid as long as the ELF object it came from.
  */
-std::string SectionHeader::getS_name() {
+std::string_view SectionHeader::getS_name() const {
   return this->name;
 }
\ No newline at end of file
@@ -18,32 +18,32 @@
 class SectionHeader {
   public:
     void setSh_name(uint32_t);
-    void setSh_name(std::string&);
+    void setSh_name(std::string_view);
     void setSh_type(uint32_t);
-    void setSh_flags(uint32_t);
-    void setSh_addr(uint32_t);
-    void setSh_offset(uint32_t);
-    void setSh_size(uint32_t);
+    void setSh_flags(uint64_t);
+    void setSh_addr(uint64_t);
+    void setSh_offset(uint64_t);
+    void setSh_size(uint64_t);
     void setSh_link(uint32_t);
     void setSh_info(uint32_t);
-    void setSh_addralign(uint32_t);
-    void setSh_entsize(uint32_t);
-
-    uint32_t getSh_name();
-    std::string getS_name();
-    uint32_t getSh_type();
-    uint32_t getSh_flags();
-    uint32_t getSh_addr();
-    uint32_t getSh_offset();
-    uint32_t getSh_size();
-    uint32_t getSh_link();
-    uint32_t getSh_info();
-    uint32_t getSh_addralign();
-    uint32_t getSh_entsize();
+    void setSh_addralign(uint64_t);
+    void setSh_entsize(uint64_t);
+
+    uint32_t getSh_name() const;
+    std::string_view getS_name() const;
+    uint32_t getSh_type() const;
+    uint64_t getSh_flags() const;
+    uint64_t getSh_addr() const;
+    uint64_t getSh_offset() const;
+    uint64_t getSh_size() const;
+    uint32_t getSh_link() const;
+    uint32_t getSh_info() const;
+    uint64_t getSh_addralign() const;
+    uint64_t getSh_entsize() const;
 
   private:
     uint32_t sh_name_u32;
-    std::string name;
+    std::string_view name;  // points into ELF's section name table
     uint32_t sh_type_u32;
     uint64_t sh_flags_u64;
     uint64_t sh_addr_u64;
@@ -69,14 +69,14 @@ class ProgramHeader {
     void setP_memsz(uint64_t);
     void setP_align(uint64_t);
 
-    uint32_t getP_type();
-    uint32_t getP_flags();
-    uint64_t getP_offset();
-    uint64_t getP_vaddr();
-    uint64_t getP_paddr();
-    uint64_t getP_filesz();
-    uint64_t getP_memsz();
-    uint64_t getP_align();
+    uint32_t getP_type() const;
+    uint32_t getP_flags() const;
+    uint64_t getP_offset() const;
+    uint64_t getP_vaddr() const;
+    uint64_t getP_paddr() const;
+    uint64_t getP_filesz() const;
+    uint64_t getP_memsz() const;
+    uint64_t getP_align() const;
 
   private:
     uint32_t p_type_u32;
@@ -104,13 +104,13 @@ class ELF {
   ELF(std::string filename);
   
   virtual void init(std::string filename);
+  virtual void init(std::span<const std::byte>, uint64_t = 0);
+  void parse(ByteReader& file);
   
-  void parse64(std::ifstream& file, bool littleEndian);
-  void parse32(std::ifstream& file, bool littleEndian);
-  void readE_ident(std::ifstream& file);
-  void mapFlags();
-  void printElf();
-  std::string getSectionHeaderName(uint32_t, uint32_t, std::ifstream&);
+  template <std::endian Order, typename Word> void parseImage(ByteReader&);
+  void readE_ident(ByteReader& file);
+  void printElf(OutputBuffer&) const;
+  std::string_view getSectionHeaderName(uint32_t) const;
 
   unsigned char* getE_ident();
   uint16_t getE_type() const;
@@ -121,19 +121,15 @@ class ELF {
   uint16_t getEi_class() const;
   uint16_t getEi_data() const;
   uint16_t getEi_osabi() const;
-  uint64_t getE_shoff();
-  uint16_t getE_phentsize();
-  uint16_t getE_phnum();
-  uint16_t getE_shentsize();
-  uint16_t getE_shnum();
-
-  void printFlag(uint32_t, uint32_t);
-
-  std::map<uint16_t, std::string> getEtypeFlags() const;
-  std::map<uint16_t, std::string> getEmachineFlags() const;
-  std::map<uint16_t, std::string> getEclassFlags() const;
-  std::map<uint16_t, std::string> getEdataFlags() const;
-  std::map<uint16_t, std::string> getEiosabiFlags() const;
+  uint64_t getE_shoff() const;
+  uint16_t getE_phentsize() const;
+  uint16_t getE_phnum() const;
+  uint16_t getE_shentsize() const;
+  uint32_t getE_shnum() const;
+
+  void printFlag(OutputBuffer&, uint32_t, uint32_t) const;
+
+  static std::string_view getFlagName(uint32_t, uint64_t);
   std::vector<SectionHeader> getSectionHeaders() const;
 
   // flags/machine are "bytes to string" mapping 
@@ -168,24 +164,13 @@ class ELF {
   uint16_t e_phentsize_u16;
   uint16_t e_phnum_u16;
   uint16_t e_shentsize_u16;
-  uint16_t e_shnum_u16;
-  uint16_t e_shstrndx_u16;
+  uint32_t e_shnum_u32;     // from section header 0 past 0xff00 sections
+  uint32_t e_shstrndx_u32;  // from section header 0 when SHN_XINDEX
 
   
   std::vector<ProgramHeader> programHeader;
   std::vector<SectionHeader> sectionHeader;
-  
-
-  std::map<uint16_t, std::string> eclassFlags;   
-  std::map<uint16_t, std::string> emachineFlags; 
-  std::map<uint16_t, std::string> etypeFlags;    
-  std::map<uint16_t, std::string> edataFlags;    
-  std::map<uint16_t, std::string> eiosabiFlags;  
-
-  std::map<uint32_t, std::string> sectionHeaderType_m;
-  std::map<uint32_t, std::string> sectionHeaderFlag_m;
-  std::map<uint32_t, std::string> programHeaderType_m;
-  std::map<uint32_t, std::string> programHeaderFlag_m;  
+  StringTable sectionNames;  // .shstrtab, section names point into it
 };
 
 #endif
\ No newline at end of file
@@ -15,177 +15,277 @@ FileIO::~FileIO() {}
  * @brief A method to print out parsed information from a class object.
  * if file can't be read, an exception is thrown with proper message.
  *
- * @param fileObject A class object that will be either PE, ELF or MACHO, based
+ * @param filename name of a file that will be either PE, ELF or MACHO, based
  * on the type the method will continue printing relevant information.
  *
  * @return none.
  */
-FileIO::FileIO(std::string filename) {
-  MD5Hasher md5;
-  SHA1     sha1;
-
-  // Calculate MD5 / SHA1 hashes
-  md5.MD5FileContent(filename, md5_hash);
-  sha1_hash = sha1.from_file(filename);
-
-  std::cout << "Reading " << filename << std::endl;
-  std::cout << "  MD5:  " << md5_hash.c_str() << std::endl;
-  std::cout << "  SHA1: " << sha1_hash.c_str() << std::endl;
-
-  uint32_t bytes = getMagicBytes(filename);
-
-  if (uint16_t(bytes) == PE_FILE) {
-    PE pe;
-    pe.init(filename);
-    printPE(pe);
-  } else if (bytes == ELF_FILE) {
-    ELF elf;
-    elf.init(filename);
-    printELF(elf);
-  } else if (bytes == MACHO_32_FILE || bytes == MACHO_64_FILE) {
-    MACHO mach_o;
-    mach_o.init(filename);
-    printMachO(mach_o);
-  } else if (bytes == MACHO_FAT_FILE || bytes == MACHO_FAT_CIGAM_FILE) {
-
-  } else {
-    throw std::runtime_error("Could not read magic bytes");
-  }
-}
+FileIO::FileIO(std::string filename) : FileIO(filename, std::cout) {}
 
 /**
- * @brief A Method to print out parsed information from a class object.
+ * @brief Same as FileIO(std::string), printing to a given stream instead of
+ * std::cout. Whatever was read is printed before a parsing error is thrown.
  *
-* @param file A MACHO class object
+ * @param filename name of a file to be parsed.
+ * @param out A stream that receives the parsed information.
  *
  * @return none.
  */
-void FileIO::printMachO(MACHO& file) const {
-  file.printMach();
+FileIO::FileIO(std::string filename, std::ostream& out) {
+  ScanResult result = scan(filename);
+  render(result, out);
+  if (result.error) result.error.raise();
 }
 
 /**
- * @brief A Method to print out parsed information from a class object.
+ * @brief Reads a file, hashes its content and parses it based on its magic
+ * bytes. Nothing is printed and no state is shared, several files can be
+ * scanned at once. The file is opened and read only once, magic bytes
+ * detection, hashing and parsing all work on the same mapping. A file
+ * the policy doesn't hash and that can't be parsed has only its first
+ * page read.
  *
- * @param file A PE class object
+ * @param filename name of a file to be parsed.
+ * @param policy which hashes to compute, by format and size.
  *
- * @return none.
+ * @return the result, with error set if the file couldn't be parsed.
+ * throws std::runtime_error if the file can't be read at all.
  */
-void FileIO::printPE(PE& file) const {
-  file.printPE();
+ScanResult FileIO::scan(const std::string& filename,
+                        const HashPolicy& policy) {
+  return std::move(tryScan(filename, policy).value());
 }
 
 /**
- * @brief A Method to print out parsed information from a class object.
+ * @brief Same as scan(const std::string&, const HashPolicy&) without
+ * exceptions, a file that can't be read gives an IO_ERROR instead of a
+ * result.
  *
-* @param file A ELF class object
+ * @param filename name of a file to be parsed.
+ * @param policy which hashes to compute, by format and size.
  *
- * @return none.
+ * @return the result, or the error that kept the file from being read.
  */
-void FileIO::printELF(ELF& file) const {
-  file.printElf();
+Result<ScanResult> FileIO::tryScan(const std::string& filename,
+                                   const HashPolicy& policy) {
+  auto file = std::make_unique<MappedFile>();
+  Error error = file->tryOpen(filename);
+  if (error) return error;
+
+  ScanResult result = scan(file->bytes(), filename, policy);
+  result.file = std::move(file);
+  return result;
 }
 
 /**
- * @brief Reads unsigned 8 bits and returns them.
+ * @brief Same as scan(const std::string&) for a file already in memory.
+ * A PE parsed from it keeps views into the buffer, the buffer has to
+ * outlive the result.
  *
- * @param in An std::ifstream object with file already opened.
+ * @param content the file's bytes.
+ * @param name name reported for the file.
+ * @param policy which hashes to compute, by format and size.
  *
- * @return an 8 bit unsigned integer.
+ * @return the result, with error set if the content couldn't be parsed.
+ * Only the parsers throw internally, on damaged files; an unknown format
+ * is reported without an exception.
  */
-uint8_t FileIO::read_u8(std::ifstream& in) {
-  uint8_t value = 0;
-  unsigned char ch[1] = {0};
+ScanResult FileIO::scan(std::span<const std::byte> content,
+                        const std::string& name, const HashPolicy& policy) {
+  ScanResult result;
+  result.filename = name;
 
-  in.read(reinterpret_cast<char*>(ch), 1);
-  value = ch[0];
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(content.data());
+  result.magic_u32 = getMagicBytes(data, content.size());
+  result.format = classify(result.magic_u32);
+  uint32_t digests = policy.digestsFor(result.format, content.size());
+  ByteReader in(content);
 
-  return value;
+  if (result.format == ScanResult::UNKNOWN_FORMAT) {
+    hashContent(content, result, digests, policy.threads);
+    result.error =
+        Error(ErrorCode::UNKNOWN_FORMAT, "Could not read magic bytes");
+    return result;
+  }
+
+  try {
+    switch (result.format) {
+      case ScanResult::PE_FORMAT:
+        result.pe = std::make_unique<PE>();
+        result.pe->parse(in);
+        break;
+      case ScanResult::ELF_FORMAT:
+        result.elf = std::make_unique<ELF>();
+        result.elf->parse(in);
+        break;
+      case ScanResult::MACHO_FORMAT:
+        result.macho = std::make_unique<MACHO>();
+        result.macho->parse(in);
+        break;
+      case ScanResult::MACHO_FAT_FORMAT:
+      case ScanResult::UNKNOWN_FORMAT:
+        break;
+    }
+  } catch (std::out_of_range& except) {
+    result.error = Error(ErrorCode::TRUNCATED, except.what());
+  } catch (std::exception& except) {
+    result.error = Error(ErrorCode::MALFORMED_TABLE, except.what());
+  }
+
+  // hashed after parsing, the Authenticode digests skip ranges found in
+  // the PE headers.
+  hashContent(content, result, digests, policy.threads);
+  return result;
 }
 
 /**
- * @brief Reads unsigned 16 bits and returns them in little endian byte order.
+ * @brief Prints a scan result, the hashes followed by the parsed image.
+ * A partly parsed image isn't printed.
  *
- * @param in An std::ifstream object with file already opened.
- * @param littleEnd Indicates byte order, True: Little end. False: Big end.
+ * @param result A result returned by scan().
+ * @param out A stream to print to, it gets the whole text in one write.
+ * @param shown extra tables to print, a combination of details values.
  *
- * @return a 16 bit unsigned integer.
+ * @return none.
  */
-uint16_t FileIO::read_u16(std::ifstream& in, bool littleEnd) {
-  uint16_t value = 0;
-  unsigned char ch[3] = {0};
+void FileIO::render(const ScanResult& result, std::ostream& out,
+                    uint32_t shown) {
+  OutputBuffer buffer;
+  render(result, buffer, shown);
+  buffer.writeTo(out);
+}
 
-  in.read(reinterpret_cast<char*>(ch), 2);
-  if (littleEnd) {
-    value |= uint16_t(ch[1]) << 8;
-    value |= uint16_t(ch[0]);
-  } else {
-    value |= uint16_t(ch[0]) << 8;
-    value |= uint16_t(ch[1]);
+/**
+ * @brief Same as render(const ScanResult&, std::ostream&), formatting
+ * into a buffer.
+ *
+ * @param result A result returned by scan().
+ * @param out A buffer to format into.
+ * @param shown extra tables to print, a combination of details values.
+ *
+ * @return none.
+ */
+void FileIO::render(const ScanResult& result, OutputBuffer& out,
+                    uint32_t shown) {
+  out << "Reading " << result.filename << std::endl;
+  if (!result.md5_hash.empty()) {
+    out << "  MD5:  " << result.md5_hash << std::endl;
+  }
+  if (!result.sha1_hash.empty()) {
+    out << "  SHA1: " << result.sha1_hash << std::endl;
+  }
+  if (!result.sha256_hash.empty()) {
+    out << "  SHA256: " << result.sha256_hash << std::endl;
+  }
+  if (!result.blake3_hash.empty()) {
+    out << "  BLAKE3: " << result.blake3_hash << std::endl;
+  }
+  if (!result.crc32c_hash.empty()) {
+    out << "  CRC32C: " << result.crc32c_hash << std::endl;
+  }
+  if (!result.authenticode_sha1_hash.empty()) {
+    out << "  Authenticode SHA1: " << result.authenticode_sha1_hash
+        << std::endl;
+  }
+  if (!result.authenticode_sha256_hash.empty()) {
+    out << "  Authenticode SHA256: " << result.authenticode_sha256_hash
+        << std::endl;
+  }
+  if (result.error) return;
+
+  if (result.pe) {
+    printPE(*result.pe, out, shown);
+  } else if (result.elf) {
+    printELF(*result.elf, out);
+  } else if (result.macho) {
+    printMachO(*result.macho, out);
   }
-  return value;
 }
 
 /**
- * @brief Reads unsigned 32 bits and returns them in little endian byte order.
+ * @brief Calculates the requested hashes of a file's content already in
+ * memory. The streamed digests share a single pass, see MultiHasher;
+ * BLAKE3 hashes the mapping on its own, split across several threads when
+ * the file is large. The Authenticode digests are only computed for a PE
+ * file that parsed cleanly, they skip the ranges the PE headers point at.
  *
- * @param in An std::ifstream object with file already opened.
- * @param littleEnd Indicates byte order, True: Little end. False: Big end.
+ * @param content the file's bytes.
+ * @param result receives the hashes, the others are left empty.
+ * @param digests which hashes to compute.
+ * @param threads most threads BLAKE3 may use, 0 for one per core.
  *
- * @return a 32 bit unsigned integer.
+ * @return none.
  */
-uint32_t FileIO::read_u32(std::ifstream& in, bool littleEnd) {
-  uint32_t value = 0;
-  unsigned char ch[4] = {0};
+void FileIO::hashContent(std::span<const std::byte> content,
+                         ScanResult& result, uint32_t digests,
+                         unsigned threads) {
+  if (!result.pe || result.error) {
+    digests &= ~uint32_t(MultiHasher::AUTHENTICODE_DIGESTS);
+  }
+
+  if (digests & ~uint32_t(MultiHasher::BLAKE3_DIGEST)) {
+    MultiHasher hasher(digests);
+    if (digests & MultiHasher::AUTHENTICODE_DIGESTS) {
+      for (const auto& [offset, size] : result.pe->getAuthenticodeGaps()) {
+        hasher.skipForAuthenticode(offset, size);
+      }
+    }
+    hasher.update(content);
+    hasher.final();
 
-  in.read(reinterpret_cast<char*>(ch), 4);
-  if (littleEnd) {
-    value |= uint32_t(ch[0]);
-    value |= uint32_t(ch[1]) << 8;
-    value |= uint32_t(ch[2]) << 16;
-    value |= uint32_t(ch[3]) << 24;
-  } else {
-    value |= uint32_t(ch[0]) << 24;
-    value |= uint32_t(ch[1]) << 16;
-    value |= uint32_t(ch[2]) << 8;
-    value |= uint32_t(ch[3]);
+    result.md5_hash = hasher.getMD5();
+    result.sha1_hash = hasher.getSHA1();
+    result.sha256_hash = hasher.getSHA256();
+    result.crc32c_hash = hasher.getCRC32C();
+    result.authenticode_sha1_hash = hasher.getAuthenticodeSHA1();
+    result.authenticode_sha256_hash = hasher.getAuthenticodeSHA256();
+  }
+
+  if (digests & MultiHasher::BLAKE3_DIGEST) {
+    result.blake3_hash = Hex::toString(
+        BLAKE3::hash(content, threads != 0
+                                  ? threads
+                                  : std::thread::hardware_concurrency()));
   }
-  return value;
 }
 
 /**
- * @brief Reads unsigned 64 bits and returns them in little endian byte order.
- *
- * @param in An std::ifstream object with file already opened.
- * @param littleEnd Indicates byte order, True: Little end. False: Big end.
- *
- * @return a 64 bit unsigned integer.
- */
-uint64_t FileIO::read_u64(std::ifstream& in, bool littleEnd) {
-  uint64_t value = 0;
-  unsigned char ch[9] = {0};
-
-  in.read(reinterpret_cast<char*>(ch), 8);
-  if (littleEnd) {
-    value |= uint64_t(ch[0]);
-    value |= uint64_t(ch[1]) << 8;
-    value |= uint64_t(ch[2]) << 16;
-    value |= uint64_t(ch[3]) << 24;
-    value |= uint64_t(ch[4]) << 32;
-    value |= uint64_t(ch[5]) << 40;
-    value |= uint64_t(ch[6]) << 48;
-    value |= uint64_t(ch[7]) << 56;
-  } else {
-    value |= uint64_t(ch[0]) << 56;
-    value |= uint64_t(ch[1]) << 48;
-    value |= uint64_t(ch[2]) << 40;
-    value |= uint64_t(ch[3]) << 32;
-    value |= uint64_t(ch[4]) << 24;
-    value |= uint64_t(ch[5]) << 16;
-    value |= uint64_t(ch[6]) << 8;
-    value |= uint64_t(ch[7]);
-  }
-  return value;
+ * @brief A Method to print out parsed information from a class object.
+ *
+* @param file A MACHO class object
+ * @param out A buffer to print to.
+ *
+ * @return none.
+ */
+void FileIO::printMachO(const MACHO& file, OutputBuffer& out) {
+  file.printMach(out);
+}
+
+/**
+ * @brief A Method to print out parsed information from a class object.
+ *
+ * @param file A PE class object
+ * @param out A buffer to print to.
+ * @param shown extra tables to print, a combination of details values.
+ *
+ * @return none.
+ */
+void FileIO::printPE(const PE& file, OutputBuffer& out, uint32_t shown) {
+  file.printPE(out);
+  if (shown & IMPORT_DETAILS) file.printImports(out);
+  if (shown & EXPORT_DETAILS) file.printExports(out);
+}
+
+/**
+ * @brief A Method to print out parsed information from a class object.
+ *
+* @param file A ELF class object
+ * @param out A buffer to print to.
+ *
+ * @return none.
+ */
+void FileIO::printELF(const ELF& file, OutputBuffer& out) {
+  file.printElf(out);
 }
 
 /**
@@ -199,11 +299,59 @@ uint32_t FileIO::getMagicBytes(const std::string& filename) const{
   using namespace std;
   ifstream file(filename, ios::binary);
   if (file.fail()) {
-    cout << "Error, cant find file." << endl;
     return 1;
   }
-  uint32_t bytes = read_u32(file, true);
+  uint8_t magic[4] = {0};
+  file.read(reinterpret_cast<char*>(magic), sizeof(magic));
   file.close();
 
-  return bytes;
-}
\ No newline at end of file
+  ByteReader in(magic, sizeof(magic));
+  return in.read_u32(true);
+}
+
+/**
+ * @brief Reads first 4 bytes of a buffer as little endian byte order.
+ *
+ * @param data start of the file's content.
+ * @param size number of bytes available, missing bytes are read as zero.
+ *
+ * @return 4 bytes read from the beginning of the buffer.
+ */
+uint32_t FileIO::getMagicBytes(const uint8_t* data, uint64_t size) {
+  uint8_t magic[4] = {0};
+  std::memcpy(magic, data, std::min<uint64_t>(size, sizeof(magic)));
+
+  ByteReader in(magic, sizeof(magic));
+  return in.read_u32(true);
+}
+
+/**
+ * @brief Checks whether magic bytes belong to a format FileIO handles.
+ *
+ * @param bytes value returned by getMagicBytes().
+ *
+ * @return true for PE, ELF and Mach-O (including fat) files.
+ */
+bool FileIO::isKnownFormat(uint32_t bytes) {
+  return classify(bytes) != ScanResult::UNKNOWN_FORMAT;
+}
+
+/**
+ * @brief Tells a file's format from its magic bytes.
+ *
+ * @param bytes the first 4 bytes, as returned by getMagicBytes().
+ *
+ * @return the format, UNKNOWN_FORMAT if it isn't PE, ELF or Mach-O.
+ */
+ScanResult::fileFormat FileIO::classify(uint32_t bytes) {
+  if (uint16_t(bytes) == PE_FILE) return ScanResult::PE_FORMAT;
+  if (bytes == ELF_FILE) return ScanResult::ELF_FORMAT;
+  if (bytes == MACHO_32_FILE || bytes == MACHO_64_FILE ||
+      bytes == MACHO_32_CIGAM_FILE || bytes == MACHO_64_CIGAM_FILE) {
+    return ScanResult::MACHO_FORMAT;
+  }
+  if (bytes == MACHO_FAT_FILE || bytes == MACHO_FAT_CIGAM_FILE) {
+    return ScanResult::MACHO_FAT_FORMAT;
+  }
+  return ScanResult::UNKNOWN_FORMAT;
+}
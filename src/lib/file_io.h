@@ -15,9 +15,12 @@
 #include "macho.h"
 #include "pe.h"
 #include "elf.h"
+#include "scan_result.h"
+#include "hash_policy.h"
 
 /**
- * @brief FileIO class handles files that will be parsed.
+ * @brief FileIO class handles files that will be parsed. scan() reads a file
+ * without any output, render() prints a result.
  */
 class FileIO {
  public:
@@ -28,29 +31,43 @@ class FileIO {
 
   FileIO();
   FileIO(std::string);
+  FileIO(std::string, std::ostream&);
   virtual ~FileIO();
 
-  void printPE(PE&) const;
-  void printELF(ELF&) const;
+  static ScanResult scan(const std::string&,
+                         const HashPolicy& = HashPolicy());
+  static Result<ScanResult> tryScan(const std::string&,
+                                    const HashPolicy& = HashPolicy());
+  static ScanResult scan(std::span<const std::byte>, const std::string&,
+                         const HashPolicy& = HashPolicy());
+  static void render(const ScanResult&, std::ostream&, uint32_t = 0);
+  static void render(const ScanResult&, OutputBuffer&, uint32_t = 0);
+
+  static void printPE(const PE&, OutputBuffer&, uint32_t = 0);
+  static void printELF(const ELF&, OutputBuffer&);
   uint32_t getMagicBytes(const std::string&) const;
-  void printMachO(MACHO&) const;
+  static uint32_t getMagicBytes(const uint8_t*, uint64_t);
+  static bool isKnownFormat(uint32_t);
+  static ScanResult::fileFormat classify(uint32_t);
+  static void printMachO(const MACHO&, OutputBuffer&);
+
+  // tables render() prints on top of the headers
+  enum details { IMPORT_DETAILS = 1 << 0,
+                 EXPORT_DETAILS = 1 << 1 };
 
   enum fileType { MACHO_32_FILE = 0xFEEDFACE, 
                   MACHO_64_FILE = 0xFEEDFACF,
+                  MACHO_32_CIGAM_FILE = 0xCEFAEDFE,
+                  MACHO_64_CIGAM_FILE = 0xCFFAEDFE,
                   MACHO_FAT_FILE = 0xCAFEBABE,
                   MACHO_FAT_CIGAM_FILE = 0xBEBAFECA,
                   PE_FILE = 0x5A4D,
                   ELF_FILE = 0x464C457F};
 
 
-  static uint8_t read_u8(std::ifstream&);
-  static uint16_t read_u16(std::ifstream&, bool);
-  static uint32_t read_u32(std::ifstream&, bool);
-  static uint64_t read_u64(std::ifstream&, bool);
-
   private:
-    std::string md5_hash;
-    std::string sha1_hash;
+    static void hashContent(std::span<const std::byte>, ScanResult&,
+                            uint32_t, unsigned);
 };
 
 #endif
@@ -0,0 +1,83 @@
+/**
+ * @file flag_table.h
+ * @brief  Definitions for FlagTable, a constant table naming flag and enum
+ *      values found in headers.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef FLAG_TABLE_H
+#define FLAG_TABLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief A flag value and its name.
+ */
+struct FlagName {
+  uint64_t value;
+  std::string_view name;
+};
+
+/**
+ * @brief FlagTable holds names sorted by value, built at compile time and
+ * shared by every parsed file. Lookups are a binary search and never
+ * allocate.
+ */
+template <size_t N>
+class FlagTable {
+ public:
+  /**
+   * @brief Sorts entries by value, when a value is listed more than once
+   * the first name given is kept.
+   *
+   * @param list value / name pairs in any order.
+   */
+  constexpr explicit FlagTable(const FlagName (&list)[N]) {
+    for (size_t idx = 0; idx < N; idx++) {
+      // insertion sort, stable so the first duplicate stays in front.
+      size_t pos = count;
+      while (pos > 0 && entries[pos - 1].value > list[idx].value) pos--;
+      if (pos > 0 && entries[pos - 1].value == list[idx].value) continue;
+      for (size_t move = count; move > pos; move--) {
+        entries[move] = entries[move - 1];
+      }
+      entries[pos] = list[idx];
+      count++;
+    }
+  }
+
+  /**
+   * @brief Looks up the name of a value.
+   *
+   * @param value the flag value.
+   *
+   * @return the name, or an empty view for unknown values.
+   */
+  constexpr std::string_view find(uint64_t value) const {
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+      size_t mid = low + (high - low) / 2;
+      if (entries[mid].value < value) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    if (low < count && entries[low].value == value) return entries[low].name;
+    return {};
+  }
+
+  constexpr size_t size() const { return count; }
+
+ private:
+  std::array<FlagName, N> entries{};
+  size_t count = 0;
+};
+
+#endif
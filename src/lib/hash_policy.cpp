@@ -0,0 +1,63 @@
+/**
+ * @file hash_policy.cpp
+ * @brief  Implements HashPolicy, digests picked by format and size.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "../headers.h"
+
+/**
+ * @brief Returns the digests to compute for a classified file.
+ *
+ * @param format the file's format, from its magic bytes.
+ * @param size the file's size in bytes.
+ *
+ * @return a combination of MultiHasher::digests values, 0 if the file
+ * isn't hashed. The Authenticode digests are dropped for other formats
+ * than PE.
+ */
+uint32_t HashPolicy::digestsFor(ScanResult::fileFormat format,
+                                uint64_t size) const {
+  if (!(formats & (1u << format))) return 0;
+  if (size < minSize || size > maxSize) return 0;
+  if (format != ScanResult::PE_FORMAT) {
+    return digests & ~uint32_t(MultiHasher::AUTHENTICODE_DIGESTS);
+  }
+  return digests;
+}
+
+/**
+ * @brief Turns a comma separated list of format names ("pe", "elf",
+ * "macho", "unknown", "executables", "all" or "none") into formats flags.
+ *
+ * @param list the names, e.g. "pe,elf".
+ *
+ * @return a combination of formats values. throws std::invalid_argument
+ * for unknown names.
+ */
+uint32_t HashPolicy::parseFormats(const std::string& list) {
+  uint32_t selected = 0;
+  std::stringstream names(list);
+  std::string name;
+
+  while (std::getline(names, name, ',')) {
+    if (name == "pe") {
+      selected |= PE_FORMATS;
+    } else if (name == "elf") {
+      selected |= ELF_FORMATS;
+    } else if (name == "macho") {
+      selected |= MACHO_FORMATS;
+    } else if (name == "unknown") {
+      selected |= UNKNOWN_FORMATS;
+    } else if (name == "executables") {
+      selected |= EXECUTABLE_FORMATS;
+    } else if (name == "all") {
+      selected |= ALL_FORMATS;
+    } else if (name != "none") {
+      throw std::invalid_argument("unknown format: " + name);
+    }
+  }
+  return selected;
+}
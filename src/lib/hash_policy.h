@@ -0,0 +1,46 @@
+/**
+ * @file hash_policy.h
+ * @brief  Definitions for HashPolicy, which decides the digests of a file
+ *      once its format is known.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef HASH_POLICY_H
+#define HASH_POLICY_H
+
+#include "../headers.h"
+#include "scan_result.h"
+
+/**
+ * @brief HashPolicy is applied after a file's magic bytes are read: files
+ * of a format that isn't selected, or outside the size range, get no
+ * digests. A file of unknown format that isn't hashed is rejected without
+ * reading past its first bytes. The default hashes every file, as before
+ * there was a policy.
+ */
+struct HashPolicy {
+  enum formats { PE_FORMATS = 1 << ScanResult::PE_FORMAT,
+                 ELF_FORMATS = 1 << ScanResult::ELF_FORMAT,
+                 MACHO_FORMATS = 1 << ScanResult::MACHO_FORMAT |
+                                 1 << ScanResult::MACHO_FAT_FORMAT,
+                 UNKNOWN_FORMATS = 1 << ScanResult::UNKNOWN_FORMAT,
+                 EXECUTABLE_FORMATS = PE_FORMATS | ELF_FORMATS |
+                                      MACHO_FORMATS,
+                 ALL_FORMATS = EXECUTABLE_FORMATS | UNKNOWN_FORMATS };
+
+  HashPolicy(uint32_t digests = MultiHasher::DEFAULT_DIGESTS)
+      : digests(digests) {}
+
+  uint32_t digestsFor(ScanResult::fileFormat, uint64_t) const;
+  static uint32_t parseFormats(const std::string&);
+
+  uint32_t digests;                   // see MultiHasher::digests
+  uint32_t formats = ALL_FORMATS;     // formats that are hashed
+  uint64_t minSize = 0;               // smaller files aren't hashed
+  uint64_t maxSize = UINT64_MAX;      // larger files aren't hashed
+  unsigned threads = 0;               // BLAKE3 threads, 0: all cores
+};
+
+#endif
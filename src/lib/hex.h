@@ -0,0 +1,69 @@
+/**
+ * @file hex.h
+ * @brief  Table driven lowercase hex encoding for digests and raw bytes.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef HEX_H
+#define HEX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Builds the character pairs of all byte values at compile time.
+ */
+constexpr std::array<char, 512> makeHexTable() {
+  const char digits[] = "0123456789abcdef";
+  std::array<char, 512> pairs{};
+  for (size_t value = 0; value < 256; value++) {
+    pairs[2 * value] = digits[value >> 4];
+    pairs[2 * value + 1] = digits[value & 0xf];
+  }
+  return pairs;
+}
+
+/**
+ * @brief Hex holds a 256 entry table with the two characters of every
+ * byte value, encoding is one table load and one 2 byte store per byte.
+ */
+class Hex {
+ public:
+  /**
+   * @brief Writes 2 * count characters to 'out', no terminator is added.
+   *
+   * @param bytes bytes to be encoded.
+   * @param count number of bytes.
+   * @param out destination, at least 2 * count characters long.
+   */
+  static void encode(const uint8_t* bytes, size_t count, char* out) {
+    for (size_t idx = 0; idx < count; idx++) {
+      const char* pair = &table[2 * size_t(bytes[idx])];
+      out[2 * idx] = pair[0];
+      out[2 * idx + 1] = pair[1];
+    }
+  }
+
+  /**
+   * @brief Encodes a whole digest.
+   *
+   * @param digest raw digest bytes.
+   *
+   * @return lowercase hex string, two characters per byte.
+   */
+  template <size_t N>
+  static std::string toString(const std::array<uint8_t, N>& digest) {
+    std::string hex(2 * N, '0');
+    encode(digest.data(), N, hex.data());
+    return hex;
+  }
+
+ private:
+  static constexpr std::array<char, 512> table = makeHexTable();
+};
+
+#endif
@@ -22,93 +22,124 @@ MACHO::MACHO(const std::string& filename) {
 }
 
 /**
- * @brief Open file in binary mode and calls parsing method.
+ * @brief Maps file into memory and calls parsing method.
  *
  * @param filename a string for a file to be opened and parsed.
  *
  * @return none.
  */
 void MACHO::init(const std::string& filename) {
-  std::ifstream file(filename, std::ios::binary);
-  magicBytes_u32 = FileIO::read_u32(file, true);
+  MappedFile mapped(filename);
+  init(mapped.bytes());
+}
 
-  if (magicBytes_u32 == 0xFEEDFACF || magicBytes_u32 == 0xFEEDFACE) {
-    parseX86_macho(file);
+/**
+ * @brief Parses an image already in memory, without copying it or touching
+ * the file system. The buffer is only read during the call.
+ *
+ * @param image bytes holding the image.
+ * @param base offset of the image inside the buffer, file offsets found in
+ * the headers are relative to it.
+ *
+ * @return none.
+ */
+void MACHO::init(std::span<const std::byte> image, uint64_t base) {
+  ByteReader file(image, base);
+  parse(file);
+}
+
+/**
+ * @brief Reads magic bytes and calls the parsing method matching them.
+ *
+ * @param file A ByteReader over the Mach-O file content, set at offset 0.
+ *
+ * @return none.
+ */
+void MACHO::parse(ByteReader& file) {
+  magicBytes_u32 = file.read<uint32_t>();
+
+  if (magicBytes_u32 == 0xFEEDFACE) {
+    parseImage<std::endian::little, uint32_t>(file);
+  } else if (magicBytes_u32 == 0xFEEDFACF) {
+    parseImage<std::endian::little, uint64_t>(file);
+  } else if (magicBytes_u32 == 0xCEFAEDFE) {
+    parseImage<std::endian::big, uint32_t>(file);
+  } else if (magicBytes_u32 == 0xCFFAEDFE) {
+    parseImage<std::endian::big, uint64_t>(file);
   } else if (magicBytes_u32 == 0xCAFEBABE || magicBytes_u32 == 0xBEBAFECA) {
     parseUniMacho(file);
   }
 }
 
-void MACHO::parseUniMacho(std::ifstream& file) {
+void MACHO::parseUniMacho(ByteReader& file) {
 
 }
 
-/*** 
- * @brief parses x86 Mach-O format (32 and 64 bit).
- * @param file an ifstream object file, with the file already opened and set at offset 4
+/**
+ * @brief parses a thin Mach-O image (32 and 64 bit, either byte order).
+ * Instantiated once per byte order and word size.
+ *
+ * @tparam Order byte order, big endian for MH_CIGAM / MH_CIGAM_64 files.
+ * @tparam Word uint32_t for 32 bit, uint64_t for 64 bit images.
+ * @param file A ByteReader over the Mach-O file content, set at offset 4
  * 
  * @return none.
  */
-void MACHO::parseX86_macho(std::ifstream& file) {
-  cpuType_u32 = FileIO::read_u32(file, true);
-  cpuSubtype_u32 = FileIO::read_u32(file, true);
-  fileType_u32 = FileIO::read_u32(file, true);
-  numLoadCommands_u32 = FileIO::read_u32(file, true);
-  sizeOfLoadCommand_u32 = FileIO::read_u32(file, true);
-  flags_u32 = FileIO::read_u32(file, true);
-
-  // skip resreved bytes if processing x86-64 file
-  if (magicBytes_u32 == 0xFEEDFACF) reserved_u32 = FileIO::read_u32(file, true);
+template <std::endian Order, typename Word>
+void MACHO::parseImage(ByteReader& file) {
+  cpuType_u32 = file.read<uint32_t, Order>();
+  cpuSubtype_u32 = file.read<uint32_t, Order>();
+  fileType_u32 = file.read<uint32_t, Order>();
+  numLoadCommands_u32 = file.read<uint32_t, Order>();
+  sizeOfLoadCommand_u32 = file.read<uint32_t, Order>();
+  flags_u32 = file.read<uint32_t, Order>();
+
+  // skip resreved bytes if processing 64 bit file
+  if constexpr (sizeof(Word) == 8) reserved_u32 = file.read<uint32_t, Order>();
 
   // only LoadCommands of Type segments will be parsed initially, 
   // later code can be expanded for more types.
+  // LC_SEGMENT and LC_SEGMENT_64 differ in address/size width only:
+  // cmd, cmdsize, segname[16], 4 words, then 4 32 bit fields.
+  constexpr uint64_t W = sizeof(Word);
+  constexpr uint64_t segmentSize = 8 + 16 + 4 * W + 16;
+
   for (uint32_t idx = 0; idx < numLoadCommands_u32 ; idx++) {
     LoadCommand lCommand;
     
     // save current offset, to jump to next LoadCommand.
-    uint32_t next_offset = file.tellg();
+    uint64_t next_offset = file.tell();
 
     // for now only scanning LoadCommands of Type 'Segment'.
-    lCommand.setCommand(FileIO::read_u32(file, true));
+    const uint8_t* command = file.read_bytes(4);
+    lCommand.setCommand(ByteReader::decode<uint32_t, Order>(command));
 
     uint32_t commandType = lCommand.getCommandType();
     if (commandType != 1 && commandType != 0x19) break;
 
-    lCommand.setCommandSize(FileIO::read_u32(file, true));
-
-    if (cpuType_u32 == 7) { // x86 Mach file
-      lCommand.setSegmentName(file);
-      lCommand.setVMaddress(FileIO::read_u32(file, true));
-      lCommand.setVMSize(FileIO::read_u32(file, true));
-      lCommand.setFileOffset(FileIO::read_u32(file, true));
-      lCommand.setFileSize(FileIO::read_u32(file, true));
-      lCommand.setMaxProtection(FileIO::read_u32(file, true));
-      lCommand.setInitialProtection(FileIO::read_u32(file, true));
-      lCommand.setNumberOfSections(FileIO::read_u32(file, true));
-      lCommand.setFlags(FileIO::read_u32(file, true));
-    } else if (magicBytes_u32 == 0xFEEDFACF) { // x86-64 mach file
-      lCommand.setSegmentName(file);
-      lCommand.setVMaddress(FileIO::read_u64(file, true));
-      lCommand.setVMSize(FileIO::read_u64(file, true));
-      lCommand.setFileOffset(FileIO::read_u64(file, true));
-      lCommand.setFileSize(FileIO::read_u64(file, true));
-      lCommand.setMaxProtection(FileIO::read_u32(file, true));
-      lCommand.setInitialProtection(FileIO::read_u32(file, true));
-      lCommand.setNumberOfSections(FileIO::read_u32(file, true));
-      lCommand.setFlags(FileIO::read_u32(file, true));
-    }
+    // one bounds check for the rest of the segment command.
+    const uint8_t* segment = file.read_bytes(segmentSize - 4) - 4;
+    lCommand.setCommandSize(ByteReader::decode<uint32_t, Order>(segment + 4));
+    lCommand.setSegmentName(segment + 8);
+    lCommand.setVMaddress(ByteReader::decode<Word, Order>(segment + 24));
+    lCommand.setVMSize(ByteReader::decode<Word, Order>(segment + 24 + W));
+    lCommand.setFileOffset(ByteReader::decode<Word, Order>(segment + 24 + 2 * W));
+    lCommand.setFileSize(ByteReader::decode<Word, Order>(segment + 24 + 3 * W));
+    lCommand.setMaxProtection(ByteReader::decode<uint32_t, Order>(segment + 24 + 4 * W));
+    lCommand.setInitialProtection(ByteReader::decode<uint32_t, Order>(segment + 28 + 4 * W));
+    lCommand.setNumberOfSections(ByteReader::decode<uint32_t, Order>(segment + 32 + 4 * W));
+    lCommand.setFlags(ByteReader::decode<uint32_t, Order>(segment + 36 + 4 * W));
     loadCommand.push_back(lCommand);
 
     // skip to next loadCommand structure 
     next_offset += lCommand.getCommandSize();
-    file.seekg(next_offset);
+    file.seek(next_offset);
   }
   
   numLoadCommands_u32 = loadCommand.size();
   // skip to next LCommand structure and code_signature
-  //file.seekg( (sizeOfLoadCommand_u32 + 0x24) + std::ios::cur); 
+  //file.seek( (sizeOfLoadCommand_u32 + 0x24) + std::ios::cur); 
 
-  mapFlagDefinitions();
 }
 
 
@@ -119,10 +150,10 @@ void LoadCommand::setCommand(uint32_t command) {
 void LoadCommand::setCommandSize(uint32_t size) {
   this->commandSize_u32 = size;
 }
-void LoadCommand::setSegmentName(std::ifstream& file) {
-  char name[16] = {0};
-  file.get(name, 17);
-  this->segmentName = name;
+void LoadCommand::setSegmentName(const uint8_t* field) {
+  // 16 bytes field, NUL padded but not always NUL terminated.
+  const char* name = reinterpret_cast<const char*>(field);
+  this->segmentName.assign(name, strnlen(name, 16));
 }
 void LoadCommand::setVMaddress(uint64_t vm) {
   this->vmAddress_u64 = vm;
@@ -137,7 +168,7 @@ void LoadCommand::setFileSize(uint64_t fileSize) {
   this->fileSize_u64 = fileSize;
 }
 
-uint32_t LoadCommand::getCommandType() {
+uint32_t LoadCommand::getCommandType() const {
   return this->command_u32;
 }
 uint32_t LoadCommand::getCommandSize() const {
@@ -231,160 +262,180 @@ std::vector<LoadCommand> MACHO::getLoadCommand() const {
   return this->loadCommand;
 }
 
-/**
- * @brief Maps bytes definition of flags to specific text strings.
-*/
-void MACHO::mapFlagDefinitions() {
-  using namespace std;
+namespace {
+
+// names of Mach-O header values, shared by every MACHO object. When a value
+// is listed twice the first name is used.
+
+// magic
+constexpr FlagTable magicNames({
+    {0xFEEDFACE, "MACHO_32"},
+    {0xFEEDFACF, "MACHO_64"},
+    {0xCEFAEDFE, "MACHO_32_CIGAM"},
+    {0xCFFAEDFE, "MACHO_64_CIGAM"},
+    {0xCAFEBABE, "MACHO_FAT"},
+    {0xBEBAFECA, "MACHO_FAT_CIGAM"},
+});
+
+// cputype
+constexpr FlagTable cpuTypes({
+    {0x07, "CPU_TYPE_X86"},
+    {0x01000007, "CPU_TYPE_X64"},
+    {0x0C, "CPU_TYPE_ARM"},
+    {0x0100000C, "CPU_TYPE_ARM64"},
+    {0x12, "CPU_TYPE_PPC"},
+});
+
+// filetype
+constexpr FlagTable fileTypes({
+    {0x1, "MACH_OBJECT"},
+    {0x2, "MACH_EXECUTE"},
+    {0x3, "MACH_FVMLIB"},
+    {0x4, "MACH_CORE"},
+    {0x5, "MACH_PRELOAD"},
+    {0x6, "MACH_DYLIB"},
+    {0x7, "MACH_DYLINKER"},
+    {0x8, "MACH_BUNDLE"},
+    {0x9, "MACH_DYLIB_STUB"},
+    {0xA, "MACH_DSYM"},
+    {0xB, "MACH_KEXT_BUNDLE"},
+});
+
+// flags
+constexpr FlagTable headerFlags({
+    {0x1, "MACH_NOUNDEFS"},
+    {0x2, "MACH_INCRLINK"},
+    {0x4, "MACH_DYLDLINK"},
+    {0x8, "MACH_BINDATLOAD"},
+    {0x10, "MACH_PREBOUND"},
+    {0x20, "MACH_SPLIT_SEGS"},
+    {0x40, "MACH_LAZY_INIT"},
+    {0x80, "MACH_TWOLEVEL"},
+    {0x100, "MACH_FORCE_FLAT"},
+    {0x200, "MACH_NOMULTIDEFS"},
+    {0x400, "MACH_NOFIXPREBINDING"},
+    {0x800, "MACH_PREBINDABLE"},
+    {0x1000, "MACH_ALLMODSBOUND"},
+    {0x2000, "MACH_SUBSECTIONS_VIA_SYMBOLS"},
+    {0x4000, "MACH_CANONICAL"},
+    {0x8000, "MACH_WEAK_DEFINES"},
+    {0x10000, "MACH_BINDS_TO_WEAK"},
+    {0x20000, "MACH_ALLOW_STACK_EXECUTION"},
+    {0x40000, "MACH_ROOT_SAFE"},
+    {0x80000, "MACH_SETUID_SAFE"},
+    {0x100000, "MACH_NO_REEXPORTED_DYLIBS"},
+    {0x200000, "MACH_PIE"},
+    {0x400000, "MACH_DEAD_STRIPPABLE_DYLIB"},
+    {0x800000, "MACH_HAS_TLV_DESCRIPTORS"},
+    {0x1000000, "MACH_NO_HEAP_EXECUTION"},
+});
+
+// load command cmd
+constexpr FlagTable loadCommandTypes({
+    {0x1, "SEGMENT"},
+    {0x2, "SYM_TAB"},
+    {0x3, "SYM_SEG"},
+    {0x4, "THREAD"},
+    {0x5, "UNIX_THREAD"},
+    {0x6, "LOAD_FVM_LIB"},
+    {0x7, "ID_FVM_LIB"},
+    {0x8, "IDENT"},
+    {0x9, "FVM_FILE"},
+    {0xA, "PREPAGE"},
+    {0xB, "DY_SYM_TAB"},
+    {0xC, "LOAD_DYLIB"},
+    {0xD, "ID_DYLIB"},
+    {0xE, "LOAD_DYLINKER"},
+    {0xF, "ID_DYLINKER"},
+    {0x10, "PREBOUND_DYLIB"},
+    {0x11, "ROUTINES"},
+    {0x12, "SUB_FRAMEWORK"},
+    {0x13, "SUB_UMBRELLA"},
+    {0x14, "SUB_CLIENT"},
+    {0x15, "SUB_LIBRARY"},
+    {0x16, "TWOLEVEL_HINTS"},
+    {0x17, "PREBIND_CKSUM"},
+    {0x18, "LOAD_WEAK_DYLIB"},
+    {0x19, "SEGMENT_64"},
+    {0x1A, "ROUTINES_64"},
+    {0x1B, "UUID"},
+    {0x1C, "RPATH"},
+    {0x1D, "CODE_SIGNATURE"},
+    {0x1E, "SEGMENT_SPLIT_INFO"},
+    {0x1F, "REEXPORT_DYLIB"},
+    {0x20, "LAZY_LOAD_DYLIB"},
+    {0x21, "ENCRYPTION_INFO"},
+    {0x22, "DYLD_INFO"},
+    {0x22, "DYLD_INFO_ONLY"},
+    {0x23, "LOAD_UPWARD_DYLIB"},
+    {0x24, "VERSION_MIN_MAC_OSX"},
+    {0x25, "VERSION_MIN_IPHONE_OS"},
+    {0x26, "FUNCTION_STARTS"},
+    {0x27, "DYLD_ENVIRONMENT"},
+    {0x28, "MAIN"},
+    {0x28, "MAIN_DYLIB"},
+    {0x29, "DATA_IN_CODE"},
+    {0x2A, "SOURCE_VERSION"},
+    {0x2B, "DYLIB_CODE_SIGN_DRS"},
+    {0x2c, "ENCRYPTION_INFO_64"},
+    {0x32, "LC_BUILD_VERSION"},
+    {0x33, "LC_DYLD_EXPORTS_TRIE"},
+    {0x34, "LC_DYLD_CHAINED_FIXUPS"},
+});
+
+}  // namespace
 
-  magicMap_m.try_emplace(0xFEEDFACE, "MACHO_32");
-  magicMap_m.try_emplace(0xFEEDFACF, "MACHO_64");
-  magicMap_m.try_emplace(0xCAFEBABE, "MACHO_FAT");
-  magicMap_m.try_emplace(0xBEBAFECA, "MACHO_FAT_CIGAM");
-
-  cputType_m.try_emplace(0x07, "CPU_TYPE_X86");
-  cputType_m.try_emplace(0x01000007, "CPU_TYPE_X64");
-  cputType_m.try_emplace(0x0C, "CPU_TYPE_ARM");
-  cputType_m.try_emplace(0x0100000C, "CPU_TYPE_ARM64");
-  cputType_m.try_emplace(0x12, "CPU_TYPE_PPC");
-  
-  headerFileType_m.try_emplace(0x1, "MACH_OBJECT");
-  headerFileType_m.try_emplace(0x2, "MACH_EXECUTE");
-  headerFileType_m.try_emplace(0x3, "MACH_FVMLIB");
-  headerFileType_m.try_emplace(0x4, "MACH_CORE");
-  headerFileType_m.try_emplace(0x5, "MACH_PRELOAD");
-  headerFileType_m.try_emplace(0x6, "MACH_DYLIB");
-  headerFileType_m.try_emplace(0x7, "MACH_DYLINKER");
-  headerFileType_m.try_emplace(0x8, "MACH_BUNDLE");
-  headerFileType_m.try_emplace(0x9, "MACH_DYLIB_STUB");
-  headerFileType_m.try_emplace(0xA, "MACH_DSYM");
-  headerFileType_m.try_emplace(0xB, "MACH_KEXT_BUNDLE");
-
-  headerFlags_m.try_emplace(0x1, "MACH_NOUNDEFS");
-  headerFlags_m.try_emplace(0x2, "MACH_INCRLINK");
-  headerFlags_m.try_emplace(0x4, "MACH_DYLDLINK");
-  headerFlags_m.try_emplace(0x8, "MACH_BINDATLOAD");
-  headerFlags_m.try_emplace(0x10, "MACH_PREBOUND");
-  headerFlags_m.try_emplace(0x20, "MACH_SPLIT_SEGS");
-  headerFlags_m.try_emplace(0x40, "MACH_LAZY_INIT");
-  headerFlags_m.try_emplace(0x80, "MACH_TWOLEVEL");
-  headerFlags_m.try_emplace(0x100, "MACH_FORCE_FLAT");
-  headerFlags_m.try_emplace(0x200, "MACH_NOMULTIDEFS");
-  headerFlags_m.try_emplace(0x400, "MACH_NOFIXPREBINDING");
-  headerFlags_m.try_emplace(0x800, "MACH_PREBINDABLE");
-  headerFlags_m.try_emplace(0x1000, "MACH_ALLMODSBOUND");
-  headerFlags_m.try_emplace(0x2000, "MACH_SUBSECTIONS_VIA_SYMBOLS");
-  headerFlags_m.try_emplace(0x4000, "MACH_CANONICAL");
-  headerFlags_m.try_emplace(0x8000, "MACH_WEAK_DEFINES");
-  headerFlags_m.try_emplace(0x10000, "MACH_BINDS_TO_WEAK");
-  headerFlags_m.try_emplace(0x20000, "MACH_ALLOW_STACK_EXECUTION");
-  headerFlags_m.try_emplace(0x40000, "MACH_ROOT_SAFE");
-  headerFlags_m.try_emplace(0x80000, "MACH_SETUID_SAFE");
-  headerFlags_m.try_emplace(0x100000, "MACH_NO_REEXPORTED_DYLIBS");
-  headerFlags_m.try_emplace(0x200000, "MACH_PIE");
-  headerFlags_m.try_emplace(0x400000, "MACH_DEAD_STRIPPABLE_DYLIB");
-  headerFlags_m.try_emplace(0x800000, "MACH_HAS_TLV_DESCRIPTORS");
-  headerFlags_m.try_emplace(0x1000000, "MACH_NO_HEAP_EXECUTION");
-  
-
-  loadCommandType_m.try_emplace(0x1, "SEGMENT");
-  loadCommandType_m.try_emplace(0x2, "SYM_TAB");
-  loadCommandType_m.try_emplace(0x3, "SYM_SEG");
-  loadCommandType_m.try_emplace(0x4, "THREAD");
-  loadCommandType_m.try_emplace(0x5, "UNIX_THREAD");
-  loadCommandType_m.try_emplace(0x6, "LOAD_FVM_LIB");
-  loadCommandType_m.try_emplace(0x7, "ID_FVM_LIB");
-  loadCommandType_m.try_emplace(0x8, "IDENT");
-  loadCommandType_m.try_emplace(0x9, "FVM_FILE");
-  loadCommandType_m.try_emplace(0xA, "PREPAGE");
-  loadCommandType_m.try_emplace(0xB, "DY_SYM_TAB");
-  loadCommandType_m.try_emplace(0xC, "LOAD_DYLIB");
-  loadCommandType_m.try_emplace(0xD, "ID_DYLIB");
-  loadCommandType_m.try_emplace(0xE, "LOAD_DYLINKER");
-  loadCommandType_m.try_emplace(0xF, "ID_DYLINKER");
-  loadCommandType_m.try_emplace(0x10, "PREBOUND_DYLIB");
-  loadCommandType_m.try_emplace(0x11, "ROUTINES");
-  loadCommandType_m.try_emplace(0x12, "SUB_FRAMEWORK");
-  loadCommandType_m.try_emplace(0x13, "SUB_UMBRELLA");
-  loadCommandType_m.try_emplace(0x14, "SUB_CLIENT");
-  loadCommandType_m.try_emplace(0x15, "SUB_LIBRARY");
-  loadCommandType_m.try_emplace(0x16, "TWOLEVEL_HINTS");
-  loadCommandType_m.try_emplace(0x17, "PREBIND_CKSUM");
-  loadCommandType_m.try_emplace(0x18, "LOAD_WEAK_DYLIB");
-  loadCommandType_m.try_emplace(0x19, "SEGMENT_64");
-  loadCommandType_m.try_emplace(0x1A, "ROUTINES_64");
-  loadCommandType_m.try_emplace(0x1B, "UUID");
-  loadCommandType_m.try_emplace(0x1C, "RPATH");
-  loadCommandType_m.try_emplace(0x1D, "CODE_SIGNATURE");
-  loadCommandType_m.try_emplace(0x1E, "SEGMENT_SPLIT_INFO");
-  loadCommandType_m.try_emplace(0x1F, "REEXPORT_DYLIB");
-  loadCommandType_m.try_emplace(0x20, "LAZY_LOAD_DYLIB");
-  loadCommandType_m.try_emplace(0x21, "ENCRYPTION_INFO");
-  loadCommandType_m.try_emplace(0x22, "DYLD_INFO");
-  loadCommandType_m.try_emplace(0x22, "DYLD_INFO_ONLY");
-  loadCommandType_m.try_emplace(0x23, "LOAD_UPWARD_DYLIB");
-  loadCommandType_m.try_emplace(0x24, "VERSION_MIN_MAC_OSX");
-  loadCommandType_m.try_emplace(0x25, "VERSION_MIN_IPHONE_OS");
-  loadCommandType_m.try_emplace(0x26, "FUNCTION_STARTS");
-  loadCommandType_m.try_emplace(0x27, "DYLD_ENVIRONMENT");
-  loadCommandType_m.try_emplace(0x28, "MAIN");
-  loadCommandType_m.try_emplace(0x28, "MAIN_DYLIB");
-  loadCommandType_m.try_emplace(0x29, "DATA_IN_CODE");
-  loadCommandType_m.try_emplace(0x2A, "SOURCE_VERSION");
-  loadCommandType_m.try_emplace(0x2B, "DYLIB_CODE_SIGN_DRS");
-  loadCommandType_m.try_emplace(0x2c, "ENCRYPTION_INFO_64");
-  loadCommandType_m.try_emplace(0x32, "LC_BUILD_VERSION");
-  loadCommandType_m.try_emplace(0x33, "LC_DYLD_EXPORTS_TRIE");
-  loadCommandType_m.try_emplace(0x34, "LC_DYLD_CHAINED_FIXUPS");
-}
 
 /**
  * @brief Prints string information of flag bytes, based on its type or value.
  * 
+ * @param out The buffer to print to.
  * @param flag A value indicating the type of mapped flag to be read.
  * @param value A value of specific mapped item to be read and printed.
  * 
  * @return None.
 */
-void MACHO::printFlag(uint32_t flag, uint32_t value) {
+void MACHO::printFlag(OutputBuffer& out, uint32_t flag, uint32_t value) const {
     if (flag == magictypes)
-      std::cout << magicMap_m[magicBytes_u32] << std::endl;
+      out << magicNames.find(magicBytes_u32) << std::endl;
   else if (flag == cputypes)
-      std::cout << cputType_m[cpuType_u32] << std::endl;
+      out << cpuTypes.find(cpuType_u32) << std::endl;
   else if (flag == headerfiltype)
-      std::cout << headerFileType_m[fileType_u32] << std::endl;
+      out << fileTypes.find(fileType_u32) << std::endl;
   else if (flag == headerflags)
-      std::cout << this->headerFlags_m[flags_u32] << std::endl;
+      out << headerFlags.find(flags_u32) << std::endl;
   else if (flag == loadcommandtype)
-      std::cout << this->loadCommandType_m[value] << std::endl;
+      out << loadCommandTypes.find(value) << std::endl;
 }
 
 /**
  * @brief Prints information read from a Mach-O file.
+ *
+ * @param out The buffer to print to.
 */
-void MACHO::printMach() {
+void MACHO::printMach(OutputBuffer& out) const {
   using namespace std;
 
-  cout << "Mach-O File: \n";
-  cout << "  Magic bytes: \t0x" << hex << this->getMagicBytes() << " ";
-  printFlag(magictypes, 0);
-  cout << "  CPU type:    \t0x" << hex << this->getCputType() << " ";
-  printFlag(cputypes, 0);
-  cout << "  CPU subtype: \t 0x" << hex << this->getCpuSubType() << endl;
-  cout << "  File type:   \t 0x" << hex << this->getFileType() << " ";
-  printFlag(headerfiltype, 0);
-  cout << "  Number of load commands: \t0x" << hex << this->getNumLoadCommands() << endl;
-  cout << "  Size of Load commands:   \t0x" << hex << this->getSizeOfLoadCommand() << endl << endl;
+  out << "Mach-O File: \n";
+  out << "  Magic bytes: \t0x" << hex << this->getMagicBytes() << " ";
+  printFlag(out, magictypes, 0);
+  out << "  CPU type:    \t0x" << hex << this->getCputType() << " ";
+  printFlag(out, cputypes, 0);
+  out << "  CPU subtype: \t 0x" << hex << this->getCpuSubType() << endl;
+  out << "  File type:   \t 0x" << hex << this->getFileType() << " ";
+  printFlag(out, headerfiltype, 0);
+  out << "  Number of load commands: \t0x" << hex << this->getNumLoadCommands() << endl;
+  out << "  Size of Load commands:   \t0x" << hex << this->getSizeOfLoadCommand() << endl << endl;
 
   for(uint32_t idx = 0; idx < numLoadCommands_u32 ; idx++) { 
-    cout << " command type: \t" << " ";
-    printFlag(loadcommandtype, loadCommand[idx].getCommandType());
-    cout << " command size: \t0x" << hex << loadCommand[idx].getCommandSize() << endl;
-    cout << " segment name: \t" << loadCommand[idx].getSegmentName() << endl;
-    cout << " VM Address:   \t0x" << hex << loadCommand[idx].getVMaddress() << endl;
-    cout << " VM Size:      \t0x" << hex <<  loadCommand[idx].getVMSize() << endl;
-    cout << " file offset:  \t0x" << hex << loadCommand[idx].getFileOffset() << endl;
-    cout << " file size:    \t0x" << hex << loadCommand[idx].getFileSize() << endl << endl;
+    out << " command type: \t" << " ";
+    printFlag(out, loadcommandtype, loadCommand[idx].getCommandType());
+    out << " command size: \t0x" << hex << loadCommand[idx].getCommandSize() << endl;
+    out << " segment name: \t" << loadCommand[idx].getSegmentName() << endl;
+    out << " VM Address:   \t0x" << hex << loadCommand[idx].getVMaddress() << endl;
+    out << " VM Size:      \t0x" << hex <<  loadCommand[idx].getVMSize() << endl;
+    out << " file offset:  \t0x" << hex << loadCommand[idx].getFileOffset() << endl;
+    out << " file size:    \t0x" << hex << loadCommand[idx].getFileSize() << endl << endl;
   }
 
     //  code directory info
@@ -35,7 +35,7 @@ class LoadCommand {
  public:
   void setCommand(uint32_t);
   void setCommandSize(uint32_t);
-  void setSegmentName(std::ifstream&);
+  void setSegmentName(const uint8_t*);
   void setVMaddress(uint64_t);
   void setVMSize(uint64_t);
   void setFileOffset(uint64_t);
@@ -45,7 +45,7 @@ class LoadCommand {
   void setNumberOfSections(uint32_t);
   void setFlags(uint32_t);
 
-  uint32_t getCommandType();
+  uint32_t getCommandType() const;
   uint32_t getCommandSize() const;
   std::string getSegmentName() const;
   uint64_t getVMaddress() const;
@@ -93,8 +93,10 @@ class MACHO {
   MACHO(const std::string&);
 
   void init(const std::string&);
-  void parseX86_macho(std::ifstream&);
-  void parseUniMacho(std::ifstream&);
+  void init(std::span<const std::byte>, uint64_t = 0);
+  void parse(ByteReader&);
+  template <std::endian Order, typename Word> void parseImage(ByteReader&);
+  void parseUniMacho(ByteReader&);
 
   void setMagicBytes(uint32_t);
   void setCputType(uint32_t);
@@ -102,9 +104,8 @@ class MACHO {
   void setFileType(uint32_t);
   void setNumLoadCommands(uint32_t);
   void setSizeOfLoadCommand(uint32_t);
-  void mapFlagDefinitions();
-  void printFlag(uint32_t, u_int32_t);
-  void printMach();
+  void printFlag(OutputBuffer&, uint32_t, u_int32_t) const;
+  void printMach(OutputBuffer&) const;
 
   uint32_t getMagicBytes() const;
   uint32_t getCputType() const;
@@ -125,16 +126,8 @@ class MACHO {
   uint32_t sizeOfLoadCommand_u32;
   uint32_t flags_u32;
   uint32_t reserved_u32; // x64 specific
-  
-  
-  
-  std::vector<LoadCommand> loadCommand; 
 
-  std::map<uint32_t, std::string> magicMap_m;
-  std::map<uint32_t, std::string> cputType_m;
-  std::map<uint32_t, std::string> headerFileType_m;
-  std::map<uint32_t, std::string> headerFlags_m;
-  std::map<uint32_t, std::string> loadCommandType_m;
+  std::vector<LoadCommand> loadCommand; 
 
   enum MachMaps { magictypes = 0,
                   cputypes = 1,
@@ -0,0 +1,139 @@
+/**
+ * @file mapped_file.cpp
+ * @brief  Maps a file into memory, falling back to pread when mmap fails.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Opens and maps a file, see MappedFile::open().
+ *
+ * @param filename name of the file to be mapped.
+ */
+MappedFile::MappedFile(const std::string& filename) {
+  open(filename);
+}
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+/**
+ * @brief Same as tryOpen(), throwing the error.
+ *
+ * @param filename name of the file to be opened.
+ *
+ * @return none. throws std::runtime_error if the file can't be opened or read.
+ */
+void MappedFile::open(const std::string& filename) {
+  Error error = tryOpen(filename);
+  if (error) error.raise();
+}
+
+/**
+ * @brief Makes the whole content of a file available through data()/size().
+ * Regular files are mapped read-only. If mapping isn't possible the content
+ * is read with pread (or read for non-seekable files) into a private buffer.
+ *
+ * @param filename name of the file to be opened.
+ *
+ * @return an IO_ERROR if the file can't be opened or read, no error
+ * otherwise.
+ */
+Error MappedFile::tryOpen(const std::string& filename) {
+  close();
+
+  int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return Error(ErrorCode::IO_ERROR, "Could not open file: " + filename);
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    ::close(fd);
+    return Error(ErrorCode::IO_ERROR, "Could not stat file: " + filename);
+  }
+
+  bool regular = S_ISREG(info.st_mode);
+  uint64_t length = regular ? static_cast<uint64_t>(info.st_size) : 0;
+
+  // an empty file can't be mapped, there is nothing to read either.
+  if (regular && length > 0) {
+    void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED) {
+      data_p = static_cast<const uint8_t*>(addr);
+      size_u64 = length;
+      mapped = true;
+    }
+  }
+
+  if (!mapped && (length > 0 || !regular) &&
+      !readFallback(fd, length, regular)) {
+    ::close(fd);
+    close();
+    return Error(ErrorCode::IO_ERROR, "Could not read file");
+  }
+
+  // a mapping stays valid after its descriptor is closed.
+  ::close(fd);
+  return Error();
+}
+
+/**
+ * @brief Reads the file content into the private buffer.
+ *
+ * @param fd an open file descriptor.
+ * @param length expected size for regular files, ignored otherwise.
+ * @param seekable whether pread can be used on the descriptor.
+ *
+ * @return false on read errors.
+ */
+bool MappedFile::readFallback(int fd, uint64_t length, bool seekable) {
+  if (seekable) {
+    buffer.resize(length);
+    uint64_t done = 0;
+    while (done < length) {
+      ssize_t got = pread(fd, buffer.data() + done, length - done, done);
+      if (got < 0) return false;
+      if (got == 0) break;  // file shrunk while reading
+      done += got;
+    }
+    buffer.resize(done);
+  } else {
+    // pipes and character devices, size is unknown until EOF.
+    uint8_t chunk[64 * 1024];
+    while (true) {
+      ssize_t got = read(fd, chunk, sizeof(chunk));
+      if (got < 0) return false;
+      if (got == 0) break;
+      buffer.insert(buffer.end(), chunk, chunk + got);
+    }
+  }
+  data_p = buffer.data();
+  size_u64 = buffer.size();
+  return true;
+}
+
+/**
+ * @brief Releases the mapping or buffer, data() is null afterwards.
+ *
+ * @return none.
+ */
+void MappedFile::close() {
+  if (mapped) {
+    munmap(const_cast<uint8_t*>(data_p), size_u64);
+  }
+  buffer.clear();
+  buffer.shrink_to_fit();
+  data_p = nullptr;
+  size_u64 = 0;
+  mapped = false;
+}
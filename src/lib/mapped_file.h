@@ -0,0 +1,57 @@
+/**
+ * @file mapped_file.h
+ * @brief  Definitions for MappedFile, a read-only view of a whole file
+ *      backed by mmap, or by a pread buffer when the file can't be mapped.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "result.h"
+
+/**
+ * @brief MappedFile holds the full contents of a file in memory for the
+ * lifetime of the object. Regular files are mapped read-only, anything else
+ * (pipes, special files, or a failed mmap) is read into a private buffer.
+ */
+class MappedFile {
+ public:
+  // disabling move/copy constructors
+  MappedFile(MappedFile&) = delete;
+  MappedFile(MappedFile&&) = delete;
+  MappedFile& operator=(MappedFile&) = delete;
+
+  MappedFile() = default;
+  explicit MappedFile(const std::string&);
+  ~MappedFile();
+
+  void open(const std::string&);
+  Error tryOpen(const std::string&);
+  void close();
+
+  const uint8_t* data() const { return data_p; }
+  uint64_t size() const { return size_u64; }
+  std::span<const std::byte> bytes() const {
+    return {reinterpret_cast<const std::byte*>(data_p), size_t(size_u64)};
+  }
+  bool isMapped() const { return mapped; }
+
+ private:
+  bool readFallback(int, uint64_t, bool);
+
+  const uint8_t* data_p = nullptr;
+  uint64_t size_u64 = 0;
+  bool mapped = false;
+  std::vector<uint8_t> buffer;
+};
+
+#endif
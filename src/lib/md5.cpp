@@ -18,8 +18,9 @@
    with Sun's original "cc". */
 
 #include <memory.h>    /* for memcpy() */
-#include <sstream>
 #include "md5.h"
+#include "hex.h"
+#include "multi_hasher.h"
 
 #ifndef HIGHFIRST
 #define byteReverse(buf, len) /* Nothing */
@@ -60,7 +61,7 @@ void MD5Hasher::MD5Init() {
  * @brief Update context to reflect the concatenation of another buffer full
  * of bytes.
  */
-void MD5Hasher::MD5Update(unsigned char *buf, unsigned len) {
+void MD5Hasher::MD5Update(const unsigned char *buf, unsigned len) {
   uint32 t;
   uint32 lenp;
   /* Update bitcount */
@@ -107,14 +108,34 @@ void MD5Hasher::MD5Update(unsigned char *buf, unsigned len) {
   memcpy(ctx.in, buf, len);
 }
 
+/**
+ * @brief Adds a buffer of any size, MD5Update() takes at most 4 GB at a
+ * time so larger spans are fed in pieces.
+ */
+void MD5Hasher::update(std::span<const std::byte> data) {
+  const unsigned char *buf =
+      reinterpret_cast<const unsigned char *>(data.data());
+  size_t len = data.size();
+  const size_t maxChunk = size_t(1) << 30;
+
+  while (len > 0) {
+    size_t chunk = len < maxChunk ? len : maxChunk;
+    MD5Update(buf, unsigned(chunk));
+    buf += chunk;
+    len -= chunk;
+  }
+}
+
 /**
  * @brief Final wrapup - pad to 64-byte boundary with the bit pattern
  * 1 0* (64-bit count of bits processed, MSB-first)
+ *
+ * @return the raw 16 byte digest.
  */
-std::string MD5Hasher::MD5Final() {
+MD5Hasher::Digest MD5Hasher::finalDigest() {
   unsigned count;
   unsigned char *p;
-  unsigned char digest[16];
+  Digest digest;
 
   /* Compute number of bytes mod 64 */
   count = (ctx.bits[0] >> 3) & 0x3F;
@@ -148,16 +169,17 @@ std::string MD5Hasher::MD5Final() {
 
   MD5Transform(ctx.buf, reinterpret_cast<uint32 *>(ctx.in));
   byteReverse((unsigned char *) ctx.buf, 4);
-  memcpy(digest, ctx.buf, 16);
+  memcpy(digest.data(), ctx.buf, 16);
   memset(&ctx, 0, sizeof(ctx));        /* In case it's sensitive */
 
-  std::stringstream ss;
-  for (int i = 0; i < 16; i++) {
-    ss << std::setfill('0') <<
-       std::setw(2) << std::hex << static_cast<int>(digest[i]);
-  }
+  return digest;
+}
 
-  return ss.str();
+/**
+ * @brief Same as finalDigest(), formatted as lowercase hex.
+ */
+std::string MD5Hasher::MD5Final() {
+  return Hex::toString(finalDigest());
 }
 
 
@@ -269,28 +291,16 @@ void MD5Hasher::MD5Transform(uint32 buf[4], uint32 in[16]) {
  * @return Returns 0 when it succeeds or -1 if it fails to read the file.
 */
 int MD5Hasher::MD5FileContent(const std::string &file, std::string &md5) {
-  FILE *fp;
-  char bytesBuffer[1024];
-  MD5Hasher hasher;
-
-  fp = fopen(file.c_str(), "rb");
+  MultiHasher hasher(MultiHasher::MD5_DIGEST);
 
-  if ( fp == NULL )
+  try {
+    hasher.updateFile(file);
+  } catch (std::runtime_error&) {
     return -1;
-
-  hasher.MD5Init();
-
-  while ( !feof(fp) ) {
-    size_t read = fread(bytesBuffer, 1, sizeof(bytesBuffer), fp);
-
-    if ( read == 0 ) {
-      break;
-    } else {
-      hasher.MD5Update((unsigned char*)bytesBuffer, read);
-    }
   }
 
-  md5 = hasher.MD5Final();
+  hasher.final();
+  md5 = hasher.getMD5();
 
   return 0;
 }
@@ -6,9 +6,11 @@
 #define MD5_H
 
 #include <stdint.h>
+#include <array>
+#include <cstddef>
 #include <cstring>
+#include <span>
 #include <string>
-#include <iomanip>
 
 /*  The following tests optimise behaviour on little-endian
     machines, where there is no need to reverse the byte order
@@ -53,8 +55,12 @@ public:
   }
   ~MD5Hasher() =default;
 
+  typedef std::array<uint8_t, 16> Digest;
+
   void MD5Init();
-  void MD5Update(unsigned char *buf, unsigned len);
+  void MD5Update(const unsigned char *buf, unsigned len);
+  void update(std::span<const std::byte> data);
+  Digest finalDigest();
   std::string MD5Final();
 
   int MD5FileContent(const std::string &file, std::string &md5);
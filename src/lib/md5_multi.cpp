@@ -0,0 +1,325 @@
+/**
+ * @file md5_multi.cpp
+ * @brief  Multi-buffer MD5: the same round function runs on 4 (SSE2),
+ *      8 (AVX2) or 16 (AVX-512) independent messages at once.
+ *
+ * The rounds are written once with GCC vector types and instantiated in
+ * functions carrying the matching target attribute, so the rest of the
+ * program keeps the default instruction set.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "../headers.h"
+
+#include <utility>
+
+namespace {
+
+typedef uint32_t Vector4 __attribute__((vector_size(16)));
+typedef uint32_t Vector8 __attribute__((vector_size(32)));
+typedef uint32_t Vector16 __attribute__((vector_size(64)));
+
+constexpr uint32_t roundConstants[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a,
+    0xa8304613, 0xfd469501, 0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+    0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821, 0xf61e2562, 0xc040b340,
+    0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8,
+    0x676f02d9, 0x8d2a4c8a, 0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+    0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70, 0x289b7ec6, 0xeaa127fa,
+    0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92,
+    0xffeff47d, 0x85845dd1, 0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+    0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+
+constexpr int shifts[4][4] = {
+    {7, 12, 17, 22}, {5, 9, 14, 20}, {4, 11, 16, 23}, {6, 10, 15, 21}};
+
+constexpr uint32_t initialState[4] = {0x67452301, 0xefcdab89, 0x98badcfe,
+                                      0x10325476};
+
+/**
+ * @brief One MD5 step for every lane. The four state words trade places
+ * each step, so they are picked from 'v' by step number.
+ */
+template <int I, typename V>
+[[gnu::always_inline]] inline void md5Step(V (&v)[4], const V (&m)[16]) {
+  constexpr int round = I / 16;
+  constexpr int index = round == 0   ? I
+                        : round == 1 ? (5 * I + 1) % 16
+                        : round == 2 ? (3 * I + 5) % 16
+                                     : (7 * I) % 16;
+  constexpr int shift = shifts[round][I % 4];
+
+  V& a = v[(4 - I % 4) % 4];
+  const V& b = v[(5 - I % 4) % 4];
+  const V& c = v[(6 - I % 4) % 4];
+  const V& d = v[(7 - I % 4) % 4];
+
+  V f;
+  if constexpr (round == 0) {
+    f = d ^ (b & (c ^ d));
+  } else if constexpr (round == 1) {
+    f = c ^ (d & (b ^ c));
+  } else if constexpr (round == 2) {
+    f = b ^ c ^ d;
+  } else {
+    f = c ^ (b | ~d);
+  }
+  a += f + m[index] + roundConstants[I];
+  a = ((a << shift) | (a >> (32 - shift))) + b;
+}
+
+template <typename V, int... I>
+[[gnu::always_inline]] inline void md5Rounds(V (&v)[4], const V (&m)[16],
+                                             std::integer_sequence<int, I...>) {
+  (md5Step<I>(v, m), ...);
+}
+
+/**
+ * @brief Where a lane is in its current message: whole blocks are read in
+ * place, the last partial block and the padding come from 'tail'.
+ */
+struct Lane {
+  size_t input = 0;
+  const uint8_t* data = nullptr;
+  uint64_t blocks = 0;
+  uint8_t tail[128];
+  uint32_t tailBlocks = 0;
+  uint32_t tailIndex = 0;
+  bool active = false;
+
+  void begin(size_t index, std::span<const std::byte> content) {
+    input = index;
+    data = reinterpret_cast<const uint8_t*>(content.data());
+    blocks = content.size() / 64;
+
+    uint64_t rest = content.size() % 64;
+    uint64_t bits = uint64_t(content.size()) * 8;
+    memset(tail, 0, sizeof(tail));
+    if (rest > 0) memcpy(tail, data + blocks * 64, rest);
+    tail[rest] = 0x80;
+    tailBlocks = rest < 56 ? 1 : 2;
+    for (int i = 0; i < 8; i++) {
+      tail[tailBlocks * 64 - 8 + i] = uint8_t(bits >> (8 * i));
+    }
+    tailIndex = 0;
+    active = true;
+  }
+
+  const uint8_t* current() const {
+    return blocks > 0 ? data : tail + 64 * tailIndex;
+  }
+
+  // moves to the next block, returns true once the message is done.
+  bool advance() {
+    if (blocks > 0) {
+      data += 64;
+      blocks--;
+      return false;
+    }
+    return ++tailIndex == tailBlocks;
+  }
+};
+
+/**
+ * @brief Runs every input through L lanes of vector type V. Each pass
+ * gathers one block per lane into a transposed buffer (word i of all
+ * lanes side by side), runs the 64 steps and moves the lanes on; lanes
+ * without work hash a zero block that is thrown away.
+ */
+template <typename V, size_t L>
+[[gnu::always_inline]] inline void hashLanes(
+    const std::vector<std::span<const std::byte>>& inputs,
+    std::vector<std::string>& digests) {
+  static const uint8_t zeros[64] = {};
+  Lane lanes[L];
+  alignas(64) uint32_t state[4][L];
+  alignas(64) uint32_t words[16][L];
+  size_t nextInput = 0;
+  size_t active = 0;
+
+  auto start = [&](size_t lane) {
+    if (nextInput == inputs.size()) {
+      lanes[lane].active = false;
+      return false;
+    }
+    lanes[lane].begin(nextInput, inputs[nextInput]);
+    nextInput++;
+    for (int word = 0; word < 4; word++) {
+      state[word][lane] = initialState[word];
+    }
+    return true;
+  };
+
+  for (size_t lane = 0; lane < L; lane++) {
+    if (start(lane)) active++;
+  }
+
+  while (active > 0) {
+    for (size_t lane = 0; lane < L; lane++) {
+      const uint8_t* block =
+          lanes[lane].active ? lanes[lane].current() : zeros;
+      for (int word = 0; word < 16; word++) {
+        memcpy(&words[word][lane], block + 4 * word, 4);
+      }
+    }
+
+    V v[4], saved[4], m[16];
+    for (int word = 0; word < 16; word++) {
+      memcpy(&m[word], words[word], sizeof(V));
+    }
+    for (int word = 0; word < 4; word++) {
+      memcpy(&v[word], state[word], sizeof(V));
+      saved[word] = v[word];
+    }
+    md5Rounds(v, m, std::make_integer_sequence<int, 64>());
+    for (int word = 0; word < 4; word++) {
+      v[word] += saved[word];
+      memcpy(state[word], &v[word], sizeof(V));
+    }
+
+    for (size_t lane = 0; lane < L; lane++) {
+      if (!lanes[lane].active || !lanes[lane].advance()) continue;
+
+      MD5Hasher::Digest digest;
+      for (int word = 0; word < 4; word++) {
+        for (int byte = 0; byte < 4; byte++) {
+          digest[4 * word + byte] = uint8_t(state[word][lane] >> (8 * byte));
+        }
+      }
+      digests[lanes[lane].input] = Hex::toString(digest);
+      if (!start(lane)) active--;
+    }
+  }
+}
+
+}  // namespace
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("sse2"), flatten)) void MD5MultiBuffer::hashSse2(
+    const std::vector<std::span<const std::byte>>& inputs,
+    std::vector<std::string>& digests) {
+  hashLanes<Vector4, 4>(inputs, digests);
+}
+
+__attribute__((target("avx2"), flatten)) void MD5MultiBuffer::hashAvx2(
+    const std::vector<std::span<const std::byte>>& inputs,
+    std::vector<std::string>& digests) {
+  hashLanes<Vector8, 8>(inputs, digests);
+}
+
+__attribute__((target("avx512f"), flatten)) void MD5MultiBuffer::hashAvx512(
+    const std::vector<std::span<const std::byte>>& inputs,
+    std::vector<std::string>& digests) {
+  hashLanes<Vector16, 16>(inputs, digests);
+}
+
+#else
+
+void MD5MultiBuffer::hashSse2(
+    const std::vector<std::span<const std::byte>>& inputs,
+    std::vector<std::string>& digests) {
+  hashLanes<Vector4, 4>(inputs, digests);
+}
+
+void MD5MultiBuffer::hashAvx2(
+    const std::vector<std::span<const std::byte>>& inputs,
+    std::vector<std::string>& digests) {
+  hashLanes<Vector8, 8>(inputs, digests);
+}
+
+void MD5MultiBuffer::hashAvx512(
+    const std::vector<std::span<const std::byte>>& inputs,
+    std::vector<std::string>& digests) {
+  hashLanes<Vector16, 16>(inputs, digests);
+}
+
+#endif
+
+/**
+ * @brief Returns the widest lane count the CPU supports, checked once.
+ *
+ * @return an implementation, SCALAR on CPUs without usable vectors.
+ */
+MD5MultiBuffer::implementation MD5MultiBuffer::bestImplementation() {
+  static const implementation best = isSupported(AVX512) ? AVX512
+                                     : isSupported(AVX2) ? AVX2
+                                     : isSupported(SSE2) ? SSE2
+                                                         : SCALAR;
+  return best;
+}
+
+/**
+ * @brief Tells whether an implementation can run on this CPU.
+ *
+ * @param impl the implementation.
+ *
+ * @return true if it can be used.
+ */
+bool MD5MultiBuffer::isSupported(implementation impl) {
+  const CpuFeatures& cpu = CpuFeatures::get();
+  switch (impl) {
+    case SCALAR:
+      return true;
+    case SSE2:
+      return cpu.sse2;
+    case AVX2:
+      return cpu.avx2;
+    case AVX512:
+      return cpu.avx512f;
+  }
+  return false;
+}
+
+/**
+ * @brief Hashes every input with the widest implementation available.
+ *
+ * @param inputs the messages, each one is hashed on its own.
+ *
+ * @return one MD5 hex string per input, in the same order.
+ */
+std::vector<std::string> MD5MultiBuffer::hash(
+    const std::vector<std::span<const std::byte>>& inputs) {
+  return hash(inputs, bestImplementation());
+}
+
+/**
+ * @brief Hashes every input with a given implementation, falling back to
+ * one message at a time when it isn't supported or there's a single input.
+ *
+ * @param inputs the messages, each one is hashed on its own.
+ * @param impl the implementation to use.
+ *
+ * @return one MD5 hex string per input, in the same order.
+ */
+std::vector<std::string> MD5MultiBuffer::hash(
+    const std::vector<std::span<const std::byte>>& inputs,
+    implementation impl) {
+  std::vector<std::string> digests(inputs.size());
+  if (!isSupported(impl) || inputs.size() < 2) impl = SCALAR;
+
+  switch (impl) {
+    case SSE2:
+      hashSse2(inputs, digests);
+      break;
+    case AVX2:
+      hashAvx2(inputs, digests);
+      break;
+    case AVX512:
+      hashAvx512(inputs, digests);
+      break;
+    case SCALAR:
+      for (size_t idx = 0; idx < inputs.size(); idx++) {
+        MD5Hasher md5;
+        md5.MD5Init();
+        md5.update(inputs[idx]);
+        digests[idx] = md5.MD5Final();
+      }
+      break;
+  }
+  return digests;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file md5_multi.h
+ * @brief  Definitions for MD5MultiBuffer, which hashes many independent
+ *      inputs at once, one per SIMD lane.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef MD5_MULTI_H
+#define MD5_MULTI_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief MD5 can't be split inside one message, every block depends on the
+ * previous one. MD5MultiBuffer instead runs the rounds of 4, 8 or 16
+ * messages side by side, each in its own 32 bit lane of a vector register.
+ * When a message ends its lane picks up the next input, so inputs of
+ * different sizes keep the lanes busy. Results use the same lowercase hex
+ * format as MD5Hasher::MD5Final().
+ */
+class MD5MultiBuffer {
+ public:
+  // the value of each implementation is its number of lanes.
+  enum implementation { SCALAR = 1, SSE2 = 4, AVX2 = 8, AVX512 = 16 };
+
+  static std::vector<std::string> hash(
+      const std::vector<std::span<const std::byte>>&);
+  static std::vector<std::string> hash(
+      const std::vector<std::span<const std::byte>>&, implementation);
+
+  static implementation bestImplementation();
+  static bool isSupported(implementation);
+
+ private:
+  static void hashSse2(const std::vector<std::span<const std::byte>>&,
+                       std::vector<std::string>&);
+  static void hashAvx2(const std::vector<std::span<const std::byte>>&,
+                       std::vector<std::string>&);
+  static void hashAvx512(const std::vector<std::span<const std::byte>>&,
+                         std::vector<std::string>&);
+};
+
+#endif
@@ -0,0 +1,246 @@
+/**
+ * @file multi_hasher.cpp
+ * @brief  Computes MD5, SHA-1, SHA-256, CRC32C and the Authenticode
+ *      digests of a buffer or a file in a single pass.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "../headers.h"
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief Creates a hasher with the given digests enabled.
+ *
+ * @param digests a combination of MultiHasher::digests values.
+ */
+MultiHasher::MultiHasher(uint32_t digests) : enabled(digests) {
+  md5.MD5Init();
+}
+
+/**
+ * @brief Leaves a range of the content out of the Authenticode digests,
+ * the other digests still see it. Ranges have to be given before update()
+ * reaches them.
+ *
+ * @param offset position of the range from the start of the content.
+ * @param size length of the range, nothing is skipped for 0.
+ *
+ * @return none.
+ */
+void MultiHasher::skipForAuthenticode(uint64_t offset, uint64_t size) {
+  if (size == 0) return;
+  auto at = std::upper_bound(gaps.begin(), gaps.end(),
+                             std::make_pair(offset, size));
+  gaps.insert(at, {offset, size});
+}
+
+/**
+ * @brief Adds bytes to every enabled digest. The input is cut in slices
+ * small enough to stay in L1/L2, each slice goes through all digests
+ * before the next one is touched.
+ *
+ * @param content bytes to be hashed, any size.
+ */
+void MultiHasher::update(std::span<const std::byte> content) {
+  while (!content.empty()) {
+    auto slice = content.first(std::min<uint64_t>(content.size(), sliceSize));
+    if (enabled & MD5_DIGEST) md5.update(slice);
+    if (enabled & SHA1_DIGEST) sha1.update(slice);
+    if (enabled & SHA256_DIGEST) sha256.update(slice);
+    if (enabled & CRC32C_DIGEST) crc32c.update(slice);
+    if (enabled & AUTHENTICODE_DIGESTS) updateAuthenticode(slice);
+    position_u64 += slice.size();
+    content = content.subspan(slice.size());
+  }
+}
+
+/**
+ * @brief Adds a slice to the Authenticode digests, leaving out the parts
+ * that fall in a skipped range.
+ *
+ * @param slice bytes starting at position_u64 in the content.
+ *
+ * @return none.
+ */
+void MultiHasher::updateAuthenticode(std::span<const std::byte> slice) {
+  uint64_t at = position_u64;
+  for (const auto& [offset, size] : gaps) {
+    if (offset + size <= at) continue;
+    if (offset >= at + slice.size()) break;
+
+    auto kept = slice.first(offset > at ? offset - at : 0);
+    if (enabled & AUTHENTICODE_SHA1_DIGEST) authenticodeSha1.update(kept);
+    if (enabled & AUTHENTICODE_SHA256_DIGEST) authenticodeSha256.update(kept);
+
+    uint64_t skipped = std::min<uint64_t>(offset + size - at - kept.size(),
+                                          slice.size() - kept.size());
+    slice = slice.subspan(kept.size() + skipped);
+    at += kept.size() + skipped;
+  }
+  if (enabled & AUTHENTICODE_SHA1_DIGEST) authenticodeSha1.update(slice);
+  if (enabled & AUTHENTICODE_SHA256_DIGEST) authenticodeSha256.update(slice);
+}
+
+/**
+ * @brief Reads a file from start to end in readSize blocks and hashes it.
+ * The read buffer is page aligned so the kernel can copy whole pages.
+ *
+ * @param filename name of the file to be hashed.
+ *
+ * @return none. throws std::runtime_error if the file can't be read.
+ */
+void MultiHasher::updateFile(const std::string& filename) {
+  int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open file: " + filename);
+  }
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+  std::unique_ptr<std::byte, decltype(&std::free)> buffer(
+      static_cast<std::byte*>(std::aligned_alloc(4096, readSize)), &std::free);
+  if (!buffer) {
+    ::close(fd);
+    throw std::bad_alloc();
+  }
+
+  while (true) {
+    ssize_t count = ::read(fd, buffer.get(), readSize);
+    if (count < 0 && errno == EINTR) continue;
+    if (count < 0) {
+      ::close(fd);
+      throw std::runtime_error("Could not read file: " + filename);
+    }
+    if (count == 0) break;
+    update({buffer.get(), size_t(count)});
+  }
+  ::close(fd);
+}
+
+/**
+ * @brief Finishes every enabled digest, the results are then available
+ * from getMD5()/getSHA1() or as raw bytes from the *Digest() getters.
+ */
+void MultiHasher::final() {
+  if (enabled & MD5_DIGEST) md5_digest = md5.finalDigest();
+  if (enabled & SHA1_DIGEST) sha1_digest = sha1.finalDigest();
+  if (enabled & SHA256_DIGEST) sha256_digest = sha256.finalDigest();
+  if (enabled & CRC32C_DIGEST) crc32c_value = crc32c.finalValue();
+  if (enabled & AUTHENTICODE_SHA1_DIGEST) {
+    authenticodeSha1_digest = authenticodeSha1.finalDigest();
+  }
+  if (enabled & AUTHENTICODE_SHA256_DIGEST) {
+    authenticodeSha256_digest = authenticodeSha256.finalDigest();
+  }
+  finished = true;
+}
+
+/**
+ * @brief Returns the MD5 digest as hex.
+ *
+ * @return lowercase hex, empty before final() or if MD5 wasn't enabled.
+ */
+std::string MultiHasher::getMD5() const {
+  if (!finished || !(enabled & MD5_DIGEST)) return std::string();
+  return Hex::toString(md5_digest);
+}
+
+/**
+ * @brief Returns the SHA-1 digest as hex.
+ *
+ * @return lowercase hex, empty before final() or if SHA-1 wasn't enabled.
+ */
+std::string MultiHasher::getSHA1() const {
+  if (!finished || !(enabled & SHA1_DIGEST)) return std::string();
+  return Hex::toString(sha1_digest);
+}
+
+/**
+ * @brief Returns the SHA-256 digest as hex.
+ *
+ * @return lowercase hex, empty before final() or if SHA-256 wasn't enabled.
+ */
+std::string MultiHasher::getSHA256() const {
+  if (!finished || !(enabled & SHA256_DIGEST)) return std::string();
+  return Hex::toString(sha256_digest);
+}
+
+/**
+ * @brief Returns the CRC32C as hex.
+ *
+ * @return 8 lowercase hex characters, most significant first, empty
+ * before final() or if CRC32C wasn't enabled.
+ */
+std::string MultiHasher::getCRC32C() const {
+  if (!finished || !(enabled & CRC32C_DIGEST)) return std::string();
+  return CRC32C::toString(crc32c_value);
+}
+
+/**
+ * @brief Returns the Authenticode SHA-1 digest as hex, the value a
+ * SHA-1 signature or catalog entry of a PE file holds.
+ *
+ * @return lowercase hex, empty before final() or if it wasn't enabled.
+ */
+std::string MultiHasher::getAuthenticodeSHA1() const {
+  if (!finished || !(enabled & AUTHENTICODE_SHA1_DIGEST)) return std::string();
+  return Hex::toString(authenticodeSha1_digest);
+}
+
+/**
+ * @brief Returns the Authenticode SHA-256 digest as hex.
+ *
+ * @return lowercase hex, empty before final() or if it wasn't enabled.
+ */
+std::string MultiHasher::getAuthenticodeSHA256() const {
+  if (!finished || !(enabled & AUTHENTICODE_SHA256_DIGEST)) {
+    return std::string();
+  }
+  return Hex::toString(authenticodeSha256_digest);
+}
+
+/**
+ * @brief Turns a comma separated list of digest names ("md5", "sha1",
+ * "sha256", "blake3", "crc32c", "authenticode-sha1", "authenticode-sha256",
+ * "authenticode" for both, "all" or "none") into digests flags.
+ *
+ * @param list the names, e.g. "md5,sha256".
+ *
+ * @return a combination of digests values. throws std::invalid_argument
+ * for unknown names.
+ */
+uint32_t MultiHasher::parseDigests(const std::string& list) {
+  uint32_t selected = 0;
+  std::stringstream names(list);
+  std::string name;
+
+  while (std::getline(names, name, ',')) {
+    if (name == "md5") {
+      selected |= MD5_DIGEST;
+    } else if (name == "sha1") {
+      selected |= SHA1_DIGEST;
+    } else if (name == "sha256") {
+      selected |= SHA256_DIGEST;
+    } else if (name == "blake3") {
+      selected |= BLAKE3_DIGEST;
+    } else if (name == "crc32c") {
+      selected |= CRC32C_DIGEST;
+    } else if (name == "authenticode-sha1") {
+      selected |= AUTHENTICODE_SHA1_DIGEST;
+    } else if (name == "authenticode-sha256") {
+      selected |= AUTHENTICODE_SHA256_DIGEST;
+    } else if (name == "authenticode") {
+      selected |= AUTHENTICODE_DIGESTS;
+    } else if (name == "all") {
+      selected |= ALL_DIGESTS;
+    } else if (name != "none") {
+      throw std::invalid_argument("unknown digest: " + name);
+    }
+  }
+  return selected;
+}
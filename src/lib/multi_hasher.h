@@ -0,0 +1,104 @@
+/**
+ * @file multi_hasher.h
+ * @brief  Definitions for MultiHasher, which computes several digests of
+ *      the same content (MD5, SHA-1, SHA-256, CRC32C, the Authenticode
+ *      digests of a PE file) in one pass over it.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef MULTI_HASHER_H
+#define MULTI_HASHER_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "crc32c.h"
+#include "md5.h"
+#include "sha1.h"
+#include "sha256.h"
+
+/**
+ * @brief MultiHasher feeds every buffer it is given to all enabled digests
+ * before moving on, a slice at a time so the bytes are still in cache when
+ * the second digest reads them. Files are read once, in large page aligned
+ * blocks, instead of once per digest.
+ *
+ * The Authenticode digests see the same bytes minus the ranges given to
+ * skipForAuthenticode(), so a signed PE's image hash comes out of the same
+ * pass as its file hashes.
+ */
+class MultiHasher {
+ public:
+  // disabling move/copy constructors
+  MultiHasher(MultiHasher&) = delete;
+  MultiHasher(MultiHasher&&) = delete;
+  MultiHasher& operator=(MultiHasher&) = delete;
+
+  enum digests { MD5_DIGEST = 1 << 0,
+                 SHA1_DIGEST = 1 << 1,
+                 SHA256_DIGEST = 1 << 2,
+                 BLAKE3_DIGEST = 1 << 3,  // not streamed, see BLAKE3::hash()
+                 CRC32C_DIGEST = 1 << 4,
+                 AUTHENTICODE_SHA1_DIGEST = 1 << 5,    // PE files only
+                 AUTHENTICODE_SHA256_DIGEST = 1 << 6,  // PE files only
+                 AUTHENTICODE_DIGESTS = AUTHENTICODE_SHA1_DIGEST |
+                                        AUTHENTICODE_SHA256_DIGEST,
+                 DEFAULT_DIGESTS = MD5_DIGEST | SHA1_DIGEST,
+                 ALL_DIGESTS = MD5_DIGEST | SHA1_DIGEST | SHA256_DIGEST |
+                               BLAKE3_DIGEST | CRC32C_DIGEST |
+                               AUTHENTICODE_DIGESTS };
+
+  explicit MultiHasher(uint32_t = DEFAULT_DIGESTS);
+  ~MultiHasher() = default;
+
+  void skipForAuthenticode(uint64_t, uint64_t);
+  void update(std::span<const std::byte>);
+  void updateFile(const std::string&);
+  void final();
+
+  std::string getMD5() const;
+  std::string getSHA1() const;
+  std::string getSHA256() const;
+  std::string getCRC32C() const;
+  std::string getAuthenticodeSHA1() const;
+  std::string getAuthenticodeSHA256() const;
+  const MD5Hasher::Digest& getMD5Digest() const { return md5_digest; }
+  const SHA1::Digest& getSHA1Digest() const { return sha1_digest; }
+  const SHA256::Digest& getSHA256Digest() const { return sha256_digest; }
+  uint32_t getCRC32CValue() const { return crc32c_value; }
+
+  static uint32_t parseDigests(const std::string&);
+
+  static constexpr uint64_t readSize = 1 << 20;   // bytes per read()
+  static constexpr uint64_t sliceSize = 1 << 15;  // bytes per digest update
+
+ private:
+  void updateAuthenticode(std::span<const std::byte>);
+
+  uint32_t enabled;
+  MD5Hasher md5;
+  SHA1 sha1;
+  SHA256 sha256;
+  CRC32C crc32c;
+  SHA1 authenticodeSha1;
+  SHA256 authenticodeSha256;
+
+  // {offset, size} left out of the Authenticode digests, in file order
+  std::vector<std::pair<uint64_t, uint64_t>> gaps;
+  uint64_t position_u64 = 0;  // bytes given to update() so far
+
+  bool finished = false;
+  MD5Hasher::Digest md5_digest{};
+  SHA1::Digest sha1_digest{};
+  SHA256::Digest sha256_digest{};
+  uint32_t crc32c_value = 0;
+  SHA1::Digest authenticodeSha1_digest{};
+  SHA256::Digest authenticodeSha256_digest{};
+};
+
+#endif
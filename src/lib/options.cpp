@@ -0,0 +1,198 @@
+/**
+ * @file options.cpp
+ * @brief  Parses command line options.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "../headers.h"
+
+/**
+ * @brief Returns the value of an option given as "--name value",
+ * "--name=value", "-n value" or "-nvalue".
+ *
+ * @param argc number of arguments.
+ * @param argv arguments.
+ * @param idx index of the option, moved past its value.
+ *
+ * @return the value. throws std::invalid_argument if it is missing.
+ */
+static std::string optionValue(int argc, char* argv[], int& idx) {
+  std::string arg = argv[idx];
+  size_t equal = arg.find('=');
+  if (arg.rfind("--", 0) == 0 && equal != std::string::npos) {
+    return arg.substr(equal + 1);
+  }
+  if (arg.rfind("--", 0) != 0 && arg.size() > 2) {
+    return arg.substr(2);
+  }
+  if (idx + 1 >= argc) {
+    throw std::invalid_argument("missing value for " + arg);
+  }
+  return argv[++idx];
+}
+
+/**
+ * @brief Checks whether an argument is a given option, with or without
+ * an attached value ("--name=value" or "-nvalue").
+ */
+static bool isOption(const std::string& arg, const std::string& name) {
+  if (name.size() == 2) return arg.rfind(name, 0) == 0;
+  return arg == name || arg.rfind(name + "=", 0) == 0;
+}
+
+/**
+ * @brief Parses a size in bytes, with an optional K, M or G suffix
+ * (powers of 1024).
+ *
+ * @param value the size, e.g. "4096" or "16M".
+ *
+ * @return the size in bytes. throws std::invalid_argument if it isn't a
+ * size.
+ */
+static uint64_t parseSize(const std::string& value) {
+  size_t end = 0;
+  uint64_t size = 0;
+  try {
+    size = std::stoull(value, &end);
+  } catch (std::exception&) {
+    throw std::invalid_argument("invalid size: " + value);
+  }
+
+  std::string suffix = value.substr(end);
+  int shift = suffix.empty()                      ? 0
+              : suffix == "k" || suffix == "K"    ? 10
+              : suffix == "m" || suffix == "M"    ? 20
+              : suffix == "g" || suffix == "G"    ? 30
+                                                  : -1;
+  if (shift < 0 || value[0] == '-' || size > (UINT64_MAX >> shift)) {
+    throw std::invalid_argument("invalid size: " + value);
+  }
+  return size << shift;
+}
+
+/**
+ * @brief Fills options from the command line. Anything that isn't an
+ * option is a file to parse, "--" ends option parsing.
+ *
+ * @param argc number of arguments.
+ * @param argv arguments, argv[0] is the program name.
+ *
+ * @return none. throws std::invalid_argument on unknown or bad options.
+ */
+void Options::parse(int argc, char* argv[]) {
+  bool onlyPaths = false;
+
+  for (int idx = 1; idx < argc; idx++) {
+    std::string arg = argv[idx];
+
+    if (onlyPaths || arg.empty() || arg[0] != '-') {
+      paths.push_back(arg);
+    } else if (arg == "--") {
+      onlyPaths = true;
+    } else if (arg == "-h" || arg == "--help") {
+      help = true;
+    } else if (isOption(arg, "-j") || isOption(arg, "--jobs")) {
+      std::string value = optionValue(argc, argv, idx);
+      try {
+        jobs = std::stoul(value);
+      } catch (std::exception&) {
+        throw std::invalid_argument("invalid number of jobs: " + value);
+      }
+    } else if (isOption(arg, "-f") || isOption(arg, "--files-from")) {
+      fileLists.push_back(optionValue(argc, argv, idx));
+    } else if (isOption(arg, "--order")) {
+      std::string value = optionValue(argc, argv, idx);
+      if (value == "input") {
+        order = BatchScanner::INPUT_ORDER;
+      } else if (value == "completed") {
+        order = BatchScanner::AS_COMPLETED;
+      } else {
+        throw std::invalid_argument("unknown output order: " + value);
+      }
+    } else if (isOption(arg, "--hash")) {
+      hashPolicy.digests =
+          MultiHasher::parseDigests(optionValue(argc, argv, idx));
+    } else if (isOption(arg, "--hash-formats")) {
+      hashPolicy.formats =
+          HashPolicy::parseFormats(optionValue(argc, argv, idx));
+    } else if (isOption(arg, "--hash-min-size")) {
+      hashPolicy.minSize = parseSize(optionValue(argc, argv, idx));
+    } else if (isOption(arg, "--hash-max-size")) {
+      hashPolicy.maxSize = parseSize(optionValue(argc, argv, idx));
+    } else if (arg == "--dedupe") {
+      dedupe = true;
+    } else if (arg == "--imports") {
+      details |= FileIO::IMPORT_DETAILS;
+    } else if (arg == "--exports") {
+      details |= FileIO::EXPORT_DETAILS;
+    } else if (arg == "-r" || arg == "--recursive") {
+      recursive = true;
+    } else if (isOption(arg, "--include")) {
+      walk.include.push_back(optionValue(argc, argv, idx));
+    } else if (isOption(arg, "--exclude")) {
+      walk.exclude.push_back(optionValue(argc, argv, idx));
+    } else if (isOption(arg, "--symlinks")) {
+      std::string value = optionValue(argc, argv, idx);
+      if (value == "none") {
+        walk.symlinks = WalkOptions::FOLLOW_NONE;
+      } else if (value == "files") {
+        walk.symlinks = WalkOptions::FOLLOW_FILES;
+      } else if (value == "all") {
+        walk.symlinks = WalkOptions::FOLLOW_ALL;
+      } else {
+        throw std::invalid_argument("unknown symlink policy: " + value);
+      }
+    } else if (arg == "-x" || arg == "--one-file-system") {
+      walk.oneFileSystem = true;
+    } else {
+      throw std::invalid_argument("unknown option: " + arg);
+    }
+  }
+}
+
+/**
+ * @brief Prints a short help text.
+ *
+ * @param out stream to print to.
+ * @param program name the program was called with.
+ *
+ * @return none.
+ */
+void Options::printUsage(std::ostream& out, const char* program) {
+  out << "usage: " << program << " [options] file...\n"
+      << "\n"
+      << "  -j, --jobs N            worker threads (default: all cores)\n"
+      << "  -f, --files-from LIST   read file names from LIST, one per line,\n"
+      << "                          '-' reads them from stdin\n"
+      << "      --order ORDER       'input' (default) prints files in the\n"
+      << "                          order given, 'completed' as they finish\n"
+      << "      --hash LIST         digests to print, comma separated: md5,\n"
+      << "                          sha1, sha256, blake3, crc32c,\n"
+      << "                          authenticode-sha1, authenticode-sha256,\n"
+      << "                          authenticode, all or none (default:\n"
+      << "                          md5,sha1)\n"
+      << "      --hash-formats LIST only hash files of these formats, comma\n"
+      << "                          separated: pe, elf, macho, unknown,\n"
+      << "                          executables, all or none (default: all)\n"
+      << "      --hash-min-size N   only hash files of at least N bytes, K, M\n"
+      << "                          and G suffixes are accepted\n"
+      << "      --hash-max-size N   only hash files of at most N bytes\n"
+      << "      --dedupe            files with the same content as an\n"
+      << "                          earlier one are only reported as\n"
+      << "                          its duplicate, earlier in input order\n"
+      << "                          or finished earlier with --order\n"
+      << "                          completed\n"
+      << "      --imports           print the functions PE files import\n"
+      << "      --exports           print the functions PE files export\n"
+      << "  -r, --recursive         walk directories, only files with a PE,\n"
+      << "                          ELF or Mach-O magic are parsed\n"
+      << "      --include GLOB      walk only files matching GLOB\n"
+      << "      --exclude GLOB      skip files and directories matching GLOB\n"
+      << "      --symlinks POLICY   'none' (default) skips links, 'files'\n"
+      << "                          follows links to files, 'all' also\n"
+      << "                          links to directories\n"
+      << "  -x, --one-file-system   don't walk into other file systems\n"
+      << "  -h, --help              show this help\n";
+}
@@ -0,0 +1,34 @@
+/**
+ * @file options.h
+ * @brief  Definitions for command line options.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include "../headers.h"
+
+/**
+ * @brief Options holds what was asked for on the command line, files to
+ * parse and how to run the batch.
+ */
+struct Options {
+  void parse(int, char*[]);
+  static void printUsage(std::ostream&, const char*);
+
+  std::vector<std::string> paths;
+  std::vector<std::string> fileLists;  // "-" reads names from stdin
+  unsigned jobs = 0;                   // 0: one worker per core
+  BatchScanner::outputOrder order = BatchScanner::INPUT_ORDER;
+  bool recursive = false;              // directories are walked
+  WalkOptions walk;
+  HashPolicy hashPolicy;
+  bool dedupe = false;                 // skip files seen before
+  uint32_t details = 0;                // see FileIO::details
+  bool help = false;
+};
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @file output_buffer.cpp
+ * @brief  Number formatting and manipulators of OutputBuffer.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "output_buffer.h"
+
+/**
+ * @brief Applies a stream manipulator. hex/dec pick the base of later
+ * integers and uppercase/nouppercase the case of hex digits, others are
+ * ignored.
+ *
+ * @param flag std::hex, std::dec, std::uppercase or std::nouppercase.
+ *
+ * @return this buffer.
+ */
+OutputBuffer& OutputBuffer::operator<<(formatFlag flag) {
+  if (flag == std::hex) {
+    hex_b = true;
+  } else if (flag == std::dec) {
+    hex_b = false;
+  } else if (flag == std::uppercase) {
+    uppercase_b = true;
+  } else if (flag == std::nouppercase) {
+    uppercase_b = false;
+  }
+  return *this;
+}
+
+/**
+ * @brief Takes std::endl, which only ends the line here: the buffer is
+ * written as a whole later.
+ *
+ * @return this buffer.
+ */
+OutputBuffer& OutputBuffer::operator<<(streamFunction) {
+  text_s.push_back('\n');
+  return *this;
+}
+
+/**
+ * @brief Appends a number in hex without leading zeros, the case of the
+ * digits follows uppercase/nouppercase.
+ *
+ * @param value the number.
+ */
+void OutputBuffer::appendHex(uint64_t value) {
+  const char* digits = uppercase_b ? "0123456789ABCDEF" : "0123456789abcdef";
+  char text[16];
+  size_t start = sizeof(text);
+  do {
+    text[--start] = digits[value & 0xf];
+    value >>= 4;
+  } while (value != 0);
+  text_s.append(text + start, sizeof(text) - start);
+}
+
+/**
+ * @brief Appends a number in decimal.
+ *
+ * @param value the number.
+ */
+void OutputBuffer::appendDecimal(uint64_t value) {
+  char text[20];
+  size_t start = sizeof(text);
+  do {
+    text[--start] = char('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  text_s.append(text + start, sizeof(text) - start);
+}
+
+/**
+ * @brief Writes everything formatted so far with a single write() call.
+ *
+ * @param out stream to write to.
+ */
+void OutputBuffer::writeTo(std::ostream& out) const {
+  out.write(text_s.data(), std::streamsize(text_s.size()));
+}
+
+/**
+ * @brief Empties the buffer and resets the manipulators, the memory is
+ * kept for the next file.
+ */
+void OutputBuffer::clear() {
+  text_s.clear();
+  hex_b = false;
+  uppercase_b = false;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file output_buffer.h
+ * @brief  Definitions for OutputBuffer, the in-memory sink the printers
+ *      format into before anything is written out.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief OutputBuffer takes the same << expressions as a std::ostream,
+ * including the hex, dec, uppercase and nouppercase manipulators (which
+ * stay in effect the same way), so output is byte for byte what a stream
+ * would give. Numbers are formatted by hand and std::endl only adds a
+ * newline, nothing is flushed until writeTo() hands the whole text to a
+ * stream in one call. A buffer belongs to one thread, each batch worker
+ * keeps its own and reuses its memory from file to file.
+ */
+class OutputBuffer {
+ public:
+  typedef std::ios_base& (*formatFlag)(std::ios_base&);
+  typedef std::ostream& (*streamFunction)(std::ostream&);
+
+  OutputBuffer() = default;
+
+  OutputBuffer& operator<<(std::string_view text) {
+    text_s.append(text);
+    return *this;
+  }
+  OutputBuffer& operator<<(const std::string& text) {
+    text_s.append(text);
+    return *this;
+  }
+  OutputBuffer& operator<<(const char* text) {
+    text_s.append(text);
+    return *this;
+  }
+
+  /**
+   * @brief Characters are written as is, bool as 0/1 and other integers
+   * in the current base, negative numbers in hex as their two's
+   * complement, like std::ostream.
+   */
+  template <typename T>
+    requires std::is_integral_v<T>
+  OutputBuffer& operator<<(T value) {
+    if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+                  std::is_same_v<T, unsigned char>) {
+      text_s.push_back(char(value));
+    } else if constexpr (std::is_same_v<T, bool>) {
+      text_s.push_back(value ? '1' : '0');
+    } else if (hex_b) {
+      appendHex(uint64_t(std::make_unsigned_t<T>(value)));
+    } else if (value < 0) {
+      text_s.push_back('-');
+      appendDecimal(uint64_t(0) - uint64_t(value));
+    } else {
+      appendDecimal(uint64_t(value));
+    }
+    return *this;
+  }
+
+  OutputBuffer& operator<<(formatFlag);
+  OutputBuffer& operator<<(streamFunction);
+
+  void appendHex(uint64_t);
+  void appendDecimal(uint64_t);
+
+  std::string_view view() const { return text_s; }
+  void writeTo(std::ostream&) const;
+  void clear();
+
+ private:
+  std::string text_s;
+  bool hex_b = false;
+  bool uppercase_b = false;
+};
+
+#endif
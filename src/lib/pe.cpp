@@ -24,162 +24,244 @@ PE::PE(std::string filename) {
 }
 
 /**
- * @brief Open file in binary mode and calls parsing method.
+ * @brief Maps file into memory and calls parsing method. The file stays
+ * mapped as long as the object, imported and exported names point into
+ * it.
  *
  * @param filename a string for a file to be opened and parsed.
  *
  * @return none.
  */
 void PE::init(std::string filename) {
-  std::ifstream in(filename, std::ios::binary);
+  mapping = std::make_unique<MappedFile>(filename);
+  init(mapping->bytes());
+}
+
+/**
+ * @brief Parses an image already in memory, without copying it or touching
+ * the file system. The object keeps views into the buffer (imported and
+ * exported names among others), the buffer has to outlive the object.
+ *
+ * @param image bytes holding the image.
+ * @param base offset of the image inside the buffer, file offsets found in
+ * the headers are relative to it.
+ *
+ * @return none.
+ */
+void PE::init(std::span<const std::byte> image, uint64_t base) {
+  ByteReader in(image, base);
   parse(in);
 }
 
 /**
- * @brief Given an open file in ifstream, it parses PE header, data directories,
+ * @brief Given a ByteReader over the file, it parses PE header, data directories,
  * and sections. then prints out basic info parsed.
  *
- * @param in An std::ifstream object with PE file already opened,
- * assumption here is that the stream object is at offset 0.
+ * @param in A ByteReader over the PE file content,
+ * assumption here is that the reader is at offset 0.
  *
  * @return none.
  */
-void PE::parse(std::ifstream& in) {
+void PE::parse(ByteReader& in) {
   // parsing process in steps
   readDOSHeader(in);
   readPE(in);
   readDataDirectory(in, dataDir);
   readSections(in, sections);
-  mapHeaderFlags();
+
+  // directory offsets are found through the sections, the certificate
+  // table is the one directory that already holds a file offset.
+  sectionIndex.build(sections, sizeOfHeaders_u32);
+  for (uint32_t idx = 0; idx < dataDir.size(); idx++) {
+    dataDir[idx].setOffset(idx == CERTIFICATE_TABLE
+                               ? dataDir[idx].getVA()
+                               : sectionIndex.toOffset(dataDir[idx].getVA()));
+  }
+  // a damaged directory doesn't keep the headers from being used.
+  readDirectory(in, IMPORT_TABLE, &PE::readImports);
+  readDirectory(in, EXPORT_TABLE, &PE::readExports);
+  exportDirectory.buildIndex();
+  nameCache = {};
+}
+
+/**
+ * @brief Runs the reader of one optional directory. When the directory
+ * can't be read its error is recorded instead of thrown, whatever was
+ * read before the error is kept.
+ *
+ * @param in A ByteReader over the PE file content.
+ * @param dir the directory, one of dataDirectories.
+ * @param reader the method reading it.
+ *
+ * @return none.
+ */
+void PE::readDirectory(ByteReader& in, uint32_t dir,
+                       void (PE::*reader)(ByteReader&)) {
+  try {
+    (this->*reader)(in);
+  } catch (std::out_of_range& except) {
+    directoryErrors[dir] = Error(ErrorCode::TRUNCATED, except.what());
+  } catch (std::exception& except) {
+    directoryErrors[dir] = Error(ErrorCode::MALFORMED_TABLE, except.what());
+  }
+}
+
+/**
+ * @brief Reads the NUL terminated name at an RVA, a name already read at
+ * the same RVA is returned again without touching the image.
+ *
+ * @param in A ByteReader over the PE file content.
+ * @param rva address of the name.
+ *
+ * @return a view into the image. throws std::runtime_error for names
+ * longer than maxNameLength.
+ */
+std::string_view PE::readName(ByteReader& in, uint32_t rva) {
+  auto found = nameCache.find(rva);
+  if (found != nameCache.end()) return found->second;
+
+  in.seek(rvaToOffset(rva));
+  std::string_view name = in.read_string(maxNameLength);
+  nameCache.emplace(rva, name);
+  return name;
 }
 
 /**
  * @brief Parses Dos header into members of PE class object.
  *
- * @param in An std::ifstream object with PE file already opened,
- * assumption here is that the stream object is at offset 0.
+ * @param in A ByteReader over the PE file content,
+ * assumption here is that the reader is at offset 0.
  *
  * @return none.
  */
-void PE::readDOSHeader(std::ifstream& in) {
+void PE::readDOSHeader(ByteReader& in) {
    
   // Reading DOS Header
-  dosMagic_u16 = FileIO::FileIO::read_u16(in, true);
-  e_cblp_u16 = FileIO::FileIO::read_u16(in, true);
-  e_cp_u16 = FileIO::read_u16(in, true);
-  e_crlc_u16 = FileIO::read_u16(in, true);
-  e_cparhdr_u16 = FileIO::read_u16(in, true);
-  e_minalloc_u16 = FileIO::read_u16(in, true);
-  e_maxalloc_u16 = FileIO::read_u16(in, true);
-  e_ss_u16 = FileIO::read_u16(in, true);
-  e_sp_u16 = FileIO::read_u16(in, true);
-  e_csum_u16 = FileIO::read_u16(in, true);
-  e_ip_u16 = FileIO::read_u16(in, true);
-  e_cs_u16 = FileIO::read_u16(in, true);
-  e_lfarlc_u16 = FileIO::read_u16(in, true);
-  e_ovno_u16 = FileIO::read_u16(in, true);
-  e_res_u64 = FileIO::read_u64(in, true);
-  e_oemid_u16 = FileIO::read_u16(in, true);
-  e_oeminfo_u16 = FileIO::read_u16(in, true);
-  e_res2_1_u64 = FileIO::read_u64(in, true);
-  e_res2_2_u64 = FileIO::read_u64(in, true);
-  e_res2_3_u64 = FileIO::read_u32(in, true);
-  e_lfanew_u32 = FileIO::read_u32(in, true);
+  dosMagic_u16 = in.read<uint16_t>();
+  e_cblp_u16 = in.read<uint16_t>();
+  e_cp_u16 = in.read<uint16_t>();
+  e_crlc_u16 = in.read<uint16_t>();
+  e_cparhdr_u16 = in.read<uint16_t>();
+  e_minalloc_u16 = in.read<uint16_t>();
+  e_maxalloc_u16 = in.read<uint16_t>();
+  e_ss_u16 = in.read<uint16_t>();
+  e_sp_u16 = in.read<uint16_t>();
+  e_csum_u16 = in.read<uint16_t>();
+  e_ip_u16 = in.read<uint16_t>();
+  e_cs_u16 = in.read<uint16_t>();
+  e_lfarlc_u16 = in.read<uint16_t>();
+  e_ovno_u16 = in.read<uint16_t>();
+  e_res_u64 = in.read<uint64_t>();
+  e_oemid_u16 = in.read<uint16_t>();
+  e_oeminfo_u16 = in.read<uint16_t>();
+  e_res2_1_u64 = in.read<uint64_t>();
+  e_res2_2_u64 = in.read<uint64_t>();
+  e_res2_3_u64 = in.read<uint32_t>();
+  e_lfanew_u32 = in.read<uint32_t>();
 }
 
 /**
  * @brief Parses PE header into members of PE class object.
  *
- * @param in An std::ifstream object with PE file already opened,
+ * @param in A ByteReader over the PE file content,
  * e_lfanew needs to have been read correctly for this function to work.
  *
  * @return none.
  */
-void PE::readPE(std::ifstream& in) {
-  in.seekg(e_lfanew_u32, std::ios_base::beg);
+void PE::readPE(ByteReader& in) {
+  in.seek(e_lfanew_u32);
 
   // PE header
-  peSignature_u32 = FileIO::read_u32(in, true);
-  machine_u16 = FileIO::read_u16(in, true);
-  numberOfSections_u16 = FileIO::read_u16(in, true);
-  timeStamp_u32 = FileIO::read_u32(in, true);
-  symTablePtr_u32 = FileIO::read_u32(in, true);
-  numberOfSym_u32 = FileIO::read_u32(in, true);
-  optionalHeaderSize_u16 = FileIO::read_u16(in, true);
-  characteristics_u16 = FileIO::read_u16(in, true);
+  peSignature_u32 = in.read<uint32_t>();
+  machine_u16 = in.read<uint16_t>();
+  numberOfSections_u16 = in.read<uint16_t>();
+  timeStamp_u32 = in.read<uint32_t>();
+  symTablePtr_u32 = in.read<uint32_t>();
+  numberOfSym_u32 = in.read<uint32_t>();
+  optionalHeaderSize_u16 = in.read<uint16_t>();
+  characteristics_u16 = in.read<uint16_t>();
 
   // optional header (Standard Fields)
-  optionalHeaderMagic_u16 = FileIO::read_u16(in, true);
-  majorLinkerVer_u8 = FileIO::read_u8(in);
-  minorLinkerVer_u8 = FileIO::read_u8(in);
-  sizeOfCode_u32 = FileIO::read_u32(in, true);
-  sizeOfInitializedData_u32 = FileIO::read_u32(in, true);
-  sizeOfUninitializedData_u32 = FileIO::read_u32(in, true);
-  entryPoint_u32 = FileIO::read_u32(in, true);
-  baseOfCode_u32 = FileIO::read_u32(in, true);
+  optionalHeaderMagic_u16 = in.read<uint16_t>();
+  majorLinkerVer_u8 = in.read_u8();
+  minorLinkerVer_u8 = in.read_u8();
+  sizeOfCode_u32 = in.read<uint32_t>();
+  sizeOfInitializedData_u32 = in.read<uint32_t>();
+  sizeOfUninitializedData_u32 = in.read<uint32_t>();
+  entryPoint_u32 = in.read<uint32_t>();
+  baseOfCode_u32 = in.read<uint32_t>();
 
+  // the rest of the optional header differs in word size only.
   if (optionalHeaderMagic_u16 == OPTIONAL_IMAGE_PE32_plus) {
-    imageBase_u64 = FileIO::read_u64(in, true);
-    // std::cout << "64bit PE \n";
+    readWindowsFields<uint64_t>(in);
   } else {
-    //  std::cout << "32bit PE\n";
-    baseOfData_u32 = FileIO::read_u32(in, true);
-    imageBase_u64 = FileIO::read_u32(in, true);
-  }
-  sectionAlignment_u32 = FileIO::read_u32(in, true);
-  fileAlignment_u32 = FileIO::read_u32(in, true);
-  majorOSVersion_u16 = FileIO::read_u16(in, true);
-  minorOSVersion_u16 = FileIO::read_u16(in, true);
-  majorImageVersion_u16 = FileIO::read_u16(in, true);
-  minorImageVersion_u16 = FileIO::read_u16(in, true);
-  majorSubsystemVersion_u16 = FileIO::read_u16(in, true);
-  minorSubsystemVer_u16 = FileIO::read_u16(in, true);
-  win32VersionVal_u32 = FileIO::read_u32(in, true);
-  sizeOfImage_u32 = FileIO::read_u32(in, true);
-  sizeOfHeaders_u32 = FileIO::read_u32(in, true);
-  checkSum_u32 = FileIO::read_u32(in, true);
-  subsystem_u16 = FileIO::read_u16(in, true);
-  dllCharacteristics_u16 = FileIO::read_u16(in, true);
-
-  if (optionalHeaderMagic_u16 == OPTIONAL_IMAGE_PE32_plus) {
-    sizeOfStackReserve_u64 = FileIO::read_u64(in, true);
-    sizeOfStackCommit_u64 = FileIO::read_u64(in, true);
-    sizeOfHeapReserve_u64 = FileIO::read_u64(in, true);
-    sizeOfHeapCommit_u64 = FileIO::read_u64(in, true);
-  } else {
-    sizeOfStackReserve_u64 = FileIO::read_u32(in, true);
-    sizeOfStackCommit_u64 = FileIO::read_u32(in, true);
-    sizeOfHeapReserve_u64 = FileIO::read_u32(in, true);
-    sizeOfHeapCommit_u64 = FileIO::read_u32(in, true);
+    baseOfData_u32 = in.read<uint32_t>();
+    readWindowsFields<uint32_t>(in);
   }
-  loaderFlags_u32 = FileIO::read_u32(in, true);
-  numberOfRvaAndSizes_u32 = FileIO::read_u32(in, true);
+}
+
+/**
+ * @brief Parses the Windows specific fields of the optional header, Word is
+ * uint32_t for PE32 and uint64_t for PE32+ images.
+ *
+ * @param in A ByteReader over the PE file content, set at ImageBase.
+ *
+ * @return none.
+ */
+template <typename Word>
+void PE::readWindowsFields(ByteReader& in) {
+  imageBase_u64 = in.read<Word>();
+  sectionAlignment_u32 = in.read<uint32_t>();
+  fileAlignment_u32 = in.read<uint32_t>();
+  majorOSVersion_u16 = in.read<uint16_t>();
+  minorOSVersion_u16 = in.read<uint16_t>();
+  majorImageVersion_u16 = in.read<uint16_t>();
+  minorImageVersion_u16 = in.read<uint16_t>();
+  majorSubsystemVersion_u16 = in.read<uint16_t>();
+  minorSubsystemVer_u16 = in.read<uint16_t>();
+  win32VersionVal_u32 = in.read<uint32_t>();
+  sizeOfImage_u32 = in.read<uint32_t>();
+  sizeOfHeaders_u32 = in.read<uint32_t>();
+  checkSum_u32 = in.read<uint32_t>();
+  subsystem_u16 = in.read<uint16_t>();
+  dllCharacteristics_u16 = in.read<uint16_t>();
+  sizeOfStackReserve_u64 = in.read<Word>();
+  sizeOfStackCommit_u64 = in.read<Word>();
+  sizeOfHeapReserve_u64 = in.read<Word>();
+  sizeOfHeapCommit_u64 = in.read<Word>();
+  loaderFlags_u32 = in.read<uint32_t>();
+  numberOfRvaAndSizes_u32 = in.read<uint32_t>();
 }
 
 /**
  * @brief Parses PE sections into members of PE class object.
  *
- * @param in An std::ifstream object with PE file already opened,
- * this functions assumes file stream is the proper
- * offset before this function is called.
+ * @param in A ByteReader over the PE file content, the section table is
+ * found from the PE header read before.
  * @param sections an array of sections that has been already allocated
  *  based on info read from PE header previously.
  *
  * @return none.
  */
-void PE::readSections(std::ifstream& in, std::vector<PESection>& vecSection) {
+void PE::readSections(ByteReader& in, std::vector<PESection>& vecSection) {
+  // the section table follows the optional header, 40 bytes per section.
+  in.seek(uint64_t(e_lfanew_u32) + 24 + optionalHeaderSize_u16);
+  const uint8_t* table = in.read_table(numberOfSections_u16, 40);
+
+  vecSection.reserve(numberOfSections_u16);
   for (uint32_t idx = 0; idx < numberOfSections_u16; idx++) {
+    const uint8_t* entry = table + idx * 40;
     PESection section;
-    section.setName(in);
-    section.setVirtualSize(FileIO::read_u32(in, true));
-    section.setVirtualAddress(FileIO::read_u32(in, true));
-    section.setRawDataSize(FileIO::read_u32(in, true));
-    section.setRawDataPointer(FileIO::read_u32(in, true));
-    section.setPointerToRelocations(FileIO::read_u32(in, true));
-    section.setPointerToLinenumbers(FileIO::read_u32(in, true));
-    section.setNumberOfRelocations(FileIO::read_u16(in, true));
-    section.setNumberOfLineNumbers(FileIO::read_u16(in, true));
-    section.setCharacteristics(FileIO::read_u32(in, true));
+    section.setName(entry);
+    section.setVirtualSize(ByteReader::decode<uint32_t>(entry + 8));
+    section.setVirtualAddress(ByteReader::decode<uint32_t>(entry + 12));
+    section.setRawDataSize(ByteReader::decode<uint32_t>(entry + 16));
+    section.setRawDataPointer(ByteReader::decode<uint32_t>(entry + 20));
+    section.setPointerToRelocations(ByteReader::decode<uint32_t>(entry + 24));
+    section.setPointerToLinenumbers(ByteReader::decode<uint32_t>(entry + 28));
+    section.setNumberOfRelocations(ByteReader::decode<uint16_t>(entry + 32));
+    section.setNumberOfLineNumbers(ByteReader::decode<uint16_t>(entry + 34));
+    section.setCharacteristics(ByteReader::decode<uint32_t>(entry + 36));
     vecSection.push_back(section);
   }
 }
@@ -187,7 +269,7 @@ void PE::readSections(std::ifstream& in, std::vector<PESection>& vecSection) {
 /**
  * @brief Parses PE data directories into directory of PE class object.
  *
- * @param in An std::ifstream object with PE file already opened,
+ * @param in A ByteReader over the PE file content,
  * this functions assumes file stream is the proper
  * offset before this function is called.
  * @param dataDirectory an array of directories that has been
@@ -195,112 +277,314 @@ void PE::readSections(std::ifstream& in, std::vector<PESection>& vecSection) {
  *
  * @return none.
  */
-void PE::readDataDirectory(std::ifstream& in,
+void PE::readDataDirectory(ByteReader& in,
                            std::vector<DataDirectory>& vecDataDirectory) {
+  // 8 bytes per directory: virtual address and size.
+  const uint8_t* table = in.read_table(numberOfRvaAndSizes_u32, 8);
+
+  vecDataDirectory.reserve(numberOfRvaAndSizes_u32);
   for (uint32_t idx = 0; idx < numberOfRvaAndSizes_u32; idx++) {
+    const uint8_t* entry = table + idx * 8;
     DataDirectory dataDirEntry;
-    dataDirEntry.setVirtualAddress(FileIO::read_u32(in, true));
-    dataDirEntry.setSize(FileIO::read_u32(in, true));
+    dataDirEntry.setVirtualAddress(ByteReader::decode<uint32_t>(entry));
+    dataDirEntry.setSize(ByteReader::decode<uint32_t>(entry + 4));
     vecDataDirectory.push_back(dataDirEntry);
     // setting directory offset is possible after sections info is read.
   }
 }
 
 /**
- * @brief Maps PE flag and property values into map object.
+ * @brief Parses the import directory: one descriptor per DLL, and for each
+ * the functions listed in its import lookup table.
+ *
+ * @param in A ByteReader over the PE file content, sections and data
+ * directories need to have been read.
+ *
+ * @return none. throws std::runtime_error past maxImportedFunctions
+ * functions.
+ */
+void PE::readImports(ByteReader& in) {
+  if (dataDir.size() <= IMPORT_TABLE || dataDir[IMPORT_TABLE].getVA() == 0) {
+    return;
+  }
+
+  // 20 bytes per descriptor, the table ends with an all zero descriptor.
+  uint64_t next = rvaToOffset(dataDir[IMPORT_TABLE].getVA());
+  uint64_t remaining = maxImportedFunctions;
+  while (true) {
+    in.seek(next);
+    const uint8_t* entry = in.read_bytes(20);
+    next = in.tell();
+
+    ImportDirectory dll;
+    dll.setLookupTableRVA(ByteReader::decode<uint32_t>(entry));
+    dll.setTimeStamp(ByteReader::decode<uint32_t>(entry + 4));
+    dll.setForwarderChain(ByteReader::decode<uint32_t>(entry + 8));
+    dll.setNameRVA(ByteReader::decode<uint32_t>(entry + 12));
+    dll.setAddressTableRVA(ByteReader::decode<uint32_t>(entry + 16));
+    if (dll.getNameRVA() == 0 && dll.getAddressTableRVA() == 0) break;
+
+    dll.setName(readName(in, dll.getNameRVA()));
+
+    if (optionalHeaderMagic_u16 == OPTIONAL_IMAGE_PE32_plus) {
+      readThunks<uint64_t>(in, dll, remaining);
+    } else {
+      readThunks<uint32_t>(in, dll, remaining);
+    }
+    importDirectory.push_back(std::move(dll));
+  }
+}
+
+/**
+ * @brief Parses the export directory: the export address table, and the
+ * name pointer and ordinal tables that give names to its entries. The name
+ * index is built by parse(), whether or not the directory reads fully.
+ *
+ * @param in A ByteReader over the PE file content, sections and data
+ * directories need to have been read.
  *
  * @return none.
  */
-void PE::mapHeaderFlags() {
-  using namespace std;
-  mapSectionFlags.try_emplace(0x00000008, "IMAGE_SCN_TYPE_NO_PAD");
-  mapSectionFlags.try_emplace(0x00000020, "IMAGE_SCN_CNT_CODE");
-  mapSectionFlags.try_emplace(0x00000040, "IMAGE_SCN_CNT_INITIALIZED_DATA");
-  mapSectionFlags.try_emplace(0x00000080, "IMAGE_SCN_CNT_UNINITIALIZED_ DATA");
-  mapSectionFlags.try_emplace(0x00000100, "IMAGE_SCN_LNK_OTHER");
-  mapSectionFlags.try_emplace(0x00000200, "IMAGE_SCN_LNK_INFO");
-  mapSectionFlags.try_emplace(0x00000800, "IMAGE_SCN_LNK_REMOVE");
-  mapSectionFlags.try_emplace(0x00001000, "IMAGE_SCN_LNK_COMDAT");
-  mapSectionFlags.try_emplace(0x00008000, "IMAGE_SCN_GPREL");
-  mapSectionFlags.try_emplace(0x00020000, "IMAGE_SCN_MEM_PURGEABLE");
-  mapSectionFlags.try_emplace(0x00020000, "IMAGE_SCN_MEM_16BIT");
-  mapSectionFlags.try_emplace(0x00040000, "IMAGE_SCN_MEM_LOCKED");
-  mapSectionFlags.try_emplace(0x00080000, "IMAGE_SCN_MEM_PRELOAD");
-  mapSectionFlags.try_emplace(0x00100000, "IMAGE_SCN_ALIGN_1BYTES");
-  mapSectionFlags.try_emplace(0x00200000, "IMAGE_SCN_ALIGN_2BYTES");
-  mapSectionFlags.try_emplace(0x00300000, "IMAGE_SCN_ALIGN_4BYTES");
-  mapSectionFlags.try_emplace(0x00400000, "IMAGE_SCN_ALIGN_8BYTES");
-  mapSectionFlags.try_emplace(0x00500000, "IMAGE_SCN_ALIGN_16BYTES");
-  mapSectionFlags.try_emplace(0x00600000, "IMAGE_SCN_ALIGN_32BYTES");
-  mapSectionFlags.try_emplace(0x00700000, "IMAGE_SCN_ALIGN_64BYTES");
-  mapSectionFlags.try_emplace(0x00800000, "IMAGE_SCN_ALIGN_128BYTES");
-  mapSectionFlags.try_emplace(0x00900000, "IMAGE_SCN_ALIGN_256BYTES");
-  mapSectionFlags.try_emplace(0x00A00000, "IMAGE_SCN_ALIGN_512BYTES");
-  mapSectionFlags.try_emplace(0x00B00000, "IMAGE_SCN_ALIGN_1024BYTES");
-  mapSectionFlags.try_emplace(0x00C00000, "IMAGE_SCN_ALIGN_2048BYTES");
-  mapSectionFlags.try_emplace(0x00D00000, "IMAGE_SCN_ALIGN_4096BYTES");
-  mapSectionFlags.try_emplace(0x00E00000, "IMAGE_SCN_ALIGN_8192BYTES");
-  mapSectionFlags.try_emplace(0x01000000, "IMAGE_SCN_LNK_NRELOC_OVFL");
-  mapSectionFlags.try_emplace(0x02000000, "IMAGE_SCN_MEM_DISCARDABLE");
-  mapSectionFlags.try_emplace(0x04000000, "IMAGE_SCN_MEM_NOT_CACHED");
-  mapSectionFlags.try_emplace(0x08000000, "IMAGE_SCN_MEM_NOT_PAGED");
-  mapSectionFlags.try_emplace(0x10000000, "IMAGE_SCN_MEM_SHARED");
-  mapSectionFlags.try_emplace(0x20000000, "IMAGE_SCN_MEM_EXECUTE");
-  mapSectionFlags.try_emplace(0x40000000, "IMAGE_SCN_MEM_READ");
-  mapSectionFlags.try_emplace(0x80000000, "IMAGE_SCN_MEM_WRITE");
-
-  mapPEFlagTypes.try_emplace(0x0001, "IMAGE_FILE_RELOCS_STRIPPED");
-  mapPEFlagTypes.try_emplace(0x0002, "IMAGE_FILE_EXECUTABLE_IMAGE");
-  mapPEFlagTypes.try_emplace(0x0004, "IMAGE_FILE_LINE_NUMS_STRIPPED");
-  mapPEFlagTypes.try_emplace(0x0008, "IMAGE_FILE_LOCAL_SYMS_STRIPPED");
-  mapPEFlagTypes.try_emplace(0x0010, "IMAGmapPEFlagTypes.E_FILE_AGGRESSIVE_WS_TRIM");
-  mapPEFlagTypes.try_emplace(0x0020, "IMAGE_FILE_LARGE_ADDRESS_AWARE");
-  mapPEFlagTypes.try_emplace(0x0080, "IMAGE_FILE_BYTES_REVERSED_LO");
-  mapPEFlagTypes.try_emplace(0x0100, "IMAGE_FILE_32BIT_MACHINE");
-  mapPEFlagTypes.try_emplace(0x0200, "IMAGE_FILE_DEBUG_STRIPPED");
-  mapPEFlagTypes.try_emplace(0x0400, "IMAGE_FILE_REMOVABLE_RUN_FROM_SWAP");
-  mapPEFlagTypes.try_emplace(0x0800, "IMAGE_FILE_NET_RUN_FROM_SWAP");
-  mapPEFlagTypes.try_emplace(0x1000, "IMAGE_FILE_SYSTEM");
-  mapPEFlagTypes.try_emplace(0x2000, "IMAGE_FILE_DLL");
-  mapPEFlagTypes.try_emplace(0x4000, "IMAGE_FILE_UP_SYSTEM_ONLY");
-  mapPEFlagTypes.try_emplace(0x8000, "IMAGE_FILE_BYTES_REVERSED_HI");
-
-  mapImageCharacteristics.try_emplace(0x0020, "IMAGE_DLLCHARACTERISTICS_HIGH_ENTROPY_VA");
-  mapImageCharacteristics.try_emplace(0x0040, "IMAGE_DLLCHARACTERISTICS_DYNAMIC_BASE");
-  mapImageCharacteristics.try_emplace(0x0080, "IMAGE_DLLCHARACTERISTICS_FORCE_INTEGRITY");
-  mapImageCharacteristics.try_emplace(0x0100, "IMAGE_DLLCHARACTERISTICS_NX_COMPAT");
-  mapImageCharacteristics.try_emplace(0x0200, "IMAGE_DLLCHARACTERISTICS_NO_ISOLATION");
-  mapImageCharacteristics.try_emplace(0x0400, "IMAGE_DLLCHARACTERISTICS_NO_SEH");
-  mapImageCharacteristics.try_emplace(0x0800, "IMAGE_DLLCHARACTERISTICS_NO_BIND");
-  mapImageCharacteristics.try_emplace(0x1000, "IMAGE_DLLCHARACTERISTICS_APPCONTAINER");
-  mapImageCharacteristics.try_emplace(0x2000, "IMAGE_DLLCHARACTERISTICS_WDM_DRIVER");
-  mapImageCharacteristics.try_emplace(0x4000, "IMAGE_DLLCHARACTERISTICS_GUARD_CF");
-  mapImageCharacteristics.try_emplace(0x8000, "IMAGE_DLLCHARACTERISTICS_TERMINAL_SERVER_AWARE");
-
-  mapMachineType.try_emplace(0x0, "IMAGE_FILE_MACHINE_UNKNOWN");
-  mapMachineType.try_emplace(0x200, "IMAGE_FILE_MACHINE_IA64");
-  mapMachineType.try_emplace(0x14c, "IMAGE_FILE_MACHINE_I386");
-  mapMachineType.try_emplace(0x8664, "IMAGE_FILE_MACHINE_AMD64");
-  mapMachineType.try_emplace(0x1c0, "IMAGE_FILE_MACHINE_ARM");
-  mapMachineType.try_emplace(0xaa64, "IMAGE_FILE_MACHINE_ARM64");
-  mapMachineType.try_emplace(0x1c4, "IMAGE_FILE_MACHINE_ARMNT");
-  mapMachineType.try_emplace(0xebc, "IMAGE_FILE_MACHINE_EBC");
-
-  mapImageSubsystem.try_emplace(0, "IMAGE_SUBSYSTEM_UNKNOWN");
-  mapImageSubsystem.try_emplace(1, "IMAGE_SUBSYSTEM_NATIVE");
-  mapImageSubsystem.try_emplace(2, "IMAGE_SUBSYSTEM_WINDOWS_GUI");
-  mapImageSubsystem.try_emplace(3, "IMAGE_SUBSYSTEM_WINDOWS_CUI");
-
-  mapImageSubsystem.try_emplace(5, "IMAGE_SUBSYSTEM_OS2_CUI");
-  mapImageSubsystem.try_emplace(7, "IMAGE_SUBSYSTEM_POSIX_CUI");
-  mapImageSubsystem.try_emplace(8, "IMAGE_SUBSYSTEM_NATIVE_WINDOWS");
-  mapImageSubsystem.try_emplace(9, "IMAGE_SUBSYSTEM_WINDOWS_CE_GUI");
-  mapImageSubsystem.try_emplace(10, "IMAGE_SUBSYSTEM_EFI_APPLICATION");
-  mapImageSubsystem.try_emplace(11, "IMAGE_SUBSYSTEM_EFI_BOOT_SERVICE_DRIVER");
-  mapImageSubsystem.try_emplace(12, "IMAGE_SUBSYSTEM_EFI_RUNTIME_DRIVER");
-  mapImageSubsystem.try_emplace(13, "IMAGE_SUBSYSTEM_EFI_ROM");
-  mapImageSubsystem.try_emplace(14, "IMAGE_SUBSYSTEM_XBOX");
-  mapImageSubsystem.try_emplace(16, "IMAGE_SUBSYSTEM_WINDOWS_BOOT_APPLICATION");
+void PE::readExports(ByteReader& in) {
+  if (dataDir.size() <= EXPORT_TABLE || dataDir[EXPORT_TABLE].getVA() == 0) {
+    return;
+  }
+  const DataDirectory& dir = dataDir[EXPORT_TABLE];
+
+  in.seek(rvaToOffset(dir.getVA()));
+  const uint8_t* entry = in.read_bytes(40);
+  ExportDirectory& exports = exportDirectory;
+  exports.setExportFlags(ByteReader::decode<uint32_t>(entry));
+  exports.setTimeStamp(ByteReader::decode<uint32_t>(entry + 4));
+  exports.setMajorVersion(ByteReader::decode<uint16_t>(entry + 8));
+  exports.setMinorVersion(ByteReader::decode<uint16_t>(entry + 10));
+  exports.setNameRVA(ByteReader::decode<uint32_t>(entry + 12));
+  exports.setOrdinalBase(ByteReader::decode<uint32_t>(entry + 16));
+  exports.setAddressTableEntries(ByteReader::decode<uint32_t>(entry + 20));
+  exports.setNumberOfNamePointers(ByteReader::decode<uint32_t>(entry + 24));
+  exports.setAddressTableRVA(ByteReader::decode<uint32_t>(entry + 28));
+  exports.setNamePointerRVA(ByteReader::decode<uint32_t>(entry + 32));
+  exports.setOrdinalTableRVA(ByteReader::decode<uint32_t>(entry + 36));
+
+  if (exports.getNameRVA() != 0) {
+    exports.setName(readName(in, exports.getNameRVA()));
+  }
+
+  // address table, 4 bytes per ordinal. Unused ordinals hold zero, and an
+  // address inside the export directory is a forwarder string.
+  uint32_t count = exports.getAddressTableEntries();
+  if (count != 0) {
+    in.seek(rvaToOffset(exports.getAddressTableRVA()));
+    const uint8_t* table = in.read_table(count, 4);
+    exports.reserve(count, 0);
+    for (uint32_t idx = 0; idx < count; idx++) {
+      uint32_t rva = ByteReader::decode<uint32_t>(table + idx * 4);
+      if (rva == 0) continue;
+
+      ExportedFunction function;
+      function.setOrdinal(exports.getOrdinalBase() + idx);
+      function.setAddressRVA(rva);
+      if (rva - dir.getVA() < dir.getSize()) {
+        function.setForwarder(readName(in, rva));
+      }
+      exports.addFunction(function);
+    }
+  }
+
+  // name pointer table (4 bytes) and ordinal table (2 bytes, an index
+  // into the address table) run side by side.
+  count = exports.getNumberOfNamePointers();
+  if (count != 0) {
+    in.seek(rvaToOffset(exports.getNamePointerRVA()));
+    const uint8_t* pointers = in.read_table(count, 4);
+    in.seek(rvaToOffset(exports.getOrdinalTableRVA()));
+    const uint8_t* ordinals = in.read_table(count, 2);
+    exports.reserve(0, count);
+    for (uint32_t idx = 0; idx < count; idx++) {
+      uint32_t rva = ByteReader::decode<uint32_t>(pointers + idx * 4);
+      uint16_t ordinal = ByteReader::decode<uint16_t>(ordinals + idx * 2);
+      exports.addName(readName(in, rva), exports.getOrdinalBase() + ordinal);
+    }
+  }
+}
+
+/**
+ * @brief Reads the functions imported from one DLL. Word is uint32_t for
+ * PE32 and uint64_t for PE32+ images, its top bit marks an import by
+ * ordinal, otherwise the low 31 bits are the RVA of a hint and a name.
+ *
+ * @param in A ByteReader over the PE file content.
+ * @param dll the DLL's descriptor, functions are added to it.
+ * @param remaining functions that may still be read, counted down.
+ *
+ * @return none.
+ */
+template <typename Word>
+void PE::readThunks(ByteReader& in, ImportDirectory& dll,
+                    uint64_t& remaining) {
+  constexpr Word ordinalFlag = Word(1) << (sizeof(Word) * 8 - 1);
+
+  // the lookup table is missing in some old images, the address table
+  // holds the same entries until the loader binds it.
+  uint32_t table = dll.getLookupTableRVA() != 0 ? dll.getLookupTableRVA()
+                                                : dll.getAddressTableRVA();
+  uint64_t next = rvaToOffset(table);
+  uint32_t slot = dll.getAddressTableRVA();
+
+  while (true) {
+    in.seek(next);
+    Word thunk = in.read<Word>();
+    next = in.tell();
+    if (thunk == 0) break;
+    if (remaining-- == 0) {
+      throw std::runtime_error("more than " +
+                               std::to_string(maxImportedFunctions) +
+                               " imported functions");
+    }
+
+    ImportedFunction function;
+    function.setAddressRVA(slot);
+    if (thunk & ordinalFlag) {
+      function.setOrdinal(uint16_t(thunk));
+    } else {
+      uint32_t rva = uint32_t(thunk & 0x7fffffff);
+      in.seek(rvaToOffset(rva));
+      function.setHint(in.read<uint16_t>());
+      function.setName(readName(in, rva + 2));
+    }
+    dll.addFunction(function);
+    slot += sizeof(Word);
+  }
+}
+
+namespace {
+
+// names of PE header values, shared by every PE object. When a value is
+// listed twice the first name is used.
+
+// section Characteristics
+constexpr FlagTable sectionFlags({
+    {0x00000008, "IMAGE_SCN_TYPE_NO_PAD"},
+    {0x00000020, "IMAGE_SCN_CNT_CODE"},
+    {0x00000040, "IMAGE_SCN_CNT_INITIALIZED_DATA"},
+    {0x00000080, "IMAGE_SCN_CNT_UNINITIALIZED_ DATA"},
+    {0x00000100, "IMAGE_SCN_LNK_OTHER"},
+    {0x00000200, "IMAGE_SCN_LNK_INFO"},
+    {0x00000800, "IMAGE_SCN_LNK_REMOVE"},
+    {0x00001000, "IMAGE_SCN_LNK_COMDAT"},
+    {0x00008000, "IMAGE_SCN_GPREL"},
+    {0x00020000, "IMAGE_SCN_MEM_PURGEABLE"},
+    {0x00020000, "IMAGE_SCN_MEM_16BIT"},
+    {0x00040000, "IMAGE_SCN_MEM_LOCKED"},
+    {0x00080000, "IMAGE_SCN_MEM_PRELOAD"},
+    {0x00100000, "IMAGE_SCN_ALIGN_1BYTES"},
+    {0x00200000, "IMAGE_SCN_ALIGN_2BYTES"},
+    {0x00300000, "IMAGE_SCN_ALIGN_4BYTES"},
+    {0x00400000, "IMAGE_SCN_ALIGN_8BYTES"},
+    {0x00500000, "IMAGE_SCN_ALIGN_16BYTES"},
+    {0x00600000, "IMAGE_SCN_ALIGN_32BYTES"},
+    {0x00700000, "IMAGE_SCN_ALIGN_64BYTES"},
+    {0x00800000, "IMAGE_SCN_ALIGN_128BYTES"},
+    {0x00900000, "IMAGE_SCN_ALIGN_256BYTES"},
+    {0x00A00000, "IMAGE_SCN_ALIGN_512BYTES"},
+    {0x00B00000, "IMAGE_SCN_ALIGN_1024BYTES"},
+    {0x00C00000, "IMAGE_SCN_ALIGN_2048BYTES"},
+    {0x00D00000, "IMAGE_SCN_ALIGN_4096BYTES"},
+    {0x00E00000, "IMAGE_SCN_ALIGN_8192BYTES"},
+    {0x01000000, "IMAGE_SCN_LNK_NRELOC_OVFL"},
+    {0x02000000, "IMAGE_SCN_MEM_DISCARDABLE"},
+    {0x04000000, "IMAGE_SCN_MEM_NOT_CACHED"},
+    {0x08000000, "IMAGE_SCN_MEM_NOT_PAGED"},
+    {0x10000000, "IMAGE_SCN_MEM_SHARED"},
+    {0x20000000, "IMAGE_SCN_MEM_EXECUTE"},
+    {0x40000000, "IMAGE_SCN_MEM_READ"},
+    {0x80000000, "IMAGE_SCN_MEM_WRITE"},
+});
+
+// file header Characteristics
+constexpr FlagTable fileFlags({
+    {0x0001, "IMAGE_FILE_RELOCS_STRIPPED"},
+    {0x0002, "IMAGE_FILE_EXECUTABLE_IMAGE"},
+    {0x0004, "IMAGE_FILE_LINE_NUMS_STRIPPED"},
+    {0x0008, "IMAGE_FILE_LOCAL_SYMS_STRIPPED"},
+    {0x0010, "IMAGmapPEFlagTypes.E_FILE_AGGRESSIVE_WS_TRIM"},
+    {0x0020, "IMAGE_FILE_LARGE_ADDRESS_AWARE"},
+    {0x0080, "IMAGE_FILE_BYTES_REVERSED_LO"},
+    {0x0100, "IMAGE_FILE_32BIT_MACHINE"},
+    {0x0200, "IMAGE_FILE_DEBUG_STRIPPED"},
+    {0x0400, "IMAGE_FILE_REMOVABLE_RUN_FROM_SWAP"},
+    {0x0800, "IMAGE_FILE_NET_RUN_FROM_SWAP"},
+    {0x1000, "IMAGE_FILE_SYSTEM"},
+    {0x2000, "IMAGE_FILE_DLL"},
+    {0x4000, "IMAGE_FILE_UP_SYSTEM_ONLY"},
+    {0x8000, "IMAGE_FILE_BYTES_REVERSED_HI"},
+});
+
+// DllCharacteristics
+constexpr FlagTable dllCharacteristics({
+    {0x0020, "IMAGE_DLLCHARACTERISTICS_HIGH_ENTROPY_VA"},
+    {0x0040, "IMAGE_DLLCHARACTERISTICS_DYNAMIC_BASE"},
+    {0x0080, "IMAGE_DLLCHARACTERISTICS_FORCE_INTEGRITY"},
+    {0x0100, "IMAGE_DLLCHARACTERISTICS_NX_COMPAT"},
+    {0x0200, "IMAGE_DLLCHARACTERISTICS_NO_ISOLATION"},
+    {0x0400, "IMAGE_DLLCHARACTERISTICS_NO_SEH"},
+    {0x0800, "IMAGE_DLLCHARACTERISTICS_NO_BIND"},
+    {0x1000, "IMAGE_DLLCHARACTERISTICS_APPCONTAINER"},
+    {0x2000, "IMAGE_DLLCHARACTERISTICS_WDM_DRIVER"},
+    {0x4000, "IMAGE_DLLCHARACTERISTICS_GUARD_CF"},
+    {0x8000, "IMAGE_DLLCHARACTERISTICS_TERMINAL_SERVER_AWARE"},
+});
+
+// Machine
+constexpr FlagTable machineTypes({
+    {0x0, "IMAGE_FILE_MACHINE_UNKNOWN"},
+    {0x200, "IMAGE_FILE_MACHINE_IA64"},
+    {0x14c, "IMAGE_FILE_MACHINE_I386"},
+    {0x8664, "IMAGE_FILE_MACHINE_AMD64"},
+    {0x1c0, "IMAGE_FILE_MACHINE_ARM"},
+    {0xaa64, "IMAGE_FILE_MACHINE_ARM64"},
+    {0x1c4, "IMAGE_FILE_MACHINE_ARMNT"},
+    {0xebc, "IMAGE_FILE_MACHINE_EBC"},
+});
+
+// Subsystem
+constexpr FlagTable subsystems({
+    {0, "IMAGE_SUBSYSTEM_UNKNOWN"},
+    {1, "IMAGE_SUBSYSTEM_NATIVE"},
+    {2, "IMAGE_SUBSYSTEM_WINDOWS_GUI"},
+    {3, "IMAGE_SUBSYSTEM_WINDOWS_CUI"},
+    {5, "IMAGE_SUBSYSTEM_OS2_CUI"},
+    {7, "IMAGE_SUBSYSTEM_POSIX_CUI"},
+    {8, "IMAGE_SUBSYSTEM_NATIVE_WINDOWS"},
+    {9, "IMAGE_SUBSYSTEM_WINDOWS_CE_GUI"},
+    {10, "IMAGE_SUBSYSTEM_EFI_APPLICATION"},
+    {11, "IMAGE_SUBSYSTEM_EFI_BOOT_SERVICE_DRIVER"},
+    {12, "IMAGE_SUBSYSTEM_EFI_RUNTIME_DRIVER"},
+    {13, "IMAGE_SUBSYSTEM_EFI_ROM"},
+    {14, "IMAGE_SUBSYSTEM_XBOX"},
+    {16, "IMAGE_SUBSYSTEM_WINDOWS_BOOT_APPLICATION"},
+});
+
+}  // namespace
+
+
+/**
+ * @brief Returns the name of a PE header value.
+ *
+ * @param table which kind of value it is, one of peMaps.
+ * @param value the value, single flag bits are named individually.
+ *
+ * @return the name, or an empty view for unknown values.
+ */
+std::string_view PE::getFlagName(uint32_t table, uint64_t value) {
+  switch (table) {
+    case SECTIONFLAGS: return sectionFlags.find(value);
+    case FILEFLAGS: return fileFlags.find(value);
+    case DLLCHARACTERISTICS: return dllCharacteristics.find(value);
+    case MACHINETYPE: return machineTypes.find(value);
+    case SUBSYSTEM: return subsystems.find(value);
+  }
+  return {};
 }
 
 uint16_t PE::getDosMagic() const {
@@ -342,8 +626,939 @@ uint64_t PE::getImageBase() const {
 PESection PE::getSection(uint16_t sec) const {
   return this->sections[sec];
 }
+DataDirectory PE::getDataDirectory(uint32_t dir) const {
+  return this->dataDir[dir];
+}
+const std::vector<ImportDirectory>& PE::getImports() const {
+  return this->importDirectory;
+}
+
+/**
+ * @brief Tells why an optional directory couldn't be read.
+ *
+ * @param dir the directory, one of dataDirectories.
+ *
+ * @return the error, or an Error without code when the directory was read
+ * or isn't read while parsing.
+ */
+Error PE::getDirectoryError(uint32_t dir) const {
+  auto found = directoryErrors.find(dir);
+  return found == directoryErrors.end() ? Error() : found->second;
+}
+const ExportDirectory& PE::getExports() const {
+  return this->exportDirectory;
+}
+
+/**
+ * @brief Returns the root of the resource tree, the types table. Nothing
+ * more is read until the tree is walked, and the image has to stay
+ * available until then.
+ *
+ * @param image bytes holding the image this object was parsed from.
+ * @param base offset of the image inside the buffer, as given to init().
+ *
+ * @return the root table, empty if the image has no resources.
+ */
+ResourceDirectory PE::getResources(std::span<const std::byte> image,
+                                   uint64_t base) const {
+  if (dataDir.size() <= RESOURCE_TABLE ||
+      dataDir[RESOURCE_TABLE].getVA() == 0 ||
+      dataDir[RESOURCE_TABLE].getOffset() == SectionIndex::noOffset) {
+    return {};
+  }
+
+  ByteReader in(image, base);
+  in.seek(dataDir[RESOURCE_TABLE].getOffset());
+  const uint8_t* root = in.read_bytes(16);
+  return ResourceDirectory(root, in.size() - dataDir[RESOURCE_TABLE].getOffset(),
+                           0);
+}
+
+/**
+ * @brief Finds the version resource and decodes it, the rest of the
+ * resource tree isn't read.
+ *
+ * @param image bytes holding the image this object was parsed from.
+ * @param base offset of the image inside the buffer, as given to init().
+ *
+ * @return the version information, empty if the image has none.
+ */
+VersionInfo PE::getVersionInfo(std::span<const std::byte> image,
+                               uint64_t base) const {
+  VersionInfo info;
+  ResourceEntry leaf = getResources(image, base).lookup(RT_VERSION);
+  if (!leaf) return info;
+
+  ResourceData data = leaf.getData();
+  ByteReader in(image, base);
+  in.seek(rvaToOffset(data.getDataRVA()));
+  info.decode(in.read_bytes(data.getSize()), data.getSize());
+  return info;
+}
+
+/**
+ * @brief Locates a data directory's content in the image and bounds checks
+ * all of it.
+ *
+ * @param in A ByteReader over the image this object was parsed from.
+ * @param dir which directory, one of dataDirectories.
+ *
+ * @return pointer to the directory's first byte, nullptr if the image
+ * doesn't have it.
+ */
+const uint8_t* PE::directoryData(ByteReader& in, uint32_t dir) const {
+  if (dataDir.size() <= dir || dataDir[dir].getVA() == 0 ||
+      dataDir[dir].getSize() == 0) {
+    return nullptr;
+  }
+  in.seek(rvaToOffset(dataDir[dir].getVA()));
+  return in.read_bytes(dataDir[dir].getSize());
+}
+
+/**
+ * @brief Returns the blocks of the base relocation directory, they are
+ * decoded one by one while iterating and nothing is copied.
+ *
+ * @param image bytes holding the image this object was parsed from.
+ * @param base offset of the image inside the buffer, as given to init().
+ *
+ * @return the blocks, empty if the image has no relocations.
+ */
+RelocationRange PE::getRelocations(std::span<const std::byte> image,
+                                   uint64_t base) const {
+  ByteReader in(image, base);
+  const uint8_t* first = directoryData(in, BASE_RELOCATION_TABLE);
+  if (first == nullptr) return {};
+  return RelocationRange(first, dataDir[BASE_RELOCATION_TABLE].getSize());
+}
+
+/**
+ * @brief Reads the TLS directory, its callbacks are read while iterating.
+ *
+ * @param image bytes holding the image this object was parsed from.
+ * @param base offset of the image inside the buffer, as given to init().
+ *
+ * @return the directory, empty if the image has none.
+ */
+TlsDirectory PE::getTls(std::span<const std::byte> image,
+                        uint64_t base) const {
+  ByteReader in(image, base);
+  if (optionalHeaderMagic_u16 == OPTIONAL_IMAGE_PE32_plus) {
+    return readTls<uint64_t>(in);
+  }
+  return readTls<uint32_t>(in);
+}
+
+/**
+ * @brief Reads the TLS directory of a PE32 (Word is uint32_t) or PE32+
+ * (uint64_t) image. The callback array is only scanned for its end.
+ *
+ * @param in A ByteReader over the image.
+ *
+ * @return the directory, empty if the image has none.
+ */
+template <typename Word>
+TlsDirectory PE::readTls(ByteReader& in) const {
+  TlsDirectory tls;
+  if (directoryData(in, TLS_TABLE) == nullptr) return tls;
+
+  // linkers don't always get the directory's size right, the structure is
+  // read whole whatever it says.
+  in.seek(rvaToOffset(dataDir[TLS_TABLE].getVA()));
+  tls.decode<Word>(in.read_bytes(4 * sizeof(Word) + 8));
+
+  if (tls.getAddressOfCallBacks() != 0) {
+    in.seek(rvaToOffset(vaToRVA(tls.getAddressOfCallBacks())));
+    const uint8_t* first = in.data() + in.tell();
+    uint64_t count = 0;
+    while (in.read<Word>() != 0) count++;
+    tls.setCallbacks(
+        RecordRange<AddressEntry>(first, count, sizeof(Word), sizeof(Word)));
+  }
+  return tls;
+}
+
+/**
+ * @brief Reads the load configuration directory, the SafeSEH and CFG
+ * tables are bounds checked here and read while iterating.
+ *
+ * @param image bytes holding the image this object was parsed from.
+ * @param base offset of the image inside the buffer, as given to init().
+ *
+ * @return the directory, empty if the image has none.
+ */
+LoadConfig PE::getLoadConfig(std::span<const std::byte> image,
+                             uint64_t base) const {
+  ByteReader in(image, base);
+  if (optionalHeaderMagic_u16 == OPTIONAL_IMAGE_PE32_plus) {
+    return readLoadConfig<uint64_t>(in);
+  }
+  return readLoadConfig<uint32_t>(in);
+}
+
+/**
+ * @brief Reads the load configuration directory of a PE32 (Word is
+ * uint32_t) or PE32+ (uint64_t) image.
+ *
+ * @param in A ByteReader over the image.
+ *
+ * @return the directory, empty if the image has none.
+ */
+template <typename Word>
+LoadConfig PE::readLoadConfig(ByteReader& in) const {
+  LoadConfig config;
+  if (directoryData(in, LOAD_CONFIG_TABLE) == nullptr) return config;
+
+  // the structure starts with its own size, which may differ from the
+  // directory's.
+  in.seek(rvaToOffset(dataDir[LOAD_CONFIG_TABLE].getVA()));
+  uint32_t size = in.read<uint32_t>();
+  in.seek(in.tell() - 4);
+  config.decode<Word>(in.read_bytes(size), size);
+
+  if (config.getSEHandlerTable() != 0 && config.getSEHandlerCount() != 0) {
+    in.seek(rvaToOffset(vaToRVA(config.getSEHandlerTable())));
+    const uint8_t* table = in.read_table(config.getSEHandlerCount(), 4);
+    config.setSafeSehHandlers(
+        RecordRange<AddressEntry>(table, config.getSEHandlerCount(), 4, 4));
+  }
+
+  if (config.getGuardCFFunctionTable() != 0 &&
+      config.getGuardCFFunctionCount() != 0) {
+    // each RVA is followed by as many flag bytes as the top 4 bits of
+    // GuardFlags say.
+    uint64_t stride = 4 + (config.getGuardFlags() >> 28);
+    in.seek(rvaToOffset(vaToRVA(config.getGuardCFFunctionTable())));
+    const uint8_t* table =
+        in.read_table(config.getGuardCFFunctionCount(), stride);
+    config.setGuardCFFunctions(RecordRange<AddressEntry>(
+        table, config.getGuardCFFunctionCount(), stride, 4));
+  }
+  return config;
+}
+
+/**
+ * @brief Translates a VA, as stored in TLS and load config directories, to
+ * an RVA.
+ *
+ * @param va address including the image base.
+ *
+ * @return the RVA, throws std::runtime_error when the address is outside
+ * the image.
+ */
+uint32_t PE::vaToRVA(uint64_t va) const {
+  if (va < imageBase_u64 || va - imageBase_u64 > UINT32_MAX) {
+    std::ostringstream message;
+    message << "VA 0x" << std::hex << va << " is outside of the image";
+    throw std::runtime_error(message.str());
+  }
+  return uint32_t(va - imageBase_u64);
+}
+
+/**
+ * @brief Returns the attribute certificate table's entries, they are
+ * decoded one by one while iterating and nothing is copied. The table is
+ * found by file offset, it isn't mapped by the loader.
+ *
+ * @param image bytes holding the image this object was parsed from.
+ * @param base offset of the image inside the buffer, as given to init().
+ *
+ * @return the entries, empty if the image isn't signed.
+ */
+CertificateRange PE::getCertificates(std::span<const std::byte> image,
+                                     uint64_t base) const {
+  if (dataDir.size() <= CERTIFICATE_TABLE ||
+      dataDir[CERTIFICATE_TABLE].getVA() == 0 ||
+      dataDir[CERTIFICATE_TABLE].getSize() == 0) {
+    return {};
+  }
+
+  ByteReader in(image, base);
+  in.seek(dataDir[CERTIFICATE_TABLE].getOffset());
+  const uint8_t* first = in.read_bytes(dataDir[CERTIFICATE_TABLE].getSize());
+  return CertificateRange(first, dataDir[CERTIFICATE_TABLE].getSize());
+}
+
+/**
+ * @brief Returns the parts of the file the Authenticode digest skips: the
+ * CheckSum field, the certificate table's data directory entry and the
+ * certificate table itself. Everything else, headers, sections and any
+ * data past them, is hashed in file order.
+ *
+ * @return {offset, size} pairs relative to the image's start, in file
+ * order. Entries that don't exist in this image have a size of 0.
+ */
+std::array<std::pair<uint64_t, uint64_t>, 3> PE::getAuthenticodeGaps() const {
+  std::array<std::pair<uint64_t, uint64_t>, 3> gaps{};
+  uint64_t optionalHeader = uint64_t(e_lfanew_u32) + 24;
+  gaps[0] = {optionalHeader + 64, 4};
+
+  if (dataDir.size() > CERTIFICATE_TABLE) {
+    uint64_t directories =
+        optionalHeader +
+        (optionalHeaderMagic_u16 == OPTIONAL_IMAGE_PE32_plus ? 112 : 96);
+    gaps[1] = {directories + CERTIFICATE_TABLE * 8, 8};
+    if (dataDir[CERTIFICATE_TABLE].getVA() != 0) {
+      gaps[2] = {dataDir[CERTIFICATE_TABLE].getOffset(),
+                 dataDir[CERTIFICATE_TABLE].getSize()};
+    }
+  }
+  return gaps;
+}
+
+/**
+ * @brief Translates an RVA into an offset in the file.
+ *
+ * @param rva address relative to the image base.
+ *
+ * @return the file offset, throws std::runtime_error when the address
+ * isn't backed by any byte of the file.
+ */
+uint64_t PE::rvaToOffset(uint32_t rva) const {
+  uint64_t offset = sectionIndex.toOffset(rva);
+  if (offset == SectionIndex::noOffset) {
+    std::ostringstream message;
+    message << "RVA 0x" << std::hex << rva << " is not mapped from the file";
+    throw std::runtime_error(message.str());
+  }
+  return offset;
+}
+
+/**
+ * @brief Makes room for the functions and names about to be added. Counts
+ * come from the file, they have to be checked against the image first.
+ *
+ * @param functionCount number of address table entries, 0 to leave as is.
+ * @param nameCount number of names, 0 to leave as is.
+ *
+ * @return none.
+ */
+void ExportDirectory::reserve(uint32_t functionCount, uint32_t nameCount) {
+  functions.reserve(functionCount);
+  names.reserve(nameCount);
+}
+
+/**
+ * @brief Adds an exported function, they must be added in ordinal order.
+ *
+ * @param function the function.
+ *
+ * @return none.
+ */
+void ExportDirectory::addFunction(const ExportedFunction& function) {
+  functions.push_back(function);
+}
+
+/**
+ * @brief Adds a name to the index, buildIndex() has to be called once all
+ * names are added.
+ *
+ * @param name the exported name.
+ * @param ordinal ordinal of the function it names.
+ *
+ * @return none.
+ */
+void ExportDirectory::addName(std::string_view name, uint32_t ordinal) {
+  names.emplace_back(name, ordinal);
+}
+
+/**
+ * @brief Sorts the name index and gives every function its first name.
+ * Linkers already write names in order, so sorting is usually skipped.
+ *
+ * @return none.
+ */
+void ExportDirectory::buildIndex() {
+  for (auto name = names.rbegin(); name != names.rend(); ++name) {
+    size_t idx = position(name->second);
+    if (idx != functions.size()) functions[idx].setName(name->first);
+  }
 
-void DataDirectory::setOffset(uint32_t offset) {
+  if (!std::is_sorted(names.begin(), names.end())) {
+    std::sort(names.begin(), names.end());
+  }
+}
+
+/**
+ * @brief Finds an exported function by name.
+ *
+ * @param name the exported name, case sensitive.
+ *
+ * @return the function, nullptr if nothing is exported under that name.
+ */
+const ExportedFunction* ExportDirectory::findByName(std::string_view name) const {
+  auto found = std::lower_bound(
+      names.begin(), names.end(), name,
+      [](const std::pair<std::string_view, uint32_t>& entry,
+         std::string_view value) { return entry.first < value; });
+  if (found == names.end() || found->first != name) return nullptr;
+  return findByOrdinal(found->second);
+}
+
+/**
+ * @brief Finds an exported function by ordinal.
+ *
+ * @param ordinal the ordinal, ordinal base included.
+ *
+ * @return the function, nullptr if the ordinal isn't used.
+ */
+const ExportedFunction* ExportDirectory::findByOrdinal(uint32_t ordinal) const {
+  size_t idx = position(ordinal);
+  return idx == functions.size() ? nullptr : &functions[idx];
+}
+
+/**
+ * @brief Finds where a function is kept. Address tables rarely have unused
+ * ordinals, then the function is right at ordinal - base and no search is
+ * needed.
+ *
+ * @param ordinal the ordinal, ordinal base included.
+ *
+ * @return index into functions, functions.size() if the ordinal isn't used.
+ */
+size_t ExportDirectory::position(uint32_t ordinal) const {
+  uint32_t guess = ordinal - ordinalBase_u32;
+  if (guess < functions.size() && functions[guess].getOrdinal() == ordinal) {
+    return guess;
+  }
+
+  auto found = std::lower_bound(
+      functions.begin(), functions.end(), ordinal,
+      [](const ExportedFunction& function, uint32_t value) {
+        return function.getOrdinal() < value;
+      });
+  if (found == functions.end() || found->getOrdinal() != ordinal) {
+    return functions.size();
+  }
+  return size_t(found - functions.begin());
+}
+
+namespace {
+
+/**
+ * @brief Returns the length of a NUL terminated UTF-16 string.
+ *
+ * @param text first code unit.
+ * @param limit most code units that may be read.
+ *
+ * @return number of code units before the NUL, at most limit.
+ */
+uint64_t utf16Length(const uint8_t* text, uint64_t limit) {
+  uint64_t units = 0;
+  while (units < limit && (text[units * 2] | text[units * 2 + 1]) != 0) {
+    units++;
+  }
+  return units;
+}
+
+/**
+ * @brief Converts UTF-16LE text, as Windows stores resource strings, to
+ * UTF-8. Unpaired surrogates become U+FFFD.
+ *
+ * @param text first code unit.
+ * @param units number of code units.
+ *
+ * @return the text in UTF-8.
+ */
+std::string utf16ToUtf8(const uint8_t* text, uint64_t units) {
+  std::string out;
+  out.reserve(units);
+  for (uint64_t idx = 0; idx < units; idx++) {
+    uint32_t code = ByteReader::decode<uint16_t>(text + idx * 2);
+    if (code >= 0xd800 && code < 0xe000) {
+      uint32_t low = idx + 1 < units
+                         ? ByteReader::decode<uint16_t>(text + idx * 2 + 2)
+                         : 0;
+      if (code < 0xdc00 && low >= 0xdc00 && low < 0xe000) {
+        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+        idx++;
+      } else {
+        code = 0xfffd;
+      }
+    }
+
+    if (code < 0x80) {
+      out.push_back(char(code));
+    } else if (code < 0x800) {
+      out.push_back(char(0xc0 | code >> 6));
+      out.push_back(char(0x80 | (code & 0x3f)));
+    } else if (code < 0x10000) {
+      out.push_back(char(0xe0 | code >> 12));
+      out.push_back(char(0x80 | ((code >> 6) & 0x3f)));
+      out.push_back(char(0x80 | (code & 0x3f)));
+    } else {
+      out.push_back(char(0xf0 | code >> 18));
+      out.push_back(char(0x80 | ((code >> 12) & 0x3f)));
+      out.push_back(char(0x80 | ((code >> 6) & 0x3f)));
+      out.push_back(char(0x80 | (code & 0x3f)));
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief A node of a VS_VERSIONINFO resource: a header of three WORDs (its
+ * length, the length of its value and the value's type), a UTF-16 key, the
+ * value and then child nodes. Key, value and children start on 4 byte
+ * boundaries. Offsets are relative to the start of the resource.
+ */
+struct VersionBlock {
+  uint64_t end = 0;            // one past the block, never past its parent
+  uint16_t valueLength_u16 = 0;
+  uint16_t type_u16 = 0;       // 1 when the value is text
+  const uint8_t* key = nullptr;
+  uint64_t keyUnits = 0;
+  uint64_t value = 0;          // offset of the value
+  uint64_t children = 0;       // offset of the first child
+};
+
+uint64_t align4(uint64_t offset) {
+  return (offset + 3) & ~uint64_t(3);
+}
+
+/**
+ * @brief Reads the header and key of a version block.
+ *
+ * @param data start of the resource.
+ * @param limit end of the parent block, the block must fit before it.
+ * @param start offset of the block.
+ *
+ * @return the block, its end is 'start' when it is too short to be one.
+ */
+VersionBlock readVersionBlock(const uint8_t* data, uint64_t limit,
+                              uint64_t start) {
+  ByteReader in(data, limit);
+  in.seek(start);
+
+  VersionBlock block;
+  uint16_t length = in.read<uint16_t>();
+  block.valueLength_u16 = in.read<uint16_t>();
+  block.type_u16 = in.read<uint16_t>();
+  block.end = std::min<uint64_t>(start + length, limit);
+  if (length < 6 || block.end < in.tell()) {
+    block.end = start;
+    return block;
+  }
+
+  block.key = data + in.tell();
+  block.keyUnits = utf16Length(block.key, (block.end - in.tell()) / 2);
+  block.value = align4(in.tell() + (block.keyUnits + 1) * 2);
+  uint64_t valueBytes = block.type_u16 == 1 ? block.valueLength_u16 * 2ull
+                                            : block.valueLength_u16;
+  block.children = align4(block.value + valueBytes);
+  return block;
+}
+
+bool keyIs(const VersionBlock& block, std::string_view key) {
+  return utf16ToUtf8(block.key, block.keyUnits) == key;
+}
+
+}  // namespace
+
+/**
+ * @brief Reads the header of a resource table, the entries that follow it
+ * are bounds checked here and decoded when they are asked for.
+ *
+ * @param root start of the resource section in the image.
+ * @param rootSize bytes from root to the end of the image.
+ * @param offset offset of the table, relative to root.
+ */
+ResourceDirectory::ResourceDirectory(const uint8_t* root, uint64_t rootSize,
+                                     uint32_t offset)
+    : root(root), rootSize_u64(rootSize), offset_u32(offset) {
+  // 16 byte header: characteristics, time stamp, version, then the counts.
+  ByteReader in(root, rootSize);
+  in.seek(uint64_t(offset) + 12);
+  named_u16 = in.read<uint16_t>();
+  ids_u16 = in.read<uint16_t>();
+  in.read_table(size(), 8);
+}
+
+/**
+ * @brief Returns an entry of the table, named entries come first.
+ *
+ * @param idx position of the entry.
+ *
+ * @return the entry, or an empty one when idx is past the end.
+ */
+ResourceEntry ResourceDirectory::entry(uint32_t idx) const {
+  if (idx >= size()) return {};
+  const uint8_t* entry = root + offset_u32 + 16 + uint64_t(idx) * 8;
+  return ResourceEntry(root, rootSize_u64, ByteReader::decode<uint32_t>(entry),
+                       ByteReader::decode<uint32_t>(entry + 4));
+}
+
+/**
+ * @brief Finds an entry by ID with a binary search, entries identified by
+ * a number are sorted by it.
+ *
+ * @param id resource type, name or language ID.
+ *
+ * @return the entry, or an empty one if the table has no such ID.
+ */
+ResourceEntry ResourceDirectory::find(uint32_t id) const {
+  const uint8_t* entries = root + offset_u32 + 16;
+  uint32_t low = named_u16;
+  uint32_t high = size();
+  while (low < high) {
+    uint32_t mid = low + (high - low) / 2;
+    if (ByteReader::decode<uint32_t>(entries + uint64_t(mid) * 8) < id) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  ResourceEntry found = entry(low);
+  return found && !found.isNamed() && found.getId() == id ? found
+                                                          : ResourceEntry();
+}
+
+/**
+ * @brief Finds an entry by name, named entries are compared one by one.
+ *
+ * @param name the name in UTF-8, case sensitive.
+ *
+ * @return the entry, or an empty one if the table has no such name.
+ */
+ResourceEntry ResourceDirectory::find(std::string_view name) const {
+  for (uint32_t idx = 0; idx < named_u16; idx++) {
+    ResourceEntry found = entry(idx);
+    if (found.getName() == name) return found;
+  }
+  return {};
+}
+
+/**
+ * @brief Goes straight down the type, name and language tables to a leaf,
+ * reading one entry per level.
+ *
+ * @param type resource type, such as PE::RT_VERSION.
+ * @param name resource ID, or anyId for the first one.
+ * @param language language ID, or anyId for the first one.
+ *
+ * @return the leaf, or an empty entry if the path doesn't exist.
+ */
+ResourceEntry ResourceDirectory::lookup(uint32_t type, uint32_t name,
+                                        uint32_t language) const {
+  ResourceEntry found = type == anyId ? entry(0) : find(type);
+  for (uint32_t id : {name, language}) {
+    if (!found || !found.isDirectory()) return {};
+    ResourceDirectory next = found.getDirectory();
+    found = id == anyId ? next.entry(0) : next.find(id);
+  }
+  return found && !found.isDirectory() ? found : ResourceEntry();
+}
+
+/**
+ * @brief Reads the entry's name, a length prefixed UTF-16 string.
+ *
+ * @return the name in UTF-8, empty if the entry has an ID instead.
+ */
+std::string ResourceEntry::getName() const {
+  if (!isNamed()) return {};
+
+  ByteReader in(root, rootSize_u64);
+  in.seek(name_u32 & 0x7fffffff);
+  uint16_t units = in.read<uint16_t>();
+  return utf16ToUtf8(in.read_bytes(units * 2ull), units);
+}
+
+/**
+ * @brief Returns the table the entry leads to.
+ *
+ * @return the table, empty if the entry is a leaf.
+ */
+ResourceDirectory ResourceEntry::getDirectory() const {
+  if (!isDirectory()) return {};
+  return ResourceDirectory(root, rootSize_u64, target_u32 & 0x7fffffff);
+}
+
+/**
+ * @brief Reads the leaf the entry leads to.
+ *
+ * @return RVA, size and code page of the resource, zeros if the entry
+ * leads to a table.
+ */
+ResourceData ResourceEntry::getData() const {
+  if (isDirectory()) return {};
+
+  ByteReader in(root, rootSize_u64);
+  in.seek(target_u32);
+  const uint8_t* leaf = in.read_bytes(16);
+  return ResourceData(ByteReader::decode<uint32_t>(leaf),
+                      ByteReader::decode<uint32_t>(leaf + 4),
+                      ByteReader::decode<uint32_t>(leaf + 8));
+}
+
+/**
+ * @brief Decodes a VS_VERSIONINFO resource: the VS_FIXEDFILEINFO value of
+ * the root block and the strings of the first table in StringFileInfo.
+ *
+ * @param data the resource's bytes.
+ * @param size size of the resource.
+ *
+ * @return none, throws std::runtime_error if it isn't version information.
+ */
+void VersionInfo::decode(const uint8_t* data, uint64_t size) {
+  fileVersion_u64 = 0;
+  productVersion_u64 = 0;
+  strings.clear();
+
+  VersionBlock info = readVersionBlock(data, size, 0);
+  if (info.end == 0 || !keyIs(info, "VS_VERSION_INFO")) {
+    throw std::runtime_error("Not a VS_VERSIONINFO resource");
+  }
+
+  // VS_FIXEDFILEINFO, 52 bytes starting with its signature
+  if (info.valueLength_u16 >= 52 && info.value + 52 <= info.end) {
+    const uint8_t* fixed = data + info.value;
+    if (ByteReader::decode<uint32_t>(fixed) == 0xfeef04bd) {
+      fileVersion_u64 = uint64_t(ByteReader::decode<uint32_t>(fixed + 8)) << 32 |
+                        ByteReader::decode<uint32_t>(fixed + 12);
+      productVersion_u64 =
+          uint64_t(ByteReader::decode<uint32_t>(fixed + 16)) << 32 |
+          ByteReader::decode<uint32_t>(fixed + 20);
+    }
+  }
+
+  for (uint64_t child = info.children; child + 6 <= info.end;) {
+    VersionBlock fileInfo = readVersionBlock(data, info.end, child);
+    if (fileInfo.end == child) break;
+
+    if (keyIs(fileInfo, "StringFileInfo") &&
+        fileInfo.children + 6 <= fileInfo.end) {
+      VersionBlock table =
+          readVersionBlock(data, fileInfo.end, fileInfo.children);
+      for (uint64_t next = table.children; next + 6 <= table.end;) {
+        VersionBlock text = readVersionBlock(data, table.end, next);
+        if (text.end == next) break;
+
+        // the value length counts UTF-16 units, the NUL included or not.
+        uint64_t units = 0;
+        if (text.value < text.end) {
+          units = utf16Length(data + text.value,
+                              std::min<uint64_t>(text.valueLength_u16,
+                                                 (text.end - text.value) / 2));
+        }
+        strings.emplace_back(utf16ToUtf8(text.key, text.keyUnits),
+                             utf16ToUtf8(data + text.value, units));
+        next = align4(text.end);
+      }
+      break;
+    }
+    child = align4(fileInfo.end);
+  }
+}
+
+/**
+ * @brief Returns one of the version strings.
+ *
+ * @param key the string's name, such as "FileVersion" or "CompanyName".
+ *
+ * @return its value in UTF-8, empty if the resource doesn't have it.
+ */
+std::string_view VersionInfo::getString(std::string_view key) const {
+  for (const auto& [name, value] : strings) {
+    if (name == key) return value;
+  }
+  return {};
+}
+
+/**
+ * @brief Starts at a block, or at the end when no block fits there.
+ *
+ * @param at the block.
+ * @param last end of the base relocation directory.
+ */
+RelocationRange::iterator::iterator(const uint8_t* at, const uint8_t* last)
+    : at(at), last(last) {
+  settle();
+}
+
+/**
+ * @brief Moves to the next block.
+ *
+ * @return this iterator.
+ */
+RelocationRange::iterator& RelocationRange::iterator::operator++() {
+  at += size_u32;
+  settle();
+  return *this;
+}
+
+/**
+ * @brief Reads the size of the block the iterator is at. A block that runs
+ * past the directory is cut short, a block smaller than its header ends
+ * the iteration (it's padding or garbage).
+ */
+void RelocationRange::iterator::settle() {
+  uint64_t left = uint64_t(last - at);
+  uint32_t size = left >= 8 ? ByteReader::decode<uint32_t>(at + 4) : 0;
+  if (size < 8) {
+    at = last;
+    size_u32 = 0;
+    return;
+  }
+  size_u32 = uint32_t(std::min<uint64_t>(size, left));
+}
+
+/**
+ * @brief Creates an iterator over certificate entries.
+ *
+ * @param at the first entry.
+ * @param last end of the certificate table.
+ */
+CertificateRange::iterator::iterator(const uint8_t* at, const uint8_t* last)
+    : at(at), last(last) {
+  settle();
+}
+
+/**
+ * @brief Moves to the next entry, which starts on the next 8 byte
+ * boundary.
+ *
+ * @return this iterator.
+ */
+CertificateRange::iterator& CertificateRange::iterator::operator++() {
+  uint64_t step = (uint64_t(size_u32) + 7) & ~uint64_t(7);
+  at += std::min<uint64_t>(step, uint64_t(last - at));
+  settle();
+  return *this;
+}
+
+/**
+ * @brief Reads the length of the entry the iterator is at. An entry that
+ * runs past the table is cut short, one smaller than its header ends the
+ * iteration.
+ */
+void CertificateRange::iterator::settle() {
+  uint64_t left = uint64_t(last - at);
+  uint32_t size = left >= 8 ? ByteReader::decode<uint32_t>(at) : 0;
+  if (size < 8) {
+    at = last;
+    size_u32 = 0;
+    return;
+  }
+  size_u32 = uint32_t(std::min<uint64_t>(size, left));
+}
+
+/**
+ * @brief Decodes the TLS directory's fields, Word is uint32_t for PE32 and
+ * uint64_t for PE32+ images.
+ *
+ * @param entry the directory, 4 Words and 8 bytes long.
+ *
+ * @return none.
+ */
+template <typename Word>
+void TlsDirectory::decode(const uint8_t* entry) {
+  present_b = true;
+  startOfRawData_u64 = ByteReader::decode<Word>(entry);
+  endOfRawData_u64 = ByteReader::decode<Word>(entry + sizeof(Word));
+  addressOfIndex_u64 = ByteReader::decode<Word>(entry + 2 * sizeof(Word));
+  addressOfCallBacks_u64 = ByteReader::decode<Word>(entry + 3 * sizeof(Word));
+  sizeOfZeroFill_u32 = ByteReader::decode<uint32_t>(entry + 4 * sizeof(Word));
+  characteristics_u32 =
+      ByteReader::decode<uint32_t>(entry + 4 * sizeof(Word) + 4);
+}
+
+/**
+ * @brief Decodes the load configuration fields that fit in the structure's
+ * size, Word is uint32_t for PE32 and uint64_t for PE32+ images. Up to
+ * ProcessAffinityMask the fields are 24 bytes and 6 Words, then come 8
+ * bytes of heap flags, CSD version and reserved space.
+ *
+ * @param entry the structure.
+ * @param size its size, from its first field.
+ *
+ * @return none.
+ */
+template <typename Word>
+void LoadConfig::decode(const uint8_t* entry, uint32_t size) {
+  constexpr uint64_t W = sizeof(Word);
+  auto word = [entry, size](uint64_t offset) -> uint64_t {
+    return offset + W <= size ? ByteReader::decode<Word>(entry + offset) : 0;
+  };
+
+  size_u32 = size;
+  timeStamp_u32 = size >= 8 ? ByteReader::decode<uint32_t>(entry + 4) : 0;
+  securityCookie_u64 = word(32 + 7 * W);
+  seHandlerTable_u64 = word(32 + 8 * W);
+  seHandlerCount_u64 = word(32 + 9 * W);
+  guardCFCheckFunctionPointer_u64 = word(32 + 10 * W);
+  guardCFFunctionTable_u64 = word(32 + 12 * W);
+  guardCFFunctionCount_u64 = word(32 + 13 * W);
+  guardFlags_u32 = 32 + 14 * W + 4 <= size
+                       ? ByteReader::decode<uint32_t>(entry + 32 + 14 * W)
+                       : 0;
+}
+
+/**
+ * @brief Sorts the sections' address ranges. Where sections overlap, a
+ * range is cut short at the start of the next one so that every RVA falls
+ * in at most one range.
+ *
+ * @param sections the section table.
+ * @param sizeOfHeaders size of the headers, RVAs below the first section
+ * and inside the headers map to the same file offset.
+ *
+ * @return none.
+ */
+void SectionIndex::build(const std::vector<PESection>& sections,
+                         uint32_t sizeOfHeaders) {
+  ranges.clear();
+  ranges.reserve(sections.size());
+  sizeOfHeaders_u32 = sizeOfHeaders;
+
+  for (const PESection& section : sections) {
+    // the loader maps VirtualSize bytes, or the raw size when it's zero.
+    uint32_t mapped = section.getVirtualSize() != 0 ? section.getVirtualSize()
+                                                    : section.getRawDataSize();
+    if (mapped == 0) continue;
+
+    uint64_t end = uint64_t(section.getVirtualAddress()) + mapped;
+    ranges.push_back({section.getVirtualAddress(),
+                      uint32_t(std::min<uint64_t>(end, UINT32_MAX)),
+                      section.getRawDataPointer(),
+                      std::min(mapped, section.getRawDataSize())});
+  }
+
+  std::sort(ranges.begin(), ranges.end(),
+            [](const Range& a, const Range& b) {
+              return a.start_u32 < b.start_u32;
+            });
+  for (size_t idx = 1; idx < ranges.size(); idx++) {
+    ranges[idx - 1].end_u32 =
+        std::min(ranges[idx - 1].end_u32, ranges[idx].start_u32);
+  }
+}
+
+/**
+ * @brief Finds the file offset of an RVA with a binary search over the
+ * sections' ranges.
+ *
+ * @param rva address relative to the image base.
+ *
+ * @return the file offset, noOffset when the RVA is outside every section
+ * or in the zero filled tail of one.
+ */
+uint64_t SectionIndex::toOffset(uint32_t rva) const {
+  auto after = std::upper_bound(
+      ranges.begin(), ranges.end(), rva,
+      [](uint32_t value, const Range& range) { return value < range.start_u32; });
+
+  if (after == ranges.begin()) {
+    return rva < sizeOfHeaders_u32 ? rva : noOffset;
+  }
+
+  const Range& range = *(after - 1);
+  uint32_t delta = rva - range.start_u32;
+  if (rva >= range.end_u32 || delta >= range.rawSize_u32) return noOffset;
+  return uint64_t(range.rawStart_u32) + delta;
+}
+
+void DataDirectory::setOffset(uint64_t offset) {
   this->offset = offset;
 }
 void DataDirectory::setVirtualAddress(uint32_t va) {
@@ -363,29 +1578,85 @@ uint32_t DataDirectory::getSize() const {
   return this->size;
 }
 
-void PE::printPE() {
+void PE::printPE(OutputBuffer& out) const {
   using namespace std;
 
-  cout << "Parsed info: \n\n";
+  out << "Parsed info: \n\n";
   // print magic bytes
-  cout << "Magic bytes: 0x" << hex << getDosMagic() << endl;
+  out << "Magic bytes: 0x" << hex << getDosMagic() << endl;
 
   // print PE offset
-  cout << "PE offset: 0x" << hex << getElfanew() << endl;
+  out << "PE offset: 0x" << hex << getElfanew() << endl;
 
   // print number of section
-  cout << "Number of sections: " << getNumberOfSections() << endl;
+  out << "Number of sections: " << getNumberOfSections() << endl;
 
   // print characteristics
-  cout << "Characteristics: 0x" << hex << getCharacteristics() << endl
+  out << "Characteristics: 0x" << hex << getCharacteristics() << endl
        << endl;
 
   // print sections information
   for (uint32_t idx = 0; idx < numberOfSections_u16 ; idx++) {
-    cout << "Name: " << sections[idx].getName() << endl;
-    cout << " Virtual size: 0x" << hex << sections[idx].getVirtualSize() << endl;
-    cout << " Virtual Address: 0x" << hex << sections[idx].getVirtualAddress() << endl;
-    cout << " Characteristics: 0x" << hex << sections[idx].getCharacteristics();
-    cout << endl << endl;
+    out << "Name: " << sections[idx].getName() << endl;
+    out << " Virtual size: 0x" << hex << sections[idx].getVirtualSize() << endl;
+    out << " Virtual Address: 0x" << hex << sections[idx].getVirtualAddress() << endl;
+    out << " Characteristics: 0x" << hex << sections[idx].getCharacteristics();
+    out << endl << endl;
+  }
+
+  // directories read while parsing that turned out damaged
+  for (const auto& [dir, error] : directoryErrors) {
+    out << (dir == IMPORT_TABLE ? "Import" : "Export")
+        << " table not read: " << error.message << endl;
+  }
+}
+
+/**
+ * @brief Prints the imported DLLs and their functions, by name or by
+ * ordinal.
+ *
+ * @param out A buffer to print to.
+ *
+ * @return none.
+ */
+void PE::printImports(OutputBuffer& out) const {
+  using namespace std;
+
+  for (const ImportDirectory& dll : importDirectory) {
+    out << "Import: " << dll.getName() << endl;
+    for (const ImportedFunction& function : dll.getFunctions()) {
+      if (function.isByOrdinal()) {
+        out << " Ordinal: " << dec << function.getOrdinal() << endl;
+      } else {
+        out << " " << function.getName() << " (hint " << dec
+            << function.getHint() << ")" << endl;
+      }
+    }
+    out << endl;
+  }
+}
+
+/**
+ * @brief Prints the exported functions in ordinal order, with their first
+ * name and either their RVA or what they are forwarded to.
+ *
+ * @param out A buffer to print to.
+ *
+ * @return none.
+ */
+void PE::printExports(OutputBuffer& out) const {
+  using namespace std;
+
+  if (exportDirectory.getFunctions().empty()) return;
+  out << "Export: " << exportDirectory.getName() << endl;
+  for (const ExportedFunction& function : exportDirectory.getFunctions()) {
+    out << " " << dec << function.getOrdinal() << " "
+        << (function.getName().empty() ? "(no name)" : function.getName());
+    if (function.isForwarded()) {
+      out << " -> " << function.getForwarder() << endl;
+    } else {
+      out << " 0x" << hex << function.getAddressRVA() << endl;
+    }
   }
+  out << endl;
 }
\ No newline at end of file
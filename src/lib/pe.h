@@ -26,7 +26,7 @@ class DataDirectory {
   DataDirectory() =default;
   ~DataDirectory()=default;
 
-  void setOffset(uint32_t);
+  void setOffset(uint64_t);
   void setVirtualAddress(uint32_t);
   void setSize(uint32_t);
 
@@ -52,9 +52,8 @@ class PESection {
   PESection() =default;
   ~PESection() =default;
 
-  void setName(std::ifstream& in) {
-    for (int idx = 0; idx < 8; idx++)
-      name.insert(idx, 1, in.get());
+  void setName(const uint8_t* entry) {
+    name.assign(reinterpret_cast<const char*>(entry), 8);
   }
   void setVirtualSize(uint32_t vsz) { this->virtualSize_u32 = vsz; }
   void setVirtualAddress(uint32_t va) { this->virtualAddr_u32 = va; }
@@ -73,6 +72,8 @@ class PESection {
   std::string getName() const { return this->name; }
   uint32_t getVirtualSize() const { return virtualSize_u32; }
   uint32_t getVirtualAddress() const { return virtualAddr_u32; }
+  uint32_t getRawDataSize() const { return sizeOfRawData_u32; }
+  uint32_t getRawDataPointer() const { return pointerToRawData_u32; }
   uint32_t getCharacteristics() const { return characteristics_u32; }
 
  private:
@@ -91,13 +92,91 @@ class PESection {
 };
 
  
+/**
+ * @brief SectionIndex translates RVAs to file offsets. It is built once per
+ * file from the section table: the sections' address ranges are sorted and
+ * made disjoint, so a lookup is a binary search instead of a walk over
+ * every section.
+ */
+class SectionIndex {
+ public:
+  static constexpr uint64_t noOffset = UINT64_MAX;
+
+  void build(const std::vector<PESection>&, uint32_t);
+  uint64_t toOffset(uint32_t) const;
+
+ private:
+  struct Range {
+    uint32_t start_u32;    // first RVA of the section
+    uint32_t end_u32;      // one past its last RVA
+    uint32_t rawStart_u32; // file offset of the section's first byte
+    uint32_t rawSize_u32;  // bytes backed by the file, the rest is zeros
+  };
+
+  std::vector<Range> ranges;
+  uint32_t sizeOfHeaders_u32 = 0;
+};
+
+ 
+/**
+ * @brief One function imported from a DLL, either by name (with a hint
+ * into the DLL's export name table) or by ordinal.
+ */
+class ImportedFunction {
+ public:
+  ImportedFunction() =default;
+  ~ImportedFunction() =default;
+
+  void setName(std::string_view name) { this->name = name; }
+  void setHint(uint16_t hint) { this->hint_u16 = hint; }
+  void setOrdinal(uint16_t ordinal) {
+    this->ordinal_u16 = ordinal;
+    this->byOrdinal_b = true;
+  }
+  void setAddressRVA(uint32_t rva) { this->addressRVA_u32 = rva; }
+
+  std::string_view getName() const { return name; }
+  uint16_t getHint() const { return hint_u16; }
+  uint16_t getOrdinal() const { return ordinal_u16; }
+  bool isByOrdinal() const { return byOrdinal_b; }
+  uint32_t getAddressRVA() const { return addressRVA_u32; }
+
+ private:
+  std::string_view name;        // empty when imported by ordinal
+  uint32_t addressRVA_u32 = 0;  // RVA of the function's IAT slot
+  uint16_t hint_u16 = 0;
+  uint16_t ordinal_u16 = 0;
+  bool byOrdinal_b = false;
+};
+
+ 
 /**
  * @brief Holds information for imported DLLs by PE file.
  */
 class ImportDirectory {
  public:
-  ImportDirectory();
-  ~ImportDirectory();
+  ImportDirectory() =default;
+  ~ImportDirectory() =default;
+
+  void setLookupTableRVA(uint32_t rva) { this->importLookupTableRVA_u32 = rva; }
+  void setTimeStamp(uint32_t ts) { this->timeStamp_u32 = ts; }
+  void setForwarderChain(uint32_t chain) { this->forwarderChain_u32 = chain; }
+  void setNameRVA(uint32_t rva) { this->nameRVA_u32 = rva; }
+  void setAddressTableRVA(uint32_t rva) { this->importAddressRVA_u32 = rva; }
+  void setName(std::string_view name) { this->name = name; }
+  void addFunction(const ImportedFunction& function) {
+    functions.push_back(function);
+  }
+
+  uint32_t getLookupTableRVA() const { return importLookupTableRVA_u32; }
+  uint32_t getTimeStamp() const { return timeStamp_u32; }
+  uint32_t getForwarderChain() const { return forwarderChain_u32; }
+  uint32_t getNameRVA() const { return nameRVA_u32; }
+  uint32_t getAddressTableRVA() const { return importAddressRVA_u32; }
+  std::string_view getName() const { return name; }
+  const std::vector<ImportedFunction>& getFunctions() const {
+    return functions;
+  }
 
  private:
   uint32_t importLookupTableRVA_u32;
@@ -105,42 +184,526 @@ class ImportDirectory {
   uint32_t forwarderChain_u32;
   uint32_t nameRVA_u32;
   uint32_t importAddressRVA_u32;
+
+  std::string_view name;  // DLL name
+  std::vector<ImportedFunction> functions;
+};
+
+ 
+/**
+ * @brief One function exported by a DLL. A forwarded export has no code in
+ * the DLL, its forwarder names the DLL and function providing it instead.
+ */
+class ExportedFunction {
+ public:
+  ExportedFunction() =default;
+  ~ExportedFunction() =default;
+
+  void setName(std::string_view name) { this->name = name; }
+  void setForwarder(std::string_view fwd) { this->forwarder = fwd; }
+  void setOrdinal(uint32_t ordinal) { this->ordinal_u32 = ordinal; }
+  void setAddressRVA(uint32_t rva) { this->addressRVA_u32 = rva; }
+
+  std::string_view getName() const { return name; }
+  std::string_view getForwarder() const { return forwarder; }
+  uint32_t getOrdinal() const { return ordinal_u32; }
+  uint32_t getAddressRVA() const { return addressRVA_u32; }
+  bool isForwarded() const { return !forwarder.empty(); }
+
+ private:
+  std::string_view name;       // first name, empty if exported by ordinal only
+  std::string_view forwarder;  // "DLL.Function" or "DLL.#ordinal"
+  uint32_t addressRVA_u32 = 0;
+  uint32_t ordinal_u32 = 0;    // ordinal base + index in the address table
 };
 
  
 /**
- * @brief Holds information for exported DLL functions.
+ * @brief Holds information for exported DLL functions. Functions are kept
+ * in ordinal order, and names in a sorted index next to them, so a lookup
+ * by either is a binary search.
  */
 class ExportDirectory {
  public:
-  ExportDirectory();
-  ~ExportDirectory();
+  ExportDirectory() =default;
+  ~ExportDirectory() =default;
+
+  void setExportFlags(uint32_t flags) { this->exportFlags_u32 = flags; }
+  void setTimeStamp(uint32_t ts) { this->timeStamp_u32 = ts; }
+  void setMajorVersion(uint16_t major) { this->majorVersion_u16 = major; }
+  void setMinorVersion(uint16_t minor) { this->minorVersion_u16 = minor; }
+  void setNameRVA(uint32_t rva) { this->nameRVA_u32 = rva; }
+  void setOrdinalBase(uint32_t base) { this->ordinalBase_u32 = base; }
+  void setAddressTableEntries(uint32_t n) { this->addressTableEntries_u32 = n; }
+  void setNumberOfNamePointers(uint32_t n) {
+    this->numberOfNamePointers_u32 = n;
+  }
+  void setAddressTableRVA(uint32_t rva) {
+    this->exportAddressTableRVA_u32 = rva;
+  }
+  void setNamePointerRVA(uint32_t rva) { this->namePointerRVA_u32 = rva; }
+  void setOrdinalTableRVA(uint32_t rva) { this->ordinalTableRVA_u32 = rva; }
+  void setName(std::string_view name) { this->name = name; }
+
+  uint32_t getTimeStamp() const { return timeStamp_u32; }
+  uint32_t getNameRVA() const { return nameRVA_u32; }
+  uint32_t getOrdinalBase() const { return ordinalBase_u32; }
+  uint32_t getAddressTableEntries() const { return addressTableEntries_u32; }
+  uint32_t getNumberOfNamePointers() const { return numberOfNamePointers_u32; }
+  uint32_t getAddressTableRVA() const { return exportAddressTableRVA_u32; }
+  uint32_t getNamePointerRVA() const { return namePointerRVA_u32; }
+  uint32_t getOrdinalTableRVA() const { return ordinalTableRVA_u32; }
+  std::string_view getName() const { return name; }
+  const std::vector<ExportedFunction>& getFunctions() const {
+    return functions;
+  }
+
+  void reserve(uint32_t, uint32_t);
+  void addFunction(const ExportedFunction&);
+  void addName(std::string_view, uint32_t);
+  void buildIndex();
+  const ExportedFunction* findByName(std::string_view) const;
+  const ExportedFunction* findByOrdinal(uint32_t) const;
+
+ private:
+  size_t position(uint32_t) const;
+
+  uint32_t exportFlags_u32 = 0;  // Reserved.
+  uint32_t timeStamp_u32 = 0;    // time/date that the export data was created
+  uint16_t majorVersion_u16 = 0;
+  uint16_t minorVersion_u16 = 0;
+  uint32_t nameRVA_u32 = 0;      // Address of ASCII string to name of the DLL
+  uint32_t ordinalBase_u32 = 0;  // The starting ordinal number for exports in
+                                 // this image. This field specifies the
+                                 // starting ordinal number for the export
+                                 // address table.
+
+  uint32_t addressTableEntries_u32 = 0;  // The number of entries in the
+                                         // export address table.
+  uint32_t numberOfNamePointers_u32 = 0;
+  uint32_t exportAddressTableRVA_u32 = 0;
+  uint32_t namePointerRVA_u32 = 0;
+  uint32_t ordinalTableRVA_u32 = 0;
+
+  std::string_view name;  // DLL name
+  std::vector<ExportedFunction> functions;  // sorted by ordinal
+
+  // name -> ordinal, sorted by name. A function may have several names.
+  std::vector<std::pair<std::string_view, uint32_t>> names;
+};
+
+ 
+/**
+ * @brief Where a resource's bytes are, from a leaf of the resource tree.
+ */
+class ResourceData {
+ public:
+  ResourceData() =default;
+  ResourceData(uint32_t rva, uint32_t size, uint32_t codePage)
+      : dataRVA_u32(rva), size_u32(size), codePage_u32(codePage) {}
+
+  uint32_t getDataRVA() const { return dataRVA_u32; }
+  uint32_t getSize() const { return size_u32; }
+  uint32_t getCodePage() const { return codePage_u32; }
+
+ private:
+  uint32_t dataRVA_u32 = 0;
+  uint32_t size_u32 = 0;
+  uint32_t codePage_u32 = 0;
+};
+
+class ResourceEntry;
+
+/**
+ * @brief One table of the resource tree (types, names or languages). Only
+ * the table header is read when it is created, entries are decoded from
+ * the image when asked for, so a lookup touches a few dozen bytes however
+ * large the tree is. The image has to outlive the object.
+ */
+class ResourceDirectory {
+ public:
+  // matches the first entry of a table in lookup()
+  static constexpr uint32_t anyId = UINT32_MAX;
+
+  ResourceDirectory() =default;
+  ResourceDirectory(const uint8_t*, uint64_t, uint32_t);
+
+  uint32_t size() const { return uint32_t(named_u16) + ids_u16; }
+  bool empty() const { return size() == 0; }
+
+  ResourceEntry entry(uint32_t) const;
+  ResourceEntry find(uint32_t) const;
+  ResourceEntry find(std::string_view) const;
+  ResourceEntry lookup(uint32_t, uint32_t = anyId, uint32_t = anyId) const;
+
+ private:
+  const uint8_t* root = nullptr;  // start of the resource section
+  uint64_t rootSize_u64 = 0;      // bytes from there to the end of the file
+  uint32_t offset_u32 = 0;        // this table, relative to root
+  uint16_t named_u16 = 0;         // entries identified by a name
+  uint16_t ids_u16 = 0;           // entries identified by a number
+};
+
+/**
+ * @brief An entry of a resource table, it leads either to another table or
+ * to a leaf describing the resource's data. A default constructed entry
+ * means nothing was found and tests false.
+ */
+class ResourceEntry {
+ public:
+  ResourceEntry() =default;
+  ResourceEntry(const uint8_t* root, uint64_t rootSize, uint32_t name,
+                uint32_t target)
+      : root(root), rootSize_u64(rootSize), name_u32(name),
+        target_u32(target) {}
+
+  explicit operator bool() const { return root != nullptr; }
+
+  bool isNamed() const { return name_u32 & 0x80000000; }
+  bool isDirectory() const { return target_u32 & 0x80000000; }
+  uint32_t getId() const { return name_u32; }
+  std::string getName() const;
+  ResourceDirectory getDirectory() const;
+  ResourceData getData() const;
+
+ private:
+  const uint8_t* root = nullptr;
+  uint64_t rootSize_u64 = 0;
+  uint32_t name_u32 = 0;    // an ID, or with the top bit set a name's offset
+  uint32_t target_u32 = 0;  // a table's offset with the top bit set, or a leaf's
+};
+
+ 
+/**
+ * @brief VersionInfo holds what a VS_VERSIONINFO resource says about a file:
+ * the fixed file and product versions, and the strings of its first string
+ * table (FileVersion, ProductName, CompanyName...) converted to UTF-8.
+ * Other string tables and VarFileInfo are skipped over.
+ */
+class VersionInfo {
+ public:
+  VersionInfo() =default;
+
+  void decode(const uint8_t*, uint64_t);
+
+  uint64_t getFileVersion() const { return fileVersion_u64; }
+  uint64_t getProductVersion() const { return productVersion_u64; }
+  std::string_view getString(std::string_view) const;
+  const std::vector<std::pair<std::string, std::string>>& getStrings() const {
+    return strings;
+  }
+  bool empty() const { return fileVersion_u64 == 0 && strings.empty(); }
+
+ private:
+  uint64_t fileVersion_u64 = 0;     // major.minor.build.revision, 16 bits each
+  uint64_t productVersion_u64 = 0;
+
+  // key, value in the order the resource lists them
+  std::vector<std::pair<std::string, std::string>> strings;
+};
+
+ 
+/**
+ * @brief A range over a table of fixed size records in an image, the table
+ * is bounds checked once when the range is made. Records are decoded while
+ * iterating, Record is built from a pointer to the record and the range's
+ * context (the page of a relocation block, the width of an address...).
+ * The image has to outlive the range.
+ */
+template <typename Record>
+class RecordRange {
+ public:
+  class iterator {
+   public:
+    iterator(const uint8_t* at, uint64_t stride, uint64_t context)
+        : at(at), stride_u64(stride), context_u64(context) {}
+
+    Record operator*() const { return Record(at, context_u64); }
+    iterator& operator++() {
+      at += stride_u64;
+      return *this;
+    }
+    bool operator==(const iterator& other) const { return at == other.at; }
+
+   private:
+    const uint8_t* at;
+    uint64_t stride_u64;
+    uint64_t context_u64;
+  };
+
+  RecordRange() =default;
+  RecordRange(const uint8_t* first, uint64_t count, uint64_t stride,
+              uint64_t context)
+      : first(first), count_u64(count), stride_u64(stride),
+        context_u64(context) {}
+
+  iterator begin() const { return iterator(first, stride_u64, context_u64); }
+  iterator end() const {
+    return iterator(first + count_u64 * stride_u64, stride_u64, context_u64);
+  }
+  Record operator[](uint64_t idx) const {
+    return Record(first + idx * stride_u64, context_u64);
+  }
+  uint64_t size() const { return count_u64; }
+  bool empty() const { return count_u64 == 0; }
+
+ private:
+  const uint8_t* first = nullptr;
+  uint64_t count_u64 = 0;
+  uint64_t stride_u64 = 0;
+  uint64_t context_u64 = 0;
+};
+
+/**
+ * @brief An address from a table of addresses, 4 or 8 bytes wide: TLS
+ * callbacks are VAs, SafeSEH handlers and CFG functions are RVAs.
+ */
+class AddressEntry {
+ public:
+  AddressEntry(const uint8_t* entry, uint64_t width)
+      : address_u64(width == 8 ? ByteReader::decode<uint64_t>(entry)
+                               : ByteReader::decode<uint32_t>(entry)) {}
+
+  uint64_t getAddress() const { return address_u64; }
+
+ private:
+  uint64_t address_u64;
+};
+
+/**
+ * @brief One base relocation, a type in the top 4 bits and an offset into
+ * its block's page in the low 12.
+ */
+class Relocation {
+ public:
+  Relocation(const uint8_t* entry, uint64_t pageRVA)
+      : value_u16(ByteReader::decode<uint16_t>(entry)),
+        pageRVA_u32(uint32_t(pageRVA)) {}
+
+  // IMAGE_REL_BASED_ABSOLUTE (0) only pads a block
+  uint8_t getType() const { return uint8_t(value_u16 >> 12); }
+  uint32_t getRVA() const { return pageRVA_u32 + (value_u16 & 0xfff); }
+
+ private:
+  uint16_t value_u16;
+  uint32_t pageRVA_u32;
+};
+
+/**
+ * @brief A block of base relocations, all the fix ups of one 4K page.
+ */
+class RelocationBlock {
+ public:
+  RelocationBlock(const uint8_t* block, uint32_t size)
+      : block(block), size_u32(size) {}
+
+  uint32_t getPageRVA() const { return ByteReader::decode<uint32_t>(block); }
+  uint32_t getBlockSize() const { return size_u32; }
+  RecordRange<Relocation> getEntries() const {
+    return RecordRange<Relocation>(block + 8, (size_u32 - 8) / 2, 2,
+                                   getPageRVA());
+  }
+
+ private:
+  const uint8_t* block;
+  uint32_t size_u32;  // header included, never past the directory's end
+};
+
+/**
+ * @brief Iterates over the blocks of the base relocation directory, each
+ * block is decoded when reached. Iteration stops at the directory's end or
+ * at a block too short to hold its own header.
+ */
+class RelocationRange {
+ public:
+  class iterator {
+   public:
+    iterator(const uint8_t*, const uint8_t*);
+
+    RelocationBlock operator*() const { return RelocationBlock(at, size_u32); }
+    iterator& operator++();
+    bool operator==(const iterator& other) const { return at == other.at; }
+
+   private:
+    void settle();
+
+    const uint8_t* at;
+    const uint8_t* last;  // end of the directory
+    uint32_t size_u32 = 0;
+  };
+
+  RelocationRange() =default;
+  RelocationRange(const uint8_t* first, uint64_t size)
+      : first(first), size_u64(size) {}
+
+  iterator begin() const { return iterator(first, first + size_u64); }
+  iterator end() const {
+    return iterator(first + size_u64, first + size_u64);
+  }
+  bool empty() const { return begin() == end(); }
+
+ private:
+  const uint8_t* first = nullptr;
+  uint64_t size_u64 = 0;
+};
+
+/**
+ * @brief One WIN_CERTIFICATE of the attribute certificate table, the blob
+ * is a view into the image.
+ */
+class WinCertificate {
+ public:
+  WinCertificate(const uint8_t* entry, uint32_t size)
+      : entry(entry), size_u32(size) {}
+
+  enum certificateTypes { WIN_CERT_TYPE_X509 = 1,
+                          WIN_CERT_TYPE_PKCS_SIGNED_DATA = 2,
+                          WIN_CERT_TYPE_TS_STACK_SIGNED = 4 };
+
+  uint32_t getLength() const { return size_u32; }
+  uint16_t getRevision() const {
+    return ByteReader::decode<uint16_t>(entry + 4);
+  }
+  uint16_t getType() const { return ByteReader::decode<uint16_t>(entry + 6); }
+  // the PKCS#7 SignedData for WIN_CERT_TYPE_PKCS_SIGNED_DATA
+  std::span<const std::byte> getData() const {
+    return {reinterpret_cast<const std::byte*>(entry + 8), size_u32 - 8};
+  }
+
+ private:
+  const uint8_t* entry;
+  uint32_t size_u32;  // header included, never past the table's end
+};
+
+/**
+ * @brief Iterates over the attribute certificate table, each entry is
+ * decoded when reached. Entries start on 8 byte boundaries; iteration
+ * stops at the table's end or at an entry too short to hold its header.
+ */
+class CertificateRange {
+ public:
+  class iterator {
+   public:
+    iterator(const uint8_t*, const uint8_t*);
+
+    WinCertificate operator*() const { return WinCertificate(at, size_u32); }
+    iterator& operator++();
+    bool operator==(const iterator& other) const { return at == other.at; }
+
+   private:
+    void settle();
+
+    const uint8_t* at;
+    const uint8_t* last;  // end of the table
+    uint32_t size_u32 = 0;
+  };
+
+  CertificateRange() =default;
+  CertificateRange(const uint8_t* first, uint64_t size)
+      : first(first), size_u64(size) {}
+
+  iterator begin() const { return iterator(first, first + size_u64); }
+  iterator end() const {
+    return iterator(first + size_u64, first + size_u64);
+  }
+  bool empty() const { return begin() == end(); }
 
  private:
-  uint32_t exportFlags_u32;  // Reserved.
-  uint32_t timeStamp_u32;    // time/date that the export data was created
-  uint16_t majorVersion_u16;
-  uint16_t minorVersion_u16;
-  uint32_t nameRVA_u32;      // Address of ASCII string to name of the DLL
-  uint32_t ordinalBase_u32;  // The starting ordinal number for exports in
-                             // this image. This field specifies the
-                             // starting ordinal number for the export
-                             // address table.
-
-  uint32_t addressTableEntries_u32;  // The number of entries in the
-                                     // export address table.
-  uint32_t numberOfNamePointers_u32;
-  uint32_t exportAddressTableRVA_u32;
-  uint32_t namePointerRVA_u32;
-  uint32_t ordinalTableRVA_u32;
-
-  // std::vector<exportAddressName> exportAddress;
+  const uint8_t* first = nullptr;
+  uint64_t size_u64 = 0;
+};
+
+ 
+/**
+ * @brief Holds the TLS directory. Raw data, index and callback addresses
+ * are VAs, callbacks are read from the image while iterating.
+ */
+class TlsDirectory {
+ public:
+  TlsDirectory() =default;
+
+  template <typename Word> void decode(const uint8_t*);
+  void setCallbacks(RecordRange<AddressEntry> range) { callbacks = range; }
+
+  uint64_t getStartAddressOfRawData() const { return startOfRawData_u64; }
+  uint64_t getEndAddressOfRawData() const { return endOfRawData_u64; }
+  uint64_t getAddressOfIndex() const { return addressOfIndex_u64; }
+  uint64_t getAddressOfCallBacks() const { return addressOfCallBacks_u64; }
+  uint32_t getSizeOfZeroFill() const { return sizeOfZeroFill_u32; }
+  uint32_t getCharacteristics() const { return characteristics_u32; }
+  RecordRange<AddressEntry> getCallbacks() const { return callbacks; }
+  bool empty() const { return !present_b; }
+
+ private:
+  bool present_b = false;
+  uint64_t startOfRawData_u64 = 0;
+  uint64_t endOfRawData_u64 = 0;
+  uint64_t addressOfIndex_u64 = 0;
+  uint64_t addressOfCallBacks_u64 = 0;
+  uint32_t sizeOfZeroFill_u32 = 0;
+  uint32_t characteristics_u32 = 0;
+  RecordRange<AddressEntry> callbacks;  // zero terminated array of VAs
+};
+
+ 
+/**
+ * @brief Holds the load configuration directory fields used for triage:
+ * the security cookie, SafeSEH handlers (PE32 only) and Control Flow Guard
+ * tables. Fields past the structure's own size are left zero, older
+ * linkers write shorter structures. Tables are read while iterating.
+ */
+class LoadConfig {
+ public:
+  LoadConfig() =default;
+
+  template <typename Word> void decode(const uint8_t*, uint32_t);
+  void setSafeSehHandlers(RecordRange<AddressEntry> range) {
+    safeSehHandlers = range;
+  }
+  void setGuardCFFunctions(RecordRange<AddressEntry> range) {
+    guardCFFunctions = range;
+  }
+
+  uint32_t getSize() const { return size_u32; }
+  uint32_t getTimeStamp() const { return timeStamp_u32; }
+  uint64_t getSecurityCookie() const { return securityCookie_u64; }
+  uint64_t getSEHandlerTable() const { return seHandlerTable_u64; }
+  uint64_t getSEHandlerCount() const { return seHandlerCount_u64; }
+  uint64_t getGuardCFCheckFunctionPointer() const {
+    return guardCFCheckFunctionPointer_u64;
+  }
+  uint64_t getGuardCFFunctionTable() const { return guardCFFunctionTable_u64; }
+  uint64_t getGuardCFFunctionCount() const { return guardCFFunctionCount_u64; }
+  uint32_t getGuardFlags() const { return guardFlags_u32; }
+  RecordRange<AddressEntry> getSafeSehHandlers() const {
+    return safeSehHandlers;
+  }
+  RecordRange<AddressEntry> getGuardCFFunctions() const {
+    return guardCFFunctions;
+  }
+  bool empty() const { return size_u32 == 0; }
+
+ private:
+  uint32_t size_u32 = 0;
+  uint32_t timeStamp_u32 = 0;
+  uint64_t securityCookie_u64 = 0;      // VA
+  uint64_t seHandlerTable_u64 = 0;      // VA
+  uint64_t seHandlerCount_u64 = 0;
+  uint64_t guardCFCheckFunctionPointer_u64 = 0;  // VA
+  uint64_t guardCFFunctionTable_u64 = 0;         // VA
+  uint64_t guardCFFunctionCount_u64 = 0;
+  uint32_t guardFlags_u32 = 0;
+
+  RecordRange<AddressEntry> safeSehHandlers;   // RVAs
+  RecordRange<AddressEntry> guardCFFunctions;  // RVAs, with flag bytes
 };
 
  
 /**
  * @brief holds information for PE file format, carries out PE-format specific
- * operations, loading, reading displaying header info.
+ * operations, loading, reading displaying header info. Parsed names and
+ * tables are views into the image, an object made from a buffer needs the
+ * buffer to outlive it, one made from a file name keeps the file mapped.
  * @see https://learn.microsoft.com/en-us/windows/win32/debug/pe-format
  */
 class PE {
@@ -155,13 +718,54 @@ class PE {
   PE& operator=(PE&) = delete;
 
   virtual void init(std::string);
-  void parse(std::ifstream&);
-  void readDOSHeader(std::ifstream&);
-  void readPE(std::ifstream&);
-  void readDataDirectory(std::ifstream&, std::vector<DataDirectory>&);
-  void readSections(std::ifstream&, std::vector<PESection>&);
-  void mapHeaderFlags();
-  void printPE();
+  virtual void init(std::span<const std::byte>, uint64_t = 0);
+  void parse(ByteReader&);
+  void readDOSHeader(ByteReader&);
+  void readPE(ByteReader&);
+  void readDataDirectory(ByteReader&, std::vector<DataDirectory>&);
+  void readSections(ByteReader&, std::vector<PESection>&);
+  void readImports(ByteReader&);
+  void readExports(ByteReader&);
+  void printPE(OutputBuffer&) const;
+  void printImports(OutputBuffer&) const;
+  void printExports(OutputBuffer&) const;
+  static std::string_view getFlagName(uint32_t, uint64_t);
+
+  enum peMaps { SECTIONFLAGS = 0,
+                FILEFLAGS,
+                DLLCHARACTERISTICS,
+                MACHINETYPE,
+                SUBSYSTEM };
+
+  // data directory entries, in the order the optional header lists them
+  enum dataDirectories { EXPORT_TABLE = 0,
+                         IMPORT_TABLE,
+                         RESOURCE_TABLE,
+                         EXCEPTION_TABLE,
+                         CERTIFICATE_TABLE,
+                         BASE_RELOCATION_TABLE,
+                         DEBUG_TABLE,
+                         ARCHITECTURE,
+                         GLOBAL_PTR,
+                         TLS_TABLE,
+                         LOAD_CONFIG_TABLE,
+                         BOUND_IMPORT,
+                         IAT,
+                         DELAY_IMPORT_DESCRIPTOR,
+                         CLR_RUNTIME_HEADER };
+
+  // predefined resource types
+  enum resourceTypes { RT_CURSOR = 1,
+                       RT_BITMAP = 2,
+                       RT_ICON = 3,
+                       RT_MENU = 4,
+                       RT_DIALOG = 5,
+                       RT_STRING = 6,
+                       RT_RCDATA = 10,
+                       RT_MESSAGETABLE = 11,
+                       RT_GROUP_ICON = 14,
+                       RT_VERSION = 16,
+                       RT_MANIFEST = 24 };
 
   uint16_t getDosMagic() const;
   uint16_t getSections() const;
@@ -178,8 +782,33 @@ class PE {
   uint64_t getImageBase() const;
 
   PESection getSection(uint16_t) const;
+  DataDirectory getDataDirectory(uint32_t) const;
+  uint64_t rvaToOffset(uint32_t) const;
+  const std::vector<ImportDirectory>& getImports() const;
+  Error getDirectoryError(uint32_t) const;
+  const ExportDirectory& getExports() const;
+  ResourceDirectory getResources(std::span<const std::byte>,
+                                 uint64_t = 0) const;
+  VersionInfo getVersionInfo(std::span<const std::byte>, uint64_t = 0) const;
+  RelocationRange getRelocations(std::span<const std::byte>,
+                                 uint64_t = 0) const;
+  TlsDirectory getTls(std::span<const std::byte>, uint64_t = 0) const;
+  LoadConfig getLoadConfig(std::span<const std::byte>, uint64_t = 0) const;
+  uint32_t vaToRVA(uint64_t) const;
+  CertificateRange getCertificates(std::span<const std::byte>,
+                                   uint64_t = 0) const;
+  std::array<std::pair<uint64_t, uint64_t>, 3> getAuthenticodeGaps() const;
 
  private:
+  template <typename Word> void readWindowsFields(ByteReader&);
+  template <typename Word>
+  void readThunks(ByteReader&, ImportDirectory&, uint64_t&);
+  void readDirectory(ByteReader&, uint32_t, void (PE::*)(ByteReader&));
+  std::string_view readName(ByteReader&, uint32_t);
+  template <typename Word> TlsDirectory readTls(ByteReader&) const;
+  template <typename Word> LoadConfig readLoadConfig(ByteReader&) const;
+  const uint8_t* directoryData(ByteReader&, uint32_t) const;
+
   // DOS header
   uint16_t dosMagic_u16;    // Magic DOS signature MZ
   uint16_t e_cblp_u16;      // Bytes on last page of file
@@ -249,21 +878,22 @@ class PE {
   std::vector<DataDirectory> dataDir;
   std::vector<PESection> sections;
   std::vector<PESection> section_table;
-  std::vector<PESection> exportDirectory;
-  std::vector<PESection> importDirectory;
-  std::vector<PESection> resourceDirectory;
-  std::vector<PESection> baseRelocationTable;
+  SectionIndex sectionIndex;
+  std::vector<ImportDirectory> importDirectory;
+  ExportDirectory exportDirectory;
+  std::map<uint32_t, Error> directoryErrors;  // directories that failed
+
+  // imported and exported names point into the image, they are looked up
+  // by RVA while parsing so a string shared by many entries is only read
+  // once.
+  static constexpr uint64_t maxNameLength = 4096;
+  std::unordered_map<uint32_t, std::string_view> nameCache;
+  // descriptors may share one thunk table, the functions read across all
+  // of them are capped so aliased tables can't multiply.
+  static constexpr uint64_t maxImportedFunctions = 1 << 16;
+  std::unique_ptr<MappedFile> mapping;  // set by init(std::string)
   std::vector<PESection> debugTable;
-  std::vector<PESection> tlsTable;
-  std::vector<PESection> loadConfigTable;
   std::vector<PESection> delayImportDescriptor;
-
-  // mapping flag types and strings
-  std::map<uint32_t, std::string> mapSectionFlags;
-  std::map<uint16_t, std::string> mapPEFlagTypes;
-  std::map<uint16_t, std::string> mapImageCharacteristics;
-  std::map<uint16_t, std::string> mapMachineType;
-  std::map<uint8_t, std::string> mapImageSubsystem;
 };
 
 #endif
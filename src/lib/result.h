@@ -0,0 +1,78 @@
+/**
+ * @file result.h
+ * @brief  Definitions for Error and Result, how the scan path reports
+ *      failures without throwing.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef RESULT_H
+#define RESULT_H
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+
+/* Why a file couldn't be scanned */
+enum class ErrorCode { NONE = 0,
+                       UNKNOWN_FORMAT,   // no PE, ELF or Mach-O magic
+                       TRUNCATED,        // a structure runs past the end
+                       MALFORMED_TABLE,  // a table's fields don't add up
+                       IO_ERROR };       // the file couldn't be read
+
+/**
+ * @brief Error is a code and a message. A default constructed Error means
+ * success and tests false.
+ */
+struct Error {
+  ErrorCode code = ErrorCode::NONE;
+  std::string message;
+
+  Error() = default;
+  Error(ErrorCode code, std::string message)
+      : code(code), message(std::move(message)) {}
+
+  explicit operator bool() const { return code != ErrorCode::NONE; }
+
+  /**
+   * @brief Throws the error for callers that want exceptions,
+   * std::out_of_range for TRUNCATED and std::runtime_error otherwise.
+   */
+  [[noreturn]] void raise() const {
+    if (code == ErrorCode::TRUNCATED) throw std::out_of_range(message);
+    throw std::runtime_error(message);
+  }
+};
+
+/**
+ * @brief Result holds either a value or the Error that prevented it, in
+ * the manner of std::expected. value() throws the error when there's no
+ * value, the other accessors must only be used after checking ok().
+ */
+template <typename T>
+class Result {
+ public:
+  Result(T value) : state(std::in_place_index<0>, std::move(value)) {}
+  Result(Error error) : state(std::in_place_index<1>, std::move(error)) {}
+
+  bool ok() const { return state.index() == 0; }
+  explicit operator bool() const { return ok(); }
+
+  T& value() {
+    if (!ok()) std::get<1>(state).raise();
+    return std::get<0>(state);
+  }
+  const Error& error() const { return std::get<1>(state); }
+
+  T& operator*() { return std::get<0>(state); }
+  const T& operator*() const { return std::get<0>(state); }
+  T* operator->() { return &std::get<0>(state); }
+  const T* operator->() const { return &std::get<0>(state); }
+
+ private:
+  std::variant<T, Error> state;
+};
+
+#endif
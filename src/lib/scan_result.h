@@ -0,0 +1,55 @@
+/**
+ * @file scan_result.h
+ * @brief  Definitions for ScanResult, everything read from one file.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef SCAN_RESULT_H
+#define SCAN_RESULT_H
+
+#include "../headers.h"
+#include "macho.h"
+#include "pe.h"
+#include "elf.h"
+
+/**
+ * @brief ScanResult holds what FileIO::scan() learned about a file: its
+ * hashes, its format and the parsed image. It is only written while the file
+ * is scanned and can be rendered later, from any thread.
+ */
+struct ScanResult {
+  enum fileFormat { UNKNOWN_FORMAT = 0,
+                    PE_FORMAT,
+                    ELF_FORMAT,
+                    MACHO_FORMAT,
+                    MACHO_FAT_FORMAT };
+
+  std::string filename;
+  std::string md5_hash;
+  std::string sha1_hash;
+  std::string sha256_hash;  // empty unless asked for
+  std::string blake3_hash;  // empty unless asked for
+  std::string crc32c_hash;  // empty unless asked for
+  std::string authenticode_sha1_hash;    // PE only, empty unless asked for
+  std::string authenticode_sha256_hash;  // PE only, empty unless asked for
+  uint32_t magic_u32 = 0;
+  fileFormat format = UNKNOWN_FORMAT;
+
+  // set when scan() mapped the file itself, a PE parsed from the image
+  // keeps views into it. Otherwise the caller's buffer has to outlive
+  // the result.
+  std::unique_ptr<MappedFile> file;
+
+  // only the one matching format is set.
+  std::unique_ptr<PE> pe;
+  std::unique_ptr<ELF> elf;
+  std::unique_ptr<MACHO> macho;
+
+  // set if the format is unknown or the file couldn't be parsed, anything
+  // read up to that point is kept.
+  Error error;
+};
+
+#endif
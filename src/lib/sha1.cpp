@@ -17,14 +17,18 @@
 */
 
 #include "sha1.h"
+#include "multi_hasher.h"
+#include "cpu_features.h"
+#include "hex.h"
+
+#include <algorithm>
+#include <cstring>
 
 static const size_t BLOCK_INTS =
     16; /* number of 32bit integers per SHA1 block */
 static const size_t BLOCK_BYTES = BLOCK_INTS * 4;
 
-inline static void reset(uint32_t digest[],
-                         std::string& buffer,
-                         uint64_t& transforms) {
+void SHA1::reset() {
   /* SHA1 initialization constants */
   digest[0] = 0x67452301;
   digest[1] = 0xefcdab89;
@@ -33,7 +37,7 @@ inline static void reset(uint32_t digest[],
   digest[4] = 0xc3d2e1f0;
 
   /* Reset counters */
-  buffer.clear();
+  buffered = 0;
   transforms = 0;
 }
 
@@ -114,9 +118,7 @@ inline static void R4(uint32_t block[BLOCK_INTS],
  * Hash a single 512-bit block. This is the core of the algorithm.
  */
 
-inline static void transform(uint32_t digest[],
-                             uint32_t block[BLOCK_INTS],
-                             uint64_t& transforms) {
+inline static void transform(uint32_t digest[], uint32_t block[BLOCK_INTS]) {
   /* Copy digest[] to working vars */
   uint32_t a = digest[0];
   uint32_t b = digest[1];
@@ -212,91 +214,169 @@ inline static void transform(uint32_t digest[],
   digest[2] += c;
   digest[3] += d;
   digest[4] += e;
+}
+
+/*
+ * Portable block function: load each block as big endian words and run
+ * the unrolled rounds above.
+ */
 
-  /* Count the number of transformations */
-  transforms++;
+void SHA1::compressScalar(uint32_t state[5],
+                          const uint8_t* data,
+                          size_t blocks) {
+  uint32_t block[BLOCK_INTS];
+  for (; blocks > 0; blocks--, data += BLOCK_BYTES) {
+    for (size_t i = 0; i < BLOCK_INTS; i++) {
+      const uint8_t* word = data + 4 * i;
+      block[i] = (uint32_t)word[0] << 24 | (uint32_t)word[1] << 16 |
+                 (uint32_t)word[2] << 8 | (uint32_t)word[3];
+    }
+    transform(state, block);
+  }
 }
 
-inline static void buffer_to_block(const std::string& buffer,
-                                   uint32_t block[BLOCK_INTS]) {
-  /* Convert the std::string (byte buffer) to a uint32_t array (MSB) */
-  for (size_t i = 0; i < BLOCK_INTS; i++) {
-    block[i] = (buffer[4 * i + 3] & 0xff) | (buffer[4 * i + 2] & 0xff) << 8 |
-               (buffer[4 * i + 1] & 0xff) << 16 |
-               (buffer[4 * i + 0] & 0xff) << 24;
+/*
+ * Fastest block function the CPU supports, checked once.
+ */
+
+SHA1::implementation SHA1::bestImplementation() {
+  static const implementation best = isSupported(SHA_NI) ? SHA_NI
+                                     : isSupported(ARMV8) ? ARMV8
+                                     : isSupported(SSSE3) ? SSSE3
+                                                          : SCALAR;
+  return best;
+}
+
+bool SHA1::isSupported(implementation impl) {
+  const CpuFeatures& cpu = CpuFeatures::get();
+  switch (impl) {
+    case SCALAR:
+      return true;
+    case SSSE3:
+      return cpu.ssse3;
+    case SHA_NI:
+      return cpu.sha && cpu.sse41;
+    case ARMV8:
+      return cpu.armSha1;
   }
+  return false;
+}
+
+SHA1::compressFunction SHA1::selectCompress(implementation impl) {
+  if (!isSupported(impl)) {
+    return compressScalar;
+  }
+  switch (impl) {
+    case SSSE3:
+      return compressSsse3;
+    case SHA_NI:
+      return compressShaNi;
+    case ARMV8:
+      return compressArmv8;
+    default:
+      return compressScalar;
+  }
+}
+
+SHA1::SHA1() : SHA1(bestImplementation()) {}
+
+SHA1::SHA1(implementation impl) : compress(selectCompress(impl)) {
+  reset();
 }
 
-inline SHA1::SHA1() {
-  reset(digest, buffer, transforms);
+void SHA1::update(const std::string& s) {
+  update(reinterpret_cast<const uint8_t*>(s.data()), s.size());
 }
 
-inline void SHA1::update(const std::string& s) {
-  std::istringstream is(s);
-  update(is);
+void SHA1::update(std::istream& is) {
+  char sbuf[BLOCK_BYTES * 256];
+  while (is.read(sbuf, sizeof(sbuf)) || is.gcount() > 0) {
+    update(reinterpret_cast<const uint8_t*>(sbuf), (size_t)is.gcount());
+  }
 }
 
-inline void SHA1::update(std::istream& is) {
-  while (true) {
-    char sbuf[BLOCK_BYTES];
-    is.read(sbuf, BLOCK_BYTES - buffer.size());
-    buffer.append(sbuf, (std::size_t)is.gcount());
-    if (buffer.size() != BLOCK_BYTES) {
+void SHA1::update(const uint8_t* data, size_t length) {
+  /* Top up a partial block first */
+  if (buffered > 0) {
+    size_t take = std::min(length, BLOCK_BYTES - buffered);
+    memcpy(buffer + buffered, data, take);
+    buffered += take;
+    data += take;
+    length -= take;
+    if (buffered != BLOCK_BYTES) {
       return;
     }
-    uint32_t block[BLOCK_INTS];
-    buffer_to_block(buffer, block);
-    transform(digest, block, transforms);
-    buffer.clear();
+    compress(digest, buffer, 1);
+    transforms++;
+    buffered = 0;
+  }
+
+  /* Whole blocks are hashed in place */
+  size_t blocks = length / BLOCK_BYTES;
+  if (blocks > 0) {
+    compress(digest, data, blocks);
+    transforms += blocks;
+    data += blocks * BLOCK_BYTES;
+    length -= blocks * BLOCK_BYTES;
+  }
+  if (length > 0) {
+    memcpy(buffer, data, length);
+    buffered = length;
   }
 }
 
+void SHA1::update(std::span<const std::byte> data) {
+  update(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
 /*
- * Add padding and return the message digest.
+ * Add padding and return the raw message digest.
  */
 
-inline std::string SHA1::final() {
+SHA1::Digest SHA1::finalDigest() {
   /* Total number of hashed bits */
-  uint64_t total_bits = (transforms * BLOCK_BYTES + buffer.size()) * 8;
-
-  /* Padding */
-  buffer += (char)0x80;
-  size_t orig_size = buffer.size();
-  while (buffer.size() < BLOCK_BYTES) {
-    buffer += (char)0x00;
+  uint64_t total_bits = (transforms * BLOCK_BYTES + buffered) * 8;
+
+  /* Padding: 0x80, zeros, then the bit count as a big endian uint64_t */
+  uint8_t padding[2 * BLOCK_BYTES] = {};
+  memcpy(padding, buffer, buffered);
+  padding[buffered] = 0x80;
+  size_t padded = buffered + 1 > BLOCK_BYTES - 8 ? 2 * BLOCK_BYTES
+                                                 : BLOCK_BYTES;
+  for (size_t i = 0; i < 8; i++) {
+    padding[padded - 1 - i] = (uint8_t)(total_bits >> (8 * i));
   }
-
-  uint32_t block[BLOCK_INTS];
-  buffer_to_block(buffer, block);
-
-  if (orig_size > BLOCK_BYTES - 8) {
-    transform(digest, block, transforms);
-    for (size_t i = 0; i < BLOCK_INTS - 2; i++) {
-      block[i] = 0;
-    }
+  compress(digest, padding, padded / BLOCK_BYTES);
+
+  Digest result;
+  for (size_t i = 0; i < 5; i++) {
+    result[4 * i + 0] = (uint8_t)(digest[i] >> 24);
+    result[4 * i + 1] = (uint8_t)(digest[i] >> 16);
+    result[4 * i + 2] = (uint8_t)(digest[i] >> 8);
+    result[4 * i + 3] = (uint8_t)digest[i];
   }
 
-  /* Append total_bits, split this uint64_t into two uint32_t */
-  block[BLOCK_INTS - 1] = (uint32_t)total_bits;
-  block[BLOCK_INTS - 2] = (uint32_t)(total_bits >> 32);
-  transform(digest, block, transforms);
+  /* Reset for next run */
+  reset();
 
-  /* Hex std::string */
-  std::ostringstream result;
-  for (size_t i = 0; i < sizeof(digest) / sizeof(digest[0]); i++) {
-    result << std::hex << std::setfill('0') << std::setw(8);
-    result << digest[i];
-  }
+  return result;
+}
 
-  /* Reset for next run */
-  reset(digest, buffer, transforms);
+/*
+ * Same as finalDigest(), formatted as lowercase hex.
+ */
 
-  return result.str();
+std::string SHA1::final() {
+  return Hex::toString(finalDigest());
 }
 
 std::string SHA1::from_file(const std::string& filename) {
-  std::ifstream stream(filename.c_str(), std::ios::binary);
-  SHA1 checksum;
-  checksum.update(stream);
-  return checksum.final();
+  MultiHasher hasher(MultiHasher::SHA1_DIGEST);
+  try {
+    hasher.updateFile(filename);
+  } catch (std::runtime_error&) {
+    /* as before, an unreadable file hashes what was read (nothing) */
+  }
+  hasher.final();
+  return hasher.getSHA1();
 }
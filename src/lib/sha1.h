@@ -17,24 +17,54 @@
 #ifndef SHA1_H
 #define SHA1_H
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <fstream>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
+#include <span>
 #include <string>
 
 class SHA1 {
  public:
+  /* Block functions, the fastest one the CPU supports is picked */
+  enum implementation { SCALAR = 0, SSSE3, SHA_NI, ARMV8 };
+
+  typedef std::array<uint8_t, 20> Digest;
+
   SHA1();
+  explicit SHA1(implementation impl);
   void update(const std::string& s);
   void update(std::istream& is);
+  void update(const uint8_t* data, size_t length);
+  void update(std::span<const std::byte> data);
+  Digest finalDigest();
   std::string final();
   static std::string from_file(const std::string& filename);
 
+  static implementation bestImplementation();
+  static bool isSupported(implementation impl);
+
  private:
+  typedef void (*compressFunction)(uint32_t state[5], const uint8_t* data,
+                                   size_t blocks);
+
+  /* Hash whole 64 byte blocks, read straight from the caller's memory */
+  static void compressScalar(uint32_t state[5], const uint8_t* data,
+                             size_t blocks);
+  static void compressSsse3(uint32_t state[5], const uint8_t* data,
+                            size_t blocks);
+  static void compressShaNi(uint32_t state[5], const uint8_t* data,
+                            size_t blocks);
+  static void compressArmv8(uint32_t state[5], const uint8_t* data,
+                            size_t blocks);
+  static compressFunction selectCompress(implementation impl);
+
+  void reset();
+
+  compressFunction compress;
   uint32_t digest[5];
-  std::string buffer;
+  uint8_t buffer[64]; /* partial block */
+  size_t buffered;
   uint64_t transforms;
 };
 
@@ -0,0 +1,319 @@
+/**
+ * @file sha1_transform.cpp
+ * @brief  SHA-1 block functions using CPU extensions: the x86 SHA
+ *      extensions, an SSSE3 message schedule, and the ARMv8 crypto
+ *      extensions. SHA1 picks one at run time, see SHA1::isSupported().
+ *
+ * Each function is compiled for its own target with a function attribute,
+ * so the rest of the program keeps the default instruction set.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "sha1.h"
+
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+static const size_t BLOCK_BYTES = 64;
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#define SHA_NI_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+
+/**
+ * @brief Four rounds of SHA-1 with the SHA extensions, group G of 20.
+ * Message words are kept in a ring of four registers, sha1msg1/sha1msg2
+ * expand them for the groups 3 ahead.
+ */
+template <int G>
+SHA_NI_TARGET inline void shaNiGroup(__m128i& abcd,
+                                     __m128i& e0,
+                                     __m128i& e1,
+                                     __m128i (&msg)[4]) {
+  __m128i& current = msg[G % 4];
+  if constexpr (G % 2 == 0) {
+    e0 = G == 0 ? _mm_add_epi32(e0, current)
+                : _mm_sha1nexte_epu32(e0, current);
+    e1 = abcd;
+  } else {
+    e1 = _mm_sha1nexte_epu32(e1, current);
+    e0 = abcd;
+  }
+  if constexpr (G >= 3 && G <= 18) {
+    msg[(G + 1) % 4] = _mm_sha1msg2_epu32(msg[(G + 1) % 4], current);
+  }
+  abcd = _mm_sha1rnds4_epu32(abcd, G % 2 == 0 ? e0 : e1, G / 5);
+  if constexpr (G >= 1 && G <= 16) {
+    msg[(G + 3) % 4] = _mm_sha1msg1_epu32(msg[(G + 3) % 4], current);
+  }
+  if constexpr (G >= 2 && G <= 17) {
+    msg[(G + 2) % 4] = _mm_xor_si128(msg[(G + 2) % 4], current);
+  }
+}
+
+template <int... G>
+SHA_NI_TARGET inline void shaNiRounds(__m128i& abcd,
+                                      __m128i& e0,
+                                      __m128i& e1,
+                                      __m128i (&msg)[4],
+                                      std::integer_sequence<int, G...>) {
+  (shaNiGroup<G>(abcd, e0, e1, msg), ...);
+}
+
+/**
+ * @brief SHA-1 block function using sha1rnds4/sha1nexte/sha1msg1/sha1msg2.
+ *
+ * @param state the five chaining words.
+ * @param data whole 64 byte blocks.
+ * @param blocks number of blocks.
+ */
+SHA_NI_TARGET void SHA1::compressShaNi(uint32_t state[5],
+                                       const uint8_t* data,
+                                       size_t blocks) {
+  const __m128i byteSwap =
+      _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+  __m128i abcd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+  abcd = _mm_shuffle_epi32(abcd, 0x1B);
+  __m128i e0 = _mm_set_epi32(int(state[4]), 0, 0, 0);
+  __m128i e1;
+
+  for (; blocks > 0; blocks--, data += BLOCK_BYTES) {
+    const __m128i abcdSaved = abcd;
+    const __m128i e0Saved = e0;
+
+    __m128i msg[4];
+    for (int i = 0; i < 4; i++) {
+      msg[i] = _mm_shuffle_epi8(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * i)),
+          byteSwap);
+    }
+
+    shaNiRounds(abcd, e0, e1, msg, std::make_integer_sequence<int, 20>());
+
+    e0 = _mm_sha1nexte_epu32(e0, e0Saved);
+    abcd = _mm_add_epi32(abcd, abcdSaved);
+  }
+
+  abcd = _mm_shuffle_epi32(abcd, 0x1B);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state), abcd);
+  state[4] = uint32_t(_mm_extract_epi32(e0, 3));
+}
+
+/**
+ * @brief Rotates four words left by 'bits'.
+ */
+SSSE3_TARGET static inline __m128i rotateLeft(__m128i words, int bits) {
+  return _mm_or_si128(_mm_slli_epi32(words, bits),
+                      _mm_srli_epi32(words, 32 - bits));
+}
+
+/**
+ * @brief Twenty scalar rounds sharing one boolean function, the message
+ * words already have the round constant added. Unrolled so the working
+ * variables rotate by renaming instead of moves.
+ */
+template <int First, typename Function>
+static inline void ssse3Rounds(uint32_t (&v)[5], const uint32_t* wk,
+                               Function f) {
+  uint32_t a = v[0], b = v[1], c = v[2], d = v[3], e = v[4];
+  auto round = [&](uint32_t va, uint32_t& vb, uint32_t vc, uint32_t vd,
+                   uint32_t& ve, int t) {
+    ve += ((va << 5) | (va >> 27)) + f(vb, vc, vd) + wk[t];
+    vb = (vb << 30) | (vb >> 2);
+  };
+  for (int t = First; t < First + 20; t += 5) {
+    round(a, b, c, d, e, t);
+    round(e, a, b, c, d, t + 1);
+    round(d, e, a, b, c, t + 2);
+    round(c, d, e, a, b, t + 3);
+    round(b, c, d, e, a, t + 4);
+  }
+  v[0] = a; v[1] = b; v[2] = c; v[3] = d; v[4] = e;
+}
+
+/**
+ * @brief SHA-1 block function for CPUs without the SHA extensions. The
+ * 80 word message schedule (plus round constants) is computed four words
+ * at a time with SSE, the rounds themselves stay scalar.
+ *
+ * W[t] = rol1(W[t-3] ^ W[t-8] ^ W[t-14] ^ W[t-16]) is computed for four
+ * words at once from the last sixteen, kept in registers; the last lane
+ * of each group depends on the first and is fixed up afterwards.
+ *
+ * @param state the five chaining words.
+ * @param data whole 64 byte blocks.
+ * @param blocks number of blocks.
+ */
+SSSE3_TARGET void SHA1::compressSsse3(uint32_t state[5],
+                                      const uint8_t* data,
+                                      size_t blocks) {
+  const __m128i byteSwap =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+  const uint32_t constants[4] = {0x5a827999, 0x6ed9eba1, 0x8f1bbcdc,
+                                 0xca62c1d6};
+
+  alignas(16) uint32_t wk[80];
+
+  for (; blocks > 0; blocks--, data += BLOCK_BYTES) {
+    // the last 16 message words, oldest first, stay in registers.
+    __m128i w[4];
+    for (int i = 0; i < 4; i++) {
+      w[i] = _mm_shuffle_epi8(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * i)),
+          byteSwap);
+      _mm_store_si128(reinterpret_cast<__m128i*>(wk + 4 * i),
+                      _mm_add_epi32(w[i], _mm_set1_epi32(int(constants[0]))));
+    }
+
+    for (int t = 16; t < 80; t += 4) {
+      __m128i words = _mm_xor_si128(
+          _mm_xor_si128(_mm_srli_si128(w[3], 4), w[2]),
+          _mm_xor_si128(_mm_alignr_epi8(w[1], w[0], 8), w[0]));
+      words = rotateLeft(words, 1);
+      // lane 3 needs W[t] (lane 0) which wasn't known yet.
+      words = _mm_xor_si128(words, rotateLeft(_mm_slli_si128(words, 12), 1));
+
+      w[0] = w[1];
+      w[1] = w[2];
+      w[2] = w[3];
+      w[3] = words;
+      _mm_store_si128(reinterpret_cast<__m128i*>(wk + t),
+                      _mm_add_epi32(words, _mm_set1_epi32(
+                                               int(constants[t / 20]))));
+    }
+
+    uint32_t v[5] = {state[0], state[1], state[2], state[3], state[4]};
+    ssse3Rounds<0>(v, wk, [](uint32_t b, uint32_t c, uint32_t d) {
+      return d ^ (b & (c ^ d));
+    });
+    ssse3Rounds<20>(v, wk, [](uint32_t b, uint32_t c, uint32_t d) {
+      return b ^ c ^ d;
+    });
+    ssse3Rounds<40>(v, wk, [](uint32_t b, uint32_t c, uint32_t d) {
+      return (b & c) | (d & (b | c));
+    });
+    ssse3Rounds<60>(v, wk, [](uint32_t b, uint32_t c, uint32_t d) {
+      return b ^ c ^ d;
+    });
+
+    for (int i = 0; i < 5; i++) state[i] += v[i];
+  }
+}
+
+#else
+
+void SHA1::compressShaNi(uint32_t state[5], const uint8_t* data,
+                         size_t blocks) {
+  compressScalar(state, data, blocks);
+}
+
+void SHA1::compressSsse3(uint32_t state[5], const uint8_t* data,
+                         size_t blocks) {
+  compressScalar(state, data, blocks);
+}
+
+#endif
+
+#if defined(__aarch64__)
+
+/**
+ * @brief Four rounds of SHA-1 with the ARMv8 crypto extensions, group G of
+ * 20. 'next' receives W + K for the group two ahead.
+ */
+template <int G>
+__attribute__((target("+crypto"))) inline void armGroup(
+    uint32x4_t& abcd,
+    uint32_t& e0,
+    uint32_t& e1,
+    uint32x4_t (&wk)[2],
+    uint32x4_t (&msg)[4]) {
+  const uint32_t constants[4] = {0x5a827999, 0x6ed9eba1, 0x8f1bbcdc,
+                                 0xca62c1d6};
+  uint32_t& e = G % 2 == 0 ? e0 : e1;
+  uint32_t& eNext = G % 2 == 0 ? e1 : e0;
+
+  eNext = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+  if constexpr (G / 5 == 0) {
+    abcd = vsha1cq_u32(abcd, e, wk[G % 2]);
+  } else if constexpr (G / 5 == 2) {
+    abcd = vsha1mq_u32(abcd, e, wk[G % 2]);
+  } else {
+    abcd = vsha1pq_u32(abcd, e, wk[G % 2]);
+  }
+  if constexpr (G + 2 < 20) {
+    wk[G % 2] = vaddq_u32(msg[(G + 2) % 4],
+                          vdupq_n_u32(constants[(G + 2) / 5]));
+  }
+  if constexpr (G >= 1 && G <= 16) {
+    msg[(G + 3) % 4] = vsha1su1q_u32(msg[(G + 3) % 4], msg[(G + 2) % 4]);
+  }
+  if constexpr (G <= 15) {
+    msg[G % 4] = vsha1su0q_u32(msg[G % 4], msg[(G + 1) % 4], msg[(G + 2) % 4]);
+  }
+}
+
+template <int... G>
+__attribute__((target("+crypto"))) inline void armRounds(
+    uint32x4_t& abcd,
+    uint32_t& e0,
+    uint32_t& e1,
+    uint32x4_t (&wk)[2],
+    uint32x4_t (&msg)[4],
+    std::integer_sequence<int, G...>) {
+  (armGroup<G>(abcd, e0, e1, wk, msg), ...);
+}
+
+/**
+ * @brief SHA-1 block function using sha1c/sha1p/sha1m/sha1h/sha1su0/sha1su1.
+ *
+ * @param state the five chaining words.
+ * @param data whole 64 byte blocks.
+ * @param blocks number of blocks.
+ */
+__attribute__((target("+crypto"))) void SHA1::compressArmv8(
+    uint32_t state[5], const uint8_t* data, size_t blocks) {
+  uint32x4_t abcd = vld1q_u32(state);
+  uint32_t e0 = state[4];
+  uint32_t e1 = 0;
+
+  for (; blocks > 0; blocks--, data += BLOCK_BYTES) {
+    const uint32x4_t abcdSaved = abcd;
+    const uint32_t e0Saved = e0;
+
+    uint32x4_t msg[4];
+    for (int i = 0; i < 4; i++) {
+      msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+    }
+    uint32x4_t wk[2] = {vaddq_u32(msg[0], vdupq_n_u32(0x5a827999)),
+                        vaddq_u32(msg[1], vdupq_n_u32(0x5a827999))};
+
+    armRounds(abcd, e0, e1, wk, msg, std::make_integer_sequence<int, 20>());
+
+    // after 20 groups the next 'e' is in e0.
+    e0 += e0Saved;
+    abcd = vaddq_u32(abcd, abcdSaved);
+  }
+
+  vst1q_u32(state, abcd);
+  state[4] = e0;
+}
+
+#else
+
+void SHA1::compressArmv8(uint32_t state[5], const uint8_t* data,
+                         size_t blocks) {
+  compressScalar(state, data, blocks);
+}
+
+#endif
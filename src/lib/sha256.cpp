@@ -0,0 +1,231 @@
+/**
+ * @file sha256.cpp
+ * @brief  SHA-256 hashing: buffering, padding and the portable block
+ *      function. The SHA extensions version is in sha256_transform.cpp.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "sha256.h"
+#include "cpu_features.h"
+#include "hex.h"
+
+#include <algorithm>
+#include <cstring>
+
+static const size_t BLOCK_BYTES = 64;
+
+/* First 32 bits of the fractional parts of the cube roots of the first 64
+   primes */
+const uint32_t SHA256::roundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+static inline uint32_t rotateRight(uint32_t value, int bits) {
+  return (value >> bits) | (value << (32 - bits));
+}
+
+/**
+ * @brief Portable block function, the message schedule is kept in a
+ * rolling window of 16 words.
+ *
+ * @param state the eight chaining words.
+ * @param data whole 64 byte blocks.
+ * @param blocks number of blocks.
+ */
+void SHA256::compressScalar(uint32_t state[8], const uint8_t* data,
+                            size_t blocks) {
+  for (; blocks > 0; blocks--, data += BLOCK_BYTES) {
+    uint32_t w[16];
+    for (int i = 0; i < 16; i++) {
+      const uint8_t* word = data + 4 * i;
+      w[i] = uint32_t(word[0]) << 24 | uint32_t(word[1]) << 16 |
+             uint32_t(word[2]) << 8 | uint32_t(word[3]);
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int t = 0; t < 64; t++) {
+      uint32_t word;
+      if (t < 16) {
+        word = w[t];
+      } else {
+        uint32_t w15 = w[(t - 15) & 15];
+        uint32_t w2 = w[(t - 2) & 15];
+        uint32_t s0 = rotateRight(w15, 7) ^ rotateRight(w15, 18) ^ (w15 >> 3);
+        uint32_t s1 = rotateRight(w2, 17) ^ rotateRight(w2, 19) ^ (w2 >> 10);
+        word = w[t & 15] += s0 + w[(t - 7) & 15] + s1;
+      }
+
+      uint32_t sum1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^
+                      rotateRight(e, 25);
+      uint32_t choose = g ^ (e & (f ^ g));
+      uint32_t temp1 = h + sum1 + choose + roundConstants[t] + word;
+      uint32_t sum0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^
+                      rotateRight(a, 22);
+      uint32_t majority = (a & b) | (c & (a | b));
+
+      h = g;
+      g = f;
+      f = e;
+      e = d + temp1;
+      d = c;
+      c = b;
+      b = a;
+      a = temp1 + sum0 + majority;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+  }
+}
+
+/**
+ * @brief Returns the fastest block function the CPU supports, checked once.
+ *
+ * @return an implementation.
+ */
+SHA256::implementation SHA256::bestImplementation() {
+  static const implementation best = isSupported(SHA_NI) ? SHA_NI : SCALAR;
+  return best;
+}
+
+/**
+ * @brief Tells whether a block function can run on this CPU.
+ *
+ * @param impl the implementation.
+ *
+ * @return true if it can be used.
+ */
+bool SHA256::isSupported(implementation impl) {
+  const CpuFeatures& cpu = CpuFeatures::get();
+  switch (impl) {
+    case SCALAR:
+      return true;
+    case SHA_NI:
+      return cpu.sha && cpu.sse41;
+  }
+  return false;
+}
+
+SHA256::SHA256() : SHA256(bestImplementation()) {}
+
+/**
+ * @brief Creates a hasher using a given block function, unsupported ones
+ * fall back to the portable one.
+ *
+ * @param impl the implementation.
+ */
+SHA256::SHA256(implementation impl) {
+  compress = isSupported(impl) && impl == SHA_NI ? compressShaNi
+                                                 : compressScalar;
+  reset();
+}
+
+/**
+ * @brief Sets the initial hash value and drops buffered bytes.
+ */
+void SHA256::reset() {
+  static const uint32_t initial[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+                                      0xa54ff53a, 0x510e527f, 0x9b05688c,
+                                      0x1f83d9ab, 0x5be0cd19};
+  memcpy(state, initial, sizeof(state));
+  buffered = 0;
+  transforms = 0;
+}
+
+/**
+ * @brief Adds bytes to the message, whole blocks are hashed in place and
+ * only a trailing partial block is copied.
+ *
+ * @param data bytes to be hashed.
+ * @param length number of bytes.
+ */
+void SHA256::update(const uint8_t* data, size_t length) {
+  if (buffered > 0) {
+    size_t take = std::min(length, BLOCK_BYTES - buffered);
+    memcpy(buffer + buffered, data, take);
+    buffered += take;
+    data += take;
+    length -= take;
+    if (buffered != BLOCK_BYTES) {
+      return;
+    }
+    compress(state, buffer, 1);
+    transforms++;
+    buffered = 0;
+  }
+
+  size_t blocks = length / BLOCK_BYTES;
+  if (blocks > 0) {
+    compress(state, data, blocks);
+    transforms += blocks;
+    data += blocks * BLOCK_BYTES;
+    length -= blocks * BLOCK_BYTES;
+  }
+  if (length > 0) {
+    memcpy(buffer, data, length);
+    buffered = length;
+  }
+}
+
+void SHA256::update(std::span<const std::byte> data) {
+  update(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+/**
+ * @brief Pads the message and returns its digest, the hasher is then reset
+ * for a new message.
+ *
+ * @return the raw 32 byte digest.
+ */
+SHA256::Digest SHA256::finalDigest() {
+  uint64_t totalBits = (transforms * BLOCK_BYTES + buffered) * 8;
+
+  uint8_t padding[2 * BLOCK_BYTES] = {};
+  memcpy(padding, buffer, buffered);
+  padding[buffered] = 0x80;
+  size_t padded = buffered + 1 > BLOCK_BYTES - 8 ? 2 * BLOCK_BYTES
+                                                 : BLOCK_BYTES;
+  for (size_t i = 0; i < 8; i++) {
+    padding[padded - 1 - i] = uint8_t(totalBits >> (8 * i));
+  }
+  compress(state, padding, padded / BLOCK_BYTES);
+
+  Digest result;
+  for (size_t i = 0; i < 8; i++) {
+    result[4 * i + 0] = uint8_t(state[i] >> 24);
+    result[4 * i + 1] = uint8_t(state[i] >> 16);
+    result[4 * i + 2] = uint8_t(state[i] >> 8);
+    result[4 * i + 3] = uint8_t(state[i]);
+  }
+
+  reset();
+  return result;
+}
+
+/**
+ * @brief Same as finalDigest(), formatted as lowercase hex.
+ *
+ * @return 64 hex characters.
+ */
+std::string SHA256::final() {
+  return Hex::toString(finalDigest());
+}
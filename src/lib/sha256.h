@@ -0,0 +1,59 @@
+/**
+ * @file sha256.h
+ * @brief  Definitions for SHA256, the SHA-256 digest (FIPS 180-4).
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+/**
+ * @brief SHA256 hashes a message incrementally, with the same interface as
+ * SHA1. Whole blocks are hashed straight from the caller's memory by the
+ * fastest block function the CPU supports.
+ */
+class SHA256 {
+ public:
+  /* Block functions, the fastest one the CPU supports is picked */
+  enum implementation { SCALAR = 0, SHA_NI };
+
+  typedef std::array<uint8_t, 32> Digest;
+
+  SHA256();
+  explicit SHA256(implementation impl);
+  void update(const uint8_t* data, size_t length);
+  void update(std::span<const std::byte> data);
+  Digest finalDigest();
+  std::string final();
+
+  static implementation bestImplementation();
+  static bool isSupported(implementation impl);
+
+ private:
+  typedef void (*compressFunction)(uint32_t state[8], const uint8_t* data,
+                                   size_t blocks);
+
+  static void compressScalar(uint32_t state[8], const uint8_t* data,
+                             size_t blocks);
+  static void compressShaNi(uint32_t state[8], const uint8_t* data,
+                            size_t blocks);
+  void reset();
+
+  static const uint32_t roundConstants[64];
+
+  compressFunction compress;
+  uint32_t state[8];
+  uint8_t buffer[64]; /* partial block */
+  size_t buffered;
+  uint64_t transforms;
+};
+
+#endif
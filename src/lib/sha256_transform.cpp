@@ -0,0 +1,116 @@
+/**
+ * @file sha256_transform.cpp
+ * @brief  SHA-256 block function using the x86 SHA extensions, compiled
+ *      with a function attribute so the rest of the program keeps the
+ *      default instruction set. SHA256 only calls it when the CPU has them.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "sha256.h"
+
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#define SHA_NI_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+
+/**
+ * @brief Four rounds of SHA-256, group G of 16. The message words live in
+ * a ring of four registers, sha256msg1/sha256msg2 expand them for the
+ * groups ahead.
+ */
+template <int G>
+SHA_NI_TARGET inline void shaNiGroup(__m128i& abef,
+                                     __m128i& cdgh,
+                                     __m128i (&msg)[4],
+                                     const uint32_t* constants) {
+  __m128i& current = msg[G % 4];
+  __m128i words = _mm_add_epi32(
+      current, _mm_loadu_si128(
+                   reinterpret_cast<const __m128i*>(constants + 4 * G)));
+
+  cdgh = _mm_sha256rnds2_epu32(cdgh, abef, words);
+  if constexpr (G >= 3 && G <= 14) {
+    __m128i& next = msg[(G + 1) % 4];
+    next = _mm_add_epi32(next, _mm_alignr_epi8(current, msg[(G + 3) % 4], 4));
+    next = _mm_sha256msg2_epu32(next, current);
+  }
+  words = _mm_shuffle_epi32(words, 0x0E);
+  abef = _mm_sha256rnds2_epu32(abef, cdgh, words);
+  if constexpr (G >= 1 && G <= 12) {
+    msg[(G + 3) % 4] = _mm_sha256msg1_epu32(msg[(G + 3) % 4], current);
+  }
+}
+
+template <int... G>
+SHA_NI_TARGET inline void shaNiRounds(__m128i& abef,
+                                      __m128i& cdgh,
+                                      __m128i (&msg)[4],
+                                      const uint32_t* constants,
+                                      std::integer_sequence<int, G...>) {
+  (shaNiGroup<G>(abef, cdgh, msg, constants), ...);
+}
+
+/**
+ * @brief SHA-256 block function using sha256rnds2/sha256msg1/sha256msg2.
+ * The instructions want the state as ABEF/CDGH, it is shuffled in and out
+ * once per call rather than once per block.
+ *
+ * @param state the eight chaining words.
+ * @param data whole 64 byte blocks.
+ * @param blocks number of blocks.
+ */
+SHA_NI_TARGET void SHA256::compressShaNi(uint32_t state[8],
+                                         const uint8_t* data,
+                                         size_t blocks) {
+  const __m128i byteSwap =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+  __m128i dcba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+  __m128i hgfe =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4));
+  __m128i cdab = _mm_shuffle_epi32(dcba, 0xB1);
+  __m128i efgh = _mm_shuffle_epi32(hgfe, 0x1B);
+  __m128i abef = _mm_alignr_epi8(cdab, efgh, 8);
+  __m128i cdgh = _mm_blend_epi16(efgh, cdab, 0xF0);
+
+  for (; blocks > 0; blocks--, data += 64) {
+    const __m128i abefSaved = abef;
+    const __m128i cdghSaved = cdgh;
+
+    __m128i msg[4];
+    for (int i = 0; i < 4; i++) {
+      msg[i] = _mm_shuffle_epi8(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * i)),
+          byteSwap);
+    }
+
+    shaNiRounds(abef, cdgh, msg, roundConstants,
+                std::make_integer_sequence<int, 16>());
+
+    abef = _mm_add_epi32(abef, abefSaved);
+    cdgh = _mm_add_epi32(cdgh, cdghSaved);
+  }
+
+  __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+  __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state),
+                   _mm_blend_epi16(feba, dchg, 0xF0));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4),
+                   _mm_alignr_epi8(dchg, feba, 8));
+}
+
+#else
+
+void SHA256::compressShaNi(uint32_t state[8], const uint8_t* data,
+                           size_t blocks) {
+  compressScalar(state, data, blocks);
+}
+
+#endif
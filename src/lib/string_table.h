@@ -0,0 +1,66 @@
+/**
+ * @file string_table.h
+ * @brief  Definitions for StringTable, a table of NUL terminated names
+ *      (ELF .shstrtab/.strtab, Mach-O and COFF string tables).
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef STRING_TABLE_H
+#define STRING_TABLE_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief StringTable keeps a copy of a whole string table, made with a single
+ * allocation, and hands out names as views into it. Views stay valid as long
+ * as the table isn't assigned again or destroyed.
+ */
+class StringTable {
+ public:
+  StringTable() = default;
+
+  void assign(const uint8_t*, uint64_t);
+  std::string_view at(uint64_t) const;
+
+  uint64_t size() const { return table.size(); }
+  bool empty() const { return table.empty(); }
+
+ private:
+  std::string table;
+};
+
+/**
+ * @brief Replaces the table's content.
+ *
+ * @param data start of the table in the file.
+ * @param size size of the table in bytes.
+ *
+ * @return none.
+ */
+inline void StringTable::assign(const uint8_t* data, uint64_t size) {
+  table.assign(reinterpret_cast<const char*>(data), size);
+}
+
+/**
+ * @brief Returns the name starting at an offset, up to its NUL or the end
+ * of the table.
+ *
+ * @param offset offset of the name inside the table.
+ *
+ * @return a view of the name, empty if the offset is outside the table.
+ */
+inline std::string_view StringTable::at(uint64_t offset) const {
+  if (offset >= table.size()) return {};
+
+  const char* start = table.data() + offset;
+  uint64_t left = table.size() - offset;
+  const void* end = std::memchr(start, '\0', left);
+  return {start, end ? size_t(static_cast<const char*>(end) - start) : left};
+}
+
+#endif
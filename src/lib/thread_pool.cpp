@@ -0,0 +1,161 @@
+/**
+ * @file thread_pool.cpp
+ * @brief  Implements the work-stealing thread pool.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "thread_pool.h"
+
+// lets submit() know whether it is called from one of the pool's workers.
+static thread_local const ThreadPool* currentPool = nullptr;
+static thread_local unsigned currentIndex = 0;
+
+/**
+ * @brief Starts worker threads.
+ *
+ * @param count number of workers, 0 uses one worker per hardware thread.
+ */
+ThreadPool::ThreadPool(unsigned count) {
+  if (count == 0) count = std::thread::hardware_concurrency();
+  if (count == 0) count = 1;
+
+  for (unsigned idx = 0; idx < count; idx++) {
+    queues.push_back(std::make_unique<WorkQueue>());
+  }
+  for (unsigned idx = 0; idx < count; idx++) {
+    threads.emplace_back(&ThreadPool::run, this, idx);
+  }
+}
+
+/**
+ * @brief Runs whatever is still queued, then stops and joins the workers.
+ */
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> guard(stateLock);
+    stopping = true;
+  }
+  workAvailable.notify_all();
+  for (std::thread& worker : threads) {
+    worker.join();
+  }
+}
+
+/**
+ * @brief Queues a task. From a worker thread the task goes to that worker's
+ * own queue, otherwise to the shared queue.
+ *
+ * @param task a callable to be run on one of the workers.
+ *
+ * @return none.
+ */
+void ThreadPool::submit(std::function<void()> task) {
+  WorkQueue& target = currentPool == this ? *queues[currentIndex] : injected;
+
+  {
+    std::lock_guard<std::mutex> guard(stateLock);
+    unfinished++;
+    queued++;
+  }
+  {
+    std::lock_guard<std::mutex> guard(target.lock);
+    target.tasks.push_back(std::move(task));
+  }
+  workAvailable.notify_one();
+}
+
+/**
+ * @brief Blocks until every submitted task, including tasks submitted by
+ * other tasks, has finished. Must not be called from a worker.
+ *
+ * @return none. rethrows the first exception a task let escape.
+ */
+void ThreadPool::wait() {
+  std::unique_lock<std::mutex> guard(stateLock);
+  allDone.wait(guard, [this] { return unfinished == 0; });
+
+  if (failure) {
+    std::exception_ptr error = failure;
+    failure = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+/**
+ * @brief Worker loop, runs tasks until the pool is destroyed.
+ *
+ * @param index the worker's own queue.
+ *
+ * @return none.
+ */
+void ThreadPool::run(unsigned index) {
+  currentPool = this;
+  currentIndex = index;
+
+  std::function<void()> task;
+  while (true) {
+    if (takeTask(index, task)) {
+      try {
+        task();
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(stateLock);
+        if (!failure) failure = std::current_exception();
+      }
+      task = nullptr;
+
+      std::lock_guard<std::mutex> guard(stateLock);
+      if (--unfinished == 0) allDone.notify_all();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> guard(stateLock);
+    workAvailable.wait(guard, [this] { return stopping || queued > 0; });
+    if (stopping && queued == 0) return;
+  }
+}
+
+/**
+ * @brief Takes the newest task of the worker's own queue, then the oldest
+ * task of the shared queue, or steals the oldest task of another worker.
+ *
+ * @param index the worker's own queue.
+ * @param task receives the task.
+ *
+ * @return true if a task was found.
+ */
+bool ThreadPool::takeTask(unsigned index, std::function<void()>& task) {
+  {
+    WorkQueue& own = *queues[index];
+    std::lock_guard<std::mutex> guard(own.lock);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      queued--;
+      return true;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(injected.lock);
+    if (!injected.tasks.empty()) {
+      task = std::move(injected.tasks.front());
+      injected.tasks.pop_front();
+      queued--;
+      return true;
+    }
+  }
+
+  for (unsigned step = 1; step < queues.size(); step++) {
+    WorkQueue& victim = *queues[(index + step) % queues.size()];
+    std::lock_guard<std::mutex> guard(victim.lock);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      queued--;
+      return true;
+    }
+  }
+  return false;
+}
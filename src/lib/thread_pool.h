@@ -0,0 +1,67 @@
+/**
+ * @file thread_pool.h
+ * @brief  Definitions for a work-stealing thread pool used to process
+ *      many files concurrently.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief ThreadPool runs tasks on a fixed set of workers. Every worker owns
+ * a queue, tasks submitted from a worker go to the back of its own queue and
+ * are taken from there first (LIFO). Tasks submitted from outside the pool
+ * go to a shared queue that is served in FIFO order. A worker with nothing
+ * in either steals from the front of other workers' queues.
+ */
+class ThreadPool {
+ public:
+  // disabling move/copy constructors
+  ThreadPool(ThreadPool&) = delete;
+  ThreadPool(ThreadPool&&) = delete;
+  ThreadPool& operator=(ThreadPool&) = delete;
+
+  explicit ThreadPool(unsigned);
+  ~ThreadPool();
+
+  void submit(std::function<void()>);
+  void wait();
+  unsigned size() const { return threads.size(); }
+
+ private:
+  struct WorkQueue {
+    std::mutex lock;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void run(unsigned);
+  bool takeTask(unsigned, std::function<void()>&);
+
+  std::vector<std::unique_ptr<WorkQueue>> queues;
+  WorkQueue injected;
+  std::vector<std::thread> threads;
+
+  std::mutex stateLock;
+  std::condition_variable workAvailable;
+  std::condition_variable allDone;
+  std::atomic<uint64_t> queued{0};   // tasks sitting in a queue
+  uint64_t unfinished = 0;           // queued or running, under stateLock
+  bool stopping = false;
+  std::exception_ptr failure;
+};
+
+#endif
@@ -0,0 +1,313 @@
+/**
+ * @file tree_walker.cpp
+ * @brief  Implements TreeWalker, walking directory trees in parallel.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#include "../headers.h"
+
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace {
+
+// record layout returned by getdents64.
+struct LinuxDirent64 {
+  uint64_t d_ino;
+  int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[];
+};
+
+/**
+ * @brief Closes a file descriptor when leaving scope.
+ */
+struct FdGuard {
+  int fd;
+  ~FdGuard() {
+    if (fd >= 0) ::close(fd);
+  }
+};
+
+/**
+ * @brief Converts a st_mode to the matching DT_* entry type.
+ */
+unsigned char modeToType(mode_t mode) {
+  if (S_ISREG(mode)) return DT_REG;
+  if (S_ISDIR(mode)) return DT_DIR;
+  if (S_ISLNK(mode)) return DT_LNK;
+  return DT_UNKNOWN;
+}
+
+/**
+ * @brief Calls visit(name, type) for every entry of an open directory,
+ * except "." and "..". On Linux the entries are read in large batches
+ * with getdents64, elsewhere with readdir.
+ *
+ * @param fd an open directory, left open.
+ * @param visit callback for each entry.
+ *
+ * @return false if the directory couldn't be read.
+ */
+template <typename Visit>
+bool listDirectory(int fd, Visit&& visit) {
+  auto skip = [](const char* name) {
+    return name[0] == '.' &&
+           (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+  };
+
+#ifdef __linux__
+  alignas(LinuxDirent64) char buffer[64 * 1024];
+  while (true) {
+    long count = ::syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+    if (count < 0 && errno == EINTR) continue;
+    if (count < 0) return false;
+    if (count == 0) return true;
+
+    for (long pos = 0; pos < count;) {
+      auto* entry = reinterpret_cast<LinuxDirent64*>(buffer + pos);
+      if (!skip(entry->d_name)) visit(entry->d_name, entry->d_type);
+      pos += entry->d_reclen;
+    }
+  }
+#else
+  int copy = ::dup(fd);
+  DIR* dir = copy < 0 ? nullptr : ::fdopendir(copy);
+  if (dir == nullptr) {
+    if (copy >= 0) ::close(copy);
+    return false;
+  }
+  while (dirent* entry = ::readdir(dir)) {
+    if (!skip(entry->d_name)) visit(entry->d_name, entry->d_type);
+  }
+  ::closedir(dir);
+  return true;
+#endif
+}
+
+/**
+ * @brief Checks a name or path against shell patterns.
+ */
+bool matchesAny(const std::vector<std::string>& patterns,
+                const std::string& name, const std::string& path) {
+  for (const std::string& pattern : patterns) {
+    const std::string& subject =
+        pattern.find('/') == std::string::npos ? name : path;
+    if (::fnmatch(pattern.c_str(), subject.c_str(), 0) == 0) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+/**
+ * @brief Starts the traversal workers.
+ *
+ * @param jobs number of worker threads, 0 uses all cores.
+ * @param options filters and limits of the walk.
+ * @param onFile called from a worker thread for every accepted file.
+ * @param err stream receiving messages about unreadable directories.
+ */
+TreeWalker::TreeWalker(unsigned jobs, const WalkOptions& options,
+                       std::function<void(const std::string&)> onFile,
+                       std::ostream& err)
+    : options(options), onFile(std::move(onFile)), err(err), pool(jobs) {}
+
+TreeWalker::~TreeWalker() = default;
+
+/**
+ * @brief Queues a directory tree to be walked. A symbolic link given as
+ * root is always followed.
+ *
+ * @param root path of the directory.
+ *
+ * @return none.
+ */
+void TreeWalker::walk(const std::string& root) {
+  struct stat info;
+  if (::stat(root.c_str(), &info) != 0) {
+    reportError("Could not open directory: " + root);
+    return;
+  }
+  dev_t device = info.st_dev;
+  pool.submit([this, root, device] { readDirectory(root, device, true); });
+}
+
+/**
+ * @brief Waits until every queued tree was walked.
+ *
+ * @return none.
+ */
+void TreeWalker::finish() {
+  pool.wait();
+}
+
+uint64_t TreeWalker::getDirectoryCount() const {
+  return this->directories;
+}
+uint64_t TreeWalker::getFileCount() const {
+  return this->files;
+}
+
+/**
+ * @brief Checks whether a path names a directory, following links.
+ *
+ * @param path name to check.
+ *
+ * @return true if it is a directory.
+ */
+bool TreeWalker::isDirectory(const std::string& path) {
+  struct stat info;
+  return ::stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+/**
+ * @brief Lists one directory on a worker. Files are checked right away,
+ * subdirectories are queued as new tasks.
+ *
+ * @param path path of the directory.
+ * @param device device of the walk's root, for the one file system limit.
+ * @param follow whether path may be a symbolic link.
+ *
+ * @return none.
+ */
+void TreeWalker::readDirectory(const std::string& path, dev_t device,
+                               bool follow) {
+  int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC | (follow ? 0 : O_NOFOLLOW);
+  FdGuard dir{::open(path.c_str(), flags)};
+  if (dir.fd < 0) {
+    reportError("Could not open directory: " + path);
+    return;
+  }
+
+  // one stat per directory, and only when a limit needs it.
+  if (options.oneFileSystem || options.symlinks == WalkOptions::FOLLOW_ALL) {
+    struct stat info;
+    if (::fstat(dir.fd, &info) != 0) {
+      reportError("Could not open directory: " + path);
+      return;
+    }
+    if (options.oneFileSystem && info.st_dev != device) return;
+    if (options.symlinks == WalkOptions::FOLLOW_ALL &&
+        !firstVisit(info.st_dev, info.st_ino)) {
+      return;
+    }
+  }
+  directories++;
+
+  std::string prefix = path;
+  if (prefix.empty() || prefix.back() != '/') prefix += '/';
+
+  bool listed = listDirectory(dir.fd, [&](const char* name, unsigned char type) {
+    visitEntry(dir.fd, prefix, name, type, device);
+  });
+  if (!listed) reportError("Could not read directory: " + path);
+}
+
+/**
+ * @brief Handles one directory entry, the entry's type from the listing is
+ * used when the file system provides it.
+ *
+ * @param dirFd the open parent directory.
+ * @param prefix path of the parent directory, ending with '/'.
+ * @param name name of the entry.
+ * @param type d_type of the entry.
+ * @param device device of the walk's root.
+ *
+ * @return none.
+ */
+void TreeWalker::visitEntry(int dirFd, const std::string& prefix,
+                            const char* name, unsigned char type,
+                            dev_t device) {
+  struct stat info;
+  bool link = false;
+
+  if (type == DT_UNKNOWN) {
+    if (::fstatat(dirFd, name, &info, AT_SYMLINK_NOFOLLOW) != 0) return;
+    type = modeToType(info.st_mode);
+  }
+  if (type == DT_LNK) {
+    if (options.symlinks == WalkOptions::FOLLOW_NONE) return;
+    if (::fstatat(dirFd, name, &info, 0) != 0) return;  // dangling
+    type = modeToType(info.st_mode);
+    if (type == DT_DIR && options.symlinks != WalkOptions::FOLLOW_ALL) return;
+    link = true;
+  }
+  if (type != DT_REG && type != DT_DIR) return;
+
+  std::string entryName = name;
+  std::string path = prefix + entryName;
+  if (matchesAny(options.exclude, entryName, path)) return;
+
+  if (type == DT_DIR) {
+    pool.submit([this, path, device, link] {
+      readDirectory(path, device, link);
+    });
+    return;
+  }
+
+  if (!options.include.empty() && !matchesAny(options.include, entryName, path)) {
+    return;
+  }
+  if (options.magicFilter && !looksExecutable(dirFd, name, link)) return;
+
+  files++;
+  onFile(path);
+}
+
+/**
+ * @brief Reads just the magic bytes of a file.
+ *
+ * @param dirFd the open parent directory.
+ * @param name name of the file.
+ * @param follow whether name may be a symbolic link.
+ *
+ * @return true if FileIO knows the file's format.
+ */
+bool TreeWalker::looksExecutable(int dirFd, const char* name,
+                                 bool follow) const {
+  int flags = O_RDONLY | O_CLOEXEC | O_NONBLOCK | (follow ? 0 : O_NOFOLLOW);
+  FdGuard file{::openat(dirFd, name, flags)};
+  if (file.fd < 0) return false;
+
+  uint8_t magic[4];
+  ssize_t count;
+  do {
+    count = ::pread(file.fd, magic, sizeof(magic), 0);
+  } while (count < 0 && errno == EINTR);
+  if (count < 2) return false;
+
+  return FileIO::isKnownFormat(FileIO::getMagicBytes(magic, uint64_t(count)));
+}
+
+/**
+ * @brief Remembers a directory, so that links can't make the walk loop.
+ *
+ * @return true the first time a directory is seen.
+ */
+bool TreeWalker::firstVisit(dev_t device, ino_t inode) {
+  std::lock_guard<std::mutex> guard(stateLock);
+  return visited.emplace(device, inode).second;
+}
+
+/**
+ * @brief Writes a message about a directory that couldn't be walked.
+ *
+ * @param message text of the message.
+ *
+ * @return none.
+ */
+void TreeWalker::reportError(const std::string& message) {
+  std::lock_guard<std::mutex> guard(stateLock);
+  err << "Exception: " << message << "\n";
+}
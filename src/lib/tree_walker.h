@@ -0,0 +1,83 @@
+/**
+ * @file tree_walker.h
+ * @brief  Definitions for TreeWalker, a parallel recursive directory
+ *      scanner that picks out executable files.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef TREE_WALKER_H
+#define TREE_WALKER_H
+
+#include "../headers.h"
+
+#include <set>
+#include <sys/types.h>
+
+/**
+ * @brief Settings for a recursive scan.
+ */
+struct WalkOptions {
+  enum symlinkPolicy { FOLLOW_NONE = 0,  // symbolic links are skipped
+                       FOLLOW_FILES,     // links to files are scanned
+                       FOLLOW_ALL };     // links to directories are walked too
+
+  // shell patterns (fnmatch), matched against the entry's name, or against
+  // the whole path when the pattern contains a '/'.
+  std::vector<std::string> include;  // files must match one, if any given
+  std::vector<std::string> exclude;  // matching files/directories are skipped
+  symlinkPolicy symlinks = FOLLOW_NONE;
+  bool oneFileSystem = false;        // don't cross into other mounts
+  bool magicFilter = true;           // skip files that aren't PE/ELF/Mach-O
+};
+
+/**
+ * @brief TreeWalker walks directory trees on its own thread pool, one task
+ * per directory. Entries are listed with getdents64 and files are examined
+ * relative to their directory (openat/fstatat), stat is only called when the
+ * entry type isn't known or a link has to be followed. Each accepted file is
+ * handed to a callback, which may block to slow the walk down.
+ */
+class TreeWalker {
+ public:
+  // disabling move/copy constructors
+  TreeWalker(TreeWalker&) = delete;
+  TreeWalker(TreeWalker&&) = delete;
+  TreeWalker& operator=(TreeWalker&) = delete;
+
+  TreeWalker(unsigned, const WalkOptions&,
+             std::function<void(const std::string&)>, std::ostream&);
+  ~TreeWalker();
+
+  void walk(const std::string&);
+  void finish();
+
+  uint64_t getDirectoryCount() const;
+  uint64_t getFileCount() const;
+
+  static bool isDirectory(const std::string&);
+
+ private:
+  void readDirectory(const std::string&, dev_t, bool);
+  void visitEntry(int, const std::string&, const char*, unsigned char, dev_t);
+  bool isExcluded(const std::string&, const std::string&) const;
+  bool isIncluded(const std::string&, const std::string&) const;
+  bool looksExecutable(int, const char*, bool) const;
+  bool firstVisit(dev_t, ino_t);
+  void reportError(const std::string&);
+
+  WalkOptions options;
+  std::function<void(const std::string&)> onFile;
+  std::ostream& err;
+
+  std::mutex stateLock;
+  std::set<std::pair<dev_t, ino_t>> visited;  // only with FOLLOW_ALL
+  std::atomic<uint64_t> directories{0};
+  std::atomic<uint64_t> files{0};
+
+  // declared last, workers are joined before the members above go away.
+  ThreadPool pool;
+};
+
+#endif
@@ -9,12 +9,58 @@
 #include "headers.h"
 
 int main(int argc, char* argv[]) {
+  Options options;
   try {
-    if (argc < 2) {
-      std::cout << "please supply at least One valid PE file\n";
-      return -1;
+    options.parse(argc, argv);
+  } catch (std::invalid_argument& except) {
+    std::cerr << except.what() << "\n";
+    Options::printUsage(std::cerr, argv[0]);
+    return -1;
+  }
+
+  if (options.help) {
+    Options::printUsage(std::cout, argv[0]);
+    return 0;
+  }
+  if (options.paths.empty() && options.fileLists.empty()) {
+    std::cout << "please supply at least One valid PE file\n";
+    return -1;
+  }
+
+  try {
+    BatchScanner batch(options.jobs, options.order, std::cout, std::cerr,
+                       options.hashPolicy);
+    batch.setDedupe(options.dedupe);
+    batch.setDetails(options.details);
+
+    // walks on its own workers, batch.add() blocking slows it down.
+    std::unique_ptr<TreeWalker> walker;
+    if (options.recursive) {
+      walker = std::make_unique<TreeWalker>(
+          options.jobs, options.walk,
+          [&batch](const std::string& path) { batch.add(path); }, std::cerr);
+    }
+
+    for (const std::string& path : options.paths) {
+      if (walker && TreeWalker::isDirectory(path)) {
+        walker->walk(path);
+      } else {
+        batch.add(path);
+      }
+    }
+    for (const std::string& listName : options.fileLists) {
+      if (listName == "-") {
+        batch.addList(std::cin);
+        continue;
+      }
+      std::ifstream list(listName);
+      if (list.fail()) {
+        throw std::runtime_error("Could not open file list: " + listName);
+      }
+      batch.addList(list);
     }
-    FileIO file(argv[1]);
+    if (walker) walker->finish();
+    batch.finish();
   }
   catch (std::exception& except)
   {
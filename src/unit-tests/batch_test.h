@@ -0,0 +1,219 @@
+/**
+ * @file batch_test.h
+ * @brief  definitions and unit tests for the thread pool and batch mode.
+ *
+ * @ref https://github.com/0xAbby/protobyte
+ *
+ * @author Abdullah Ada
+ */
+#ifndef BATCH_TEST_H
+#define BATCH_TEST_H
+
+#include <iostream>
+#include <gtest/gtest.h>
+#include "../headers.h"
+
+/**
+ * @brief A unit test checking tasks submitted by other tasks are all run
+ * before wait() returns.
+ */
+TEST(ThreadPoolTest, NestedTasks) {
+  std::atomic<int> counter{0};
+  ThreadPool pool(4);
+
+  for (int idx = 0; idx < 16; idx++) {
+    pool.submit([&pool, &counter] {
+      for (int sub = 0; sub < 16; sub++) {
+        pool.submit([&counter] { counter++; });
+      }
+      counter++;
+    });
+  }
+  pool.wait();
+
+  ASSERT_EQ(counter, 16 * 16 + 16);
+}
+
+/**
+ * @brief A unit test checking an exception thrown by a task reaches wait().
+ */
+TEST(ThreadPoolTest, TaskException) {
+  ThreadPool pool(2);
+  pool.submit([] { throw std::runtime_error("task failed"); });
+
+  EXPECT_THROW(pool.wait(), std::runtime_error);
+}
+
+/**
+ * @brief A unit test checking input order output matches the order files
+ * were added, with failures reported on the error stream.
+ */
+TEST(BatchTest, InputOrder) {
+  std::ostringstream out;
+  std::ostringstream err;
+  {
+    BatchScanner batch(4, BatchScanner::INPUT_ORDER, out, err);
+    batch.add("../samples/pe/win32k.sys");
+    batch.add("../samples/dummy_file");
+    batch.add("../samples/elf/lshw");
+    batch.finish();
+    ASSERT_EQ(batch.getFileCount(), 3);
+    ASSERT_EQ(batch.getFailures(), 1);
+    ASSERT_EQ(batch.getFailures(ErrorCode::UNKNOWN_FORMAT), 1);
+  }
+
+  std::string text = out.str();
+  size_t pe = text.find("Reading ../samples/pe/win32k.sys");
+  size_t dummy = text.find("Reading ../samples/dummy_file");
+  size_t elf = text.find("Reading ../samples/elf/lshw");
+  ASSERT_NE(elf, std::string::npos);
+  ASSERT_LT(pe, dummy);
+  ASSERT_LT(dummy, elf);
+  ASSERT_EQ(err.str(), "Exception: Could not read magic bytes\n");
+}
+
+/**
+ * @brief A unit test checking a recursive walk skips excluded directories
+ * and files without a known magic, and applies include patterns.
+ */
+TEST(TreeWalkerTest, Filters) {
+  std::mutex lock;
+  std::set<std::string> found;
+  auto collect = [&](const std::string& path) {
+    std::lock_guard<std::mutex> guard(lock);
+    found.insert(path);
+  };
+
+  WalkOptions options;
+  options.exclude.push_back("mach-o");
+  {
+    std::ostringstream err;
+    TreeWalker walker(2, options, collect, err);
+    walker.walk("../samples");
+    walker.finish();
+    ASSERT_EQ(walker.getFileCount(), 6);
+    ASSERT_TRUE(err.str().empty());
+  }
+  ASSERT_EQ(found.count("../samples/pe/win32k.sys"), 1);
+  ASSERT_EQ(found.count("../samples/elf/lshw"), 1);
+  ASSERT_EQ(found.count("../samples/dummy_file"), 0);
+
+  found.clear();
+  options.include.push_back("*.dll");
+  {
+    std::ostringstream err;
+    TreeWalker walker(2, options, collect, err);
+    walker.walk("../samples/");
+    walker.finish();
+  }
+  ASSERT_EQ(found.size(), 1);
+  ASSERT_EQ(found.count("../samples/pe/dbghelp.dll"), 1);
+}
+
+/**
+ * @brief A unit test checking a repeated file is reported as a duplicate
+ * of the first one and isn't parsed again.
+ */
+TEST(BatchTest, Dedupe) {
+  std::ostringstream out;
+  std::ostringstream err;
+  {
+    BatchScanner batch(2, BatchScanner::INPUT_ORDER, out, err);
+    batch.setDedupe(true);
+    batch.add("../samples/elf/lshw");
+    batch.add("../samples/elf/libresolv.so.2");
+    batch.add("../samples/elf/lshw");
+    batch.finish();
+    ASSERT_EQ(batch.getDuplicates(), 1);
+    ASSERT_EQ(batch.getFailures(), 0);
+  }
+
+  std::string text = out.str();
+  size_t duplicate = text.rfind("Reading ../samples/elf/lshw\n");
+  ASSERT_NE(duplicate, std::string::npos);
+  ASSERT_EQ(text.substr(duplicate),
+            "Reading ../samples/elf/lshw\n"
+            "  Duplicate of ../samples/elf/lshw\n");
+}
+
+/**
+ * @brief Appends 4 bytes to a text so its CRC32C becomes a chosen value,
+ * the way a forged file would.
+ */
+static void forceCRC32C(std::string& text, uint32_t target) {
+  uint32_t table[256];
+  for (uint32_t idx = 0; idx < 256; idx++) {
+    uint32_t value = idx;
+    for (int bit = 0; bit < 8; bit++) {
+      value = (value >> 1) ^ (value & 1 ? 0x82f63b78 : 0);
+    }
+    table[idx] = value;
+  }
+
+  CRC32C crc;
+  crc.update(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+  uint32_t state = crc.finalValue() ^ 0xffffffff;
+
+  // going back from the target, the top byte of the register tells which
+  // table entry the last step xored in.
+  uint8_t indexes[4];
+  uint32_t target_reg = target ^ 0xffffffff;
+  for (int step = 3; step >= 0; step--) {
+    uint32_t idx = 0;
+    while (table[idx] >> 24 != target_reg >> 24) idx++;
+    indexes[step] = uint8_t(idx);
+    target_reg = (target_reg ^ table[idx]) << 8;
+  }
+  for (int step = 0; step < 4; step++) {
+    text.push_back(char((state ^ indexes[step]) & 0xff));
+    state = (state >> 8) ^ table[indexes[step]];
+  }
+}
+
+/**
+ * @brief A unit test checking a file forged to the size and CRC32C of an
+ * earlier one isn't taken for a duplicate, while a real copy still is.
+ */
+TEST(DedupeFilterTest, ForgedCRC) {
+  std::string original(1000, 'a');
+  std::string forged(996, 'b');
+  CRC32C crc;
+  crc.update(reinterpret_cast<const uint8_t*>(original.data()),
+             original.size());
+  uint32_t target = crc.finalValue();
+  forceCRC32C(forged, target);
+  ASSERT_EQ(forged.size(), original.size());
+
+  auto bytes = [](const std::string& text) {
+    return std::as_bytes(std::span(text.data(), text.size()));
+  };
+  CRC32C forgedCrc;
+  forgedCrc.update(bytes(forged));
+  ASSERT_EQ(forgedCrc.finalValue(), target);
+
+  // nothing is read back, the originals don't have to exist on disk.
+  DedupeFilter filter;
+  ASSERT_TRUE(filter.claim(0, bytes(original), "original").empty());
+  ASSERT_TRUE(filter.claim(1, bytes(forged), "forged").empty());
+  filter.pass(2);
+  ASSERT_EQ(filter.claim(3, bytes(original), "copy"), "original");
+  ASSERT_EQ(filter.claim(4, bytes(forged), "copy"), "forged");
+  ASSERT_EQ(filter.getDuplicates(), 2);
+}
+
+/**
+ * @brief A unit test checking claims outside input order don't wait for
+ * earlier files, the first copy claimed is the original.
+ */
+TEST(DedupeFilterTest, Completed) {
+  std::string text(1000, 'a');
+  auto bytes = std::as_bytes(std::span(text.data(), text.size()));
+
+  DedupeFilter filter(false);
+  ASSERT_TRUE(filter.claim(5, bytes, "later").empty());
+  filter.pass(0);
+  ASSERT_EQ(filter.claim(1, bytes, "earlier"), "later");
+  ASSERT_EQ(filter.getDuplicates(), 1);
+}
+
+#endif
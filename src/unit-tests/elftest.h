@@ -109,4 +109,101 @@ TEST_F(ELFTest, sectionTableDataSize) {
   ASSERT_TRUE(elf.getSectionHeaders()[27].getSh_size() == 0xBA4);
 }
 
+/**
+ * @brief A unit test checking section names are exact, without the
+ * terminating NUL, and the first section has none.
+ */
+TEST_F(ELFTest, sectionNames) {
+  std::vector<SectionHeader> headers = elf.getSectionHeaders();
+  ASSERT_EQ(headers[0].getS_name(), "None");
+  ASSERT_EQ(headers[16].getS_name(), ".text");
+  ASSERT_EQ(headers[27].getS_name(), ".data");
+}
+
+/**
+ * @brief A unit test checking names are cut at the end of a string table
+ * that isn't NUL terminated.
+ */
+TEST(StringTableTest, Bounds) {
+  const uint8_t bytes[] = {'\0', 'a', 'b', '\0', 'c', 'd'};
+  StringTable table;
+  table.assign(bytes, sizeof(bytes));
+
+  ASSERT_EQ(table.at(1), "ab");
+  ASSERT_EQ(table.at(2), "b");
+  ASSERT_EQ(table.at(4), "cd");
+  ASSERT_TRUE(table.at(6).empty());
+}
+
+/**
+ * @brief A unit test checking a big endian (MIPS) ELF32 header is decoded
+ * in its own byte order.
+ */
+TEST(ELFBigEndianTest, Header) {
+  const uint8_t header[52] = {
+      0x7f, 'E', 'L', 'F', 0x01, 0x02, 0x01, 0x00,  // ELFCLASS32, ELFDATA2MSB
+      0, 0, 0, 0, 0, 0, 0, 0,
+      0x00, 0x02, 0x00, 0x08,                       // ET_EXEC, EM_MIPS
+      0x00, 0x00, 0x00, 0x01,                       // e_version
+      0x00, 0x40, 0x01, 0x00,                       // e_entry
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,           // e_phoff, e_shoff, e_flags
+      0x00, 0x34, 0x00, 0x20, 0x00, 0x00,           // e_ehsize, e_phentsize, e_phnum
+      0x00, 0x28, 0x00, 0x00, 0x00, 0x00};          // e_shentsize, e_shnum, e_shstrndx
+
+  ELF elf;
+  elf.init(std::as_bytes(std::span(header)));
+  ASSERT_EQ(elf.getE_type(), 2);
+  ASSERT_EQ(elf.getE_machine(), 8);
+  ASSERT_EQ(elf.getE_entry(), 0x400100);
+}
+
+/**
+ * @brief A unit test checking an object with more than 0xff00 sections,
+ * e_shnum is 0 and e_shstrndx is SHN_XINDEX, both are kept in the first
+ * section header.
+ */
+TEST(ELFManySectionsTest, ExtendedNumbering) {
+  const uint32_t count = 70005;
+  const uint64_t names = 64 + 64 * uint64_t(count);
+  const char strtab[] = "\0.shstrtab";
+  std::vector<uint8_t> image(names + sizeof(strtab));
+  auto put = [&](uint64_t at, uint64_t value, int size) {
+    for (int i = 0; i < size; ++i) image[at + i] = uint8_t(value >> (8 * i));
+  };
+
+  const uint8_t ident[] = {0x7f, 'E', 'L', 'F', 0x02, 0x01, 0x01};
+  std::memcpy(image.data(), ident, sizeof(ident));
+  put(16, 1, 2);           // ET_REL
+  put(18, 62, 2);          // EM_X86_64
+  put(20, 1, 4);           // e_version
+  put(40, 64, 8);          // e_shoff
+  put(52, 64, 2);          // e_ehsize
+  put(58, 64, 2);          // e_shentsize
+  put(60, 0, 2);           // e_shnum
+  put(62, 0xffff, 2);      // e_shstrndx, SHN_XINDEX
+  put(64 + 32, count, 8);  // section 0 sh_size
+  put(64 + 40, count - 1, 4);  // section 0 sh_link
+
+  uint64_t last = 64 + 64 * uint64_t(count - 1);
+  put(last, 1, 4);                  // sh_name
+  put(last + 4, 3, 4);              // SHT_STRTAB
+  put(last + 24, names, 8);         // sh_offset
+  put(last + 32, sizeof(strtab), 8);  // sh_size
+  std::memcpy(image.data() + names, strtab, sizeof(strtab));
+
+  ELF elf;
+  elf.init(std::as_bytes(std::span(image)));
+  ASSERT_EQ(elf.getE_shnum(), count);
+  std::vector<SectionHeader> headers = elf.getSectionHeaders();
+  ASSERT_EQ(headers.size(), count);
+  ASSERT_EQ(headers[count - 1].getS_name(), ".shstrtab");
+
+  OutputBuffer out;
+  elf.printElf(out);
+  ASSERT_NE(out.view().find("total entries: \t0x11175\n"),
+            std::string_view::npos);
+  ASSERT_NE(out.view().find("sectionHeader[70004]\n  Name: \t.shstrtab\n"),
+            std::string_view::npos);
+}
+
 #endif
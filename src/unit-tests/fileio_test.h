@@ -36,4 +36,112 @@ TEST_F(FILEIO_TEST, File_IO_exception) {
     EXPECT_NO_THROW(FileIO test_file(filename));
 }
 
+TEST_F(FILEIO_TEST, MappedFileSize) {
+    MappedFile file("../samples/pe/win32k.sys");
+
+    ASSERT_EQ(file.size(), 330240);
+    ASSERT_EQ(file.data()[0], 'M');
+    ASSERT_EQ(file.data()[1], 'Z');
+}
+
+TEST_F(FILEIO_TEST, ByteReaderBounds) {
+    const uint8_t bytes[6] = {0x4d, 0x5a, 0x90, 0x00, 0x03, 0x00};
+    ByteReader in(bytes, sizeof(bytes));
+
+    EXPECT_EQ(in.read_u16(true), 0x5a4d);
+    EXPECT_EQ(in.read_u32(false), 0x90000300);
+    EXPECT_THROW(in.read_u8(), std::out_of_range);
+
+    in.seek(4);
+    EXPECT_EQ(in.read_u16(true), 0x0003);
+
+    in.seek(0);
+    EXPECT_THROW(in.read_table(4, 2), std::out_of_range);
+    EXPECT_THROW(in.read_table(UINT64_MAX / 2, 4), std::out_of_range);
+    EXPECT_EQ(in.read_table(3, 2)[4], 0x03);
+    EXPECT_EQ(in.tell(), 6);
+}
+
+TEST_F(FILEIO_TEST, ScanResult) {
+    ScanResult result = FileIO::scan("../samples/elf/lshw");
+
+    ASSERT_FALSE(result.error);
+    ASSERT_EQ(result.format, ScanResult::ELF_FORMAT);
+    ASSERT_NE(result.elf, nullptr);
+    ASSERT_EQ(result.pe, nullptr);
+
+    std::ostringstream out;
+    FileIO::render(result, out);
+    ASSERT_EQ(out.str().rfind("Reading ../samples/elf/lshw\n", 0), 0);
+
+    result = FileIO::scan("../samples/dummy_file");
+    ASSERT_TRUE(result.error);
+    ASSERT_EQ(result.format, ScanResult::UNKNOWN_FORMAT);
+    ASSERT_EQ(result.md5_hash.size(), 32);
+}
+
+TEST_F(FILEIO_TEST, HashPolicy) {
+    HashPolicy policy;
+    policy.formats = HashPolicy::parseFormats("executables");
+
+    ScanResult result = FileIO::scan("../samples/dummy_file", policy);
+    ASSERT_TRUE(result.error);
+    ASSERT_TRUE(result.md5_hash.empty());
+    ASSERT_TRUE(result.sha1_hash.empty());
+
+    result = FileIO::scan("../samples/elf/lshw", policy);
+    ASSERT_EQ(result.md5_hash.size(), 32);
+
+    policy.maxSize = 1024;
+    result = FileIO::scan("../samples/elf/lshw", policy);
+    ASSERT_FALSE(result.error);
+    ASSERT_NE(result.elf, nullptr);
+    ASSERT_TRUE(result.md5_hash.empty());
+
+    ASSERT_EQ(HashPolicy::parseFormats("pe,elf"),
+              uint32_t(HashPolicy::PE_FORMATS | HashPolicy::ELF_FORMATS));
+    EXPECT_THROW(HashPolicy::parseFormats("zip"), std::invalid_argument);
+}
+
+TEST_F(FILEIO_TEST, ErrorCodes) {
+    ScanResult result = FileIO::scan("../samples/dummy_file");
+    ASSERT_EQ(result.error.code, ErrorCode::UNKNOWN_FORMAT);
+    ASSERT_EQ(result.error.message, "Could not read magic bytes");
+
+    MappedFile file("../samples/elf/lshw");
+    result = FileIO::scan(file.bytes().first(100), "truncated");
+    ASSERT_EQ(result.format, ScanResult::ELF_FORMAT);
+    ASSERT_EQ(result.error.code, ErrorCode::TRUNCATED);
+
+    Result<ScanResult> missing = FileIO::tryScan("../samples/missing");
+    ASSERT_FALSE(missing.ok());
+    ASSERT_EQ(missing.error().code, ErrorCode::IO_ERROR);
+    EXPECT_THROW(missing.value(), std::runtime_error);
+    EXPECT_THROW(FileIO::scan("../samples/missing"), std::runtime_error);
+
+    Result<ScanResult> found = FileIO::tryScan("../samples/elf/lshw");
+    ASSERT_TRUE(found.ok());
+    ASSERT_FALSE(found->error);
+}
+
+TEST_F(FILEIO_TEST, OutputBuffer) {
+    using namespace std;
+    OutputBuffer buffer;
+    ostringstream stream;
+    auto print = [](auto& out) {
+      out << "a " << 0 << ' ' << uint8_t('x') << ' ' << true << ' '
+          << -42 << endl;
+      out << hex << 0xbeefULL << " " << int16_t(-1) << " " << uppercase
+          << 0xabcu << " " << dec << UINT64_MAX << endl;
+      out << string("name") << " " << string_view("view") << "\n";
+    };
+    print(buffer);
+    print(stream);
+    ASSERT_EQ(buffer.view(), stream.str());
+
+    buffer.clear();
+    buffer << 255;
+    ASSERT_EQ(buffer.view(), "255");
+}
+
 #endif
\ No newline at end of file
@@ -50,4 +50,259 @@ TEST_F(HASHTest, MD5_test) {
   ASSERT_EQ(md5_hash, "750338e86da4e5c8c318b885ba341d82");
 }
 
+/**
+ * @brief MultiHasher gives the same digests in one pass as the separate
+ * hashers, whether fed from memory or reading the file itself.
+ */
+TEST(MultiHasherTest, SinglePass) {
+  const std::string filename = "../samples/elf/libresolv.so.2";
+  MappedFile file(filename);
+
+  MultiHasher memory;
+  memory.update(file.bytes());
+  memory.final();
+
+  MultiHasher reader;
+  reader.updateFile(filename);
+  reader.final();
+
+  ASSERT_EQ(memory.getSHA1(), "19188e369c9b2909944d3330dd4e73c338e6f414");
+  ASSERT_EQ(memory.getMD5(), "80382ccb8de18e512d896354e1300e19");
+  ASSERT_EQ(reader.getSHA1(), memory.getSHA1());
+  ASSERT_EQ(reader.getMD5(), memory.getMD5());
+
+  MultiHasher sha1Only(MultiHasher::SHA1_DIGEST);
+  sha1Only.final();
+  ASSERT_TRUE(sha1Only.getMD5().empty());
+  ASSERT_EQ(sha1Only.getSHA1(), "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+  EXPECT_THROW(reader.updateFile("../samples/missing"), std::runtime_error);
+}
+
+/**
+ * @brief The Authenticode digests leave out the skipped ranges, also when
+ * a range crosses a slice or update() boundary, and only them.
+ */
+TEST(MultiHasherTest, AuthenticodeGaps) {
+  std::vector<std::byte> content(3 * MultiHasher::sliceSize);
+  for (size_t i = 0; i < content.size(); i++) content[i] = std::byte(i * 7);
+
+  MultiHasher hasher(MultiHasher::SHA256_DIGEST |
+                     MultiHasher::AUTHENTICODE_DIGESTS);
+  hasher.skipForAuthenticode(MultiHasher::sliceSize - 4, 8);
+  hasher.skipForAuthenticode(100, 4);
+  hasher.skipForAuthenticode(content.size() - 16, 16);
+  hasher.update(std::span(content).first(1000));
+  hasher.update(std::span(content).subspan(1000));
+  hasher.final();
+
+  std::span<const std::byte> all(content);
+  SHA256 kept;
+  kept.update(all.first(100));
+  kept.update(all.subspan(104, MultiHasher::sliceSize - 108));
+  kept.update(all.subspan(MultiHasher::sliceSize + 4,
+                          content.size() - MultiHasher::sliceSize - 20));
+  ASSERT_EQ(hasher.getAuthenticodeSHA256(), Hex::toString(kept.finalDigest()));
+  ASSERT_EQ(hasher.getAuthenticodeSHA1().size(), 40u);
+
+  SHA256 whole;
+  whole.update(all);
+  ASSERT_EQ(hasher.getSHA256(), Hex::toString(whole.finalDigest()));
+  ASSERT_EQ(MultiHasher::parseDigests("authenticode"),
+            uint32_t(MultiHasher::AUTHENTICODE_DIGESTS));
+}
+
+/**
+ * @brief Every SHA-1 block function the CPU supports gives the same
+ * digests as the portable one, for lengths around block boundaries and
+ * input split at odd places.
+ */
+TEST(SHA1Test, Implementations) {
+  std::string input;
+  for (int i = 0; i < 1000; i++) input += char(i * 7 + 3);
+
+  for (SHA1::implementation impl : {SHA1::SSSE3, SHA1::SHA_NI, SHA1::ARMV8}) {
+    if (!SHA1::isSupported(impl)) continue;
+
+    for (size_t length : {0, 1, 55, 56, 63, 64, 65, 128, 1000}) {
+      SHA1 scalar(SHA1::SCALAR);
+      SHA1 fast(impl);
+      scalar.update(input.substr(0, length));
+      fast.update(reinterpret_cast<const uint8_t*>(input.data()), length / 3);
+      fast.update(input.substr(length / 3, length - length / 3));
+      ASSERT_EQ(fast.final(), scalar.final()) << impl << " " << length;
+    }
+  }
+
+  SHA1 abc;
+  abc.update(std::string("abc"));
+  ASSERT_EQ(abc.final(), "a9993e364706816aba3e25717850c26c9cd0d89d");
+}
+
+/**
+ * @brief Multi-buffer MD5 matches MD5Hasher for every lane width, with
+ * more inputs than lanes and sizes around the padding boundaries.
+ */
+TEST(MD5MultiBufferTest, Lanes) {
+  std::string content;
+  for (int i = 0; i < 3000; i++) content += char(i * 13 + 1);
+
+  std::vector<std::span<const std::byte>> inputs;
+  std::vector<std::string> expected;
+  for (size_t length : {0, 3, 55, 56, 64, 119, 120, 1000, 3000, 1, 200, 64,
+                        65, 500, 2999, 7, 128, 9, 2048, 63, 33}) {
+    inputs.push_back(std::as_bytes(std::span(content.data(), length)));
+    MD5Hasher md5;
+    md5.MD5Init();
+    md5.MD5Update(reinterpret_cast<const unsigned char*>(content.data()),
+                  unsigned(length));
+    expected.push_back(md5.MD5Final());
+  }
+
+  for (auto impl : {MD5MultiBuffer::SCALAR, MD5MultiBuffer::SSE2,
+                    MD5MultiBuffer::AVX2, MD5MultiBuffer::AVX512}) {
+    if (!MD5MultiBuffer::isSupported(impl)) continue;
+    ASSERT_EQ(MD5MultiBuffer::hash(inputs, impl), expected) << impl;
+  }
+  ASSERT_EQ(expected[0], "d41d8cd98f00b204e9800998ecf8427e");
+}
+
+/**
+ * @brief The span API gives raw digests matching the hex ones, across
+ * updates that split blocks.
+ */
+TEST(HashSpanTest, RawDigests) {
+  const std::string text = "The quick brown fox jumps over the lazy dog";
+  auto bytes = std::as_bytes(std::span(text.data(), text.size()));
+
+  SHA1 sha1;
+  sha1.update(bytes.first(10));
+  sha1.update(bytes.subspan(10));
+  SHA1::Digest raw = sha1.finalDigest();
+  ASSERT_EQ(raw[0], 0x2f);
+  ASSERT_EQ(raw[19], 0x12);
+  ASSERT_EQ(Hex::toString(raw), "2fd4e1c67a2d28fced849ee1bb76e7391b93eb12");
+
+  MD5Hasher md5;
+  md5.MD5Init();
+  md5.update(bytes);
+  ASSERT_EQ(Hex::toString(md5.finalDigest()),
+            "9e107d9d372bb6826bd81d3542a419d6");
+
+  const uint8_t edge[] = {0x00, 0x0f, 0xa0, 0xff};
+  char out[8];
+  Hex::encode(edge, sizeof(edge), out);
+  ASSERT_EQ(std::string(out, 8), "000fa0ff");
+}
+
+/**
+ * @brief SHA-256 test vectors from FIPS 180-4, every block function the
+ * CPU supports, and digests picked by name.
+ */
+TEST(SHA256Test, Vectors) {
+  const std::string two = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+  std::string longer;
+  for (int i = 0; i < 1000; i++) longer += char(i * 11 + 5);
+
+  for (auto impl : {SHA256::SCALAR, SHA256::SHA_NI}) {
+    if (!SHA256::isSupported(impl)) continue;
+    SHA256 sha256(impl);
+    ASSERT_EQ(sha256.final(),
+              "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    sha256.update(reinterpret_cast<const uint8_t*>("abc"), 3);
+    ASSERT_EQ(sha256.final(),
+              "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    sha256.update(reinterpret_cast<const uint8_t*>(two.data()), two.size());
+    ASSERT_EQ(sha256.final(),
+              "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+    SHA256 scalar(SHA256::SCALAR);
+    scalar.update(reinterpret_cast<const uint8_t*>(longer.data()), 1000);
+    sha256.update(reinterpret_cast<const uint8_t*>(longer.data()), 333);
+    sha256.update(reinterpret_cast<const uint8_t*>(longer.data()) + 333, 667);
+    ASSERT_EQ(sha256.final(), scalar.final());
+  }
+
+  ASSERT_EQ(MultiHasher::parseDigests("md5,sha256"),
+            uint32_t(MultiHasher::MD5_DIGEST | MultiHasher::SHA256_DIGEST));
+  ASSERT_EQ(MultiHasher::parseDigests("none"), 0u);
+  EXPECT_THROW(MultiHasher::parseDigests("crc"), std::invalid_argument);
+
+  ScanResult result = FileIO::scan("../samples/elf/libresolv.so.2",
+                                   MultiHasher::SHA256_DIGEST);
+  ASSERT_TRUE(result.md5_hash.empty());
+  ASSERT_EQ(result.sha256_hash.size(), 64u);
+}
+
+/**
+ * @brief BLAKE3 test vectors (input byte i is i % 251) around the chunk
+ * and tree boundaries, for every lane count the CPU supports, on one
+ * thread and split across several.
+ */
+TEST(BLAKE3Test, Vectors) {
+  const std::vector<std::pair<size_t, std::string>> vectors = {
+      {0, "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262"},
+      {1, "2d3adedff11b61f14c886e35afa036736dcd87a74d27b5c1510225d0f592e213"},
+      {1024, "42214739f095a406f3fc83deb889744ac00df831c10daa55189b5d121c855af7"},
+      {1025, "d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444"},
+      {2048, "e776b6028c7cd22a4d0ba182a8bf62205d2ef576467e838ed6f2529b85fba24a"},
+      {3072, "b98cb0ff3623be03326b373de6b9095218513e64f1ee2edd2525c7ad1e5cffd2"},
+      {65553, "d7237065168e826db9ae1c58f0bca9496d8a4436caf6218f2bda165ae5ae3d37"},
+      {4195538, "9fe3060d42e9917971bf85497c0781413336752f99edb44087b9d8d64a641cf9"}};
+
+  std::vector<std::byte> input(4195538);
+  for (size_t idx = 0; idx < input.size(); idx++) {
+    input[idx] = std::byte(idx % 251);
+  }
+
+  for (auto impl : {BLAKE3::SCALAR, BLAKE3::SSE2, BLAKE3::AVX2, BLAKE3::AVX512}) {
+    if (!BLAKE3::isSupported(impl)) continue;
+    for (const auto& [length, expected] : vectors) {
+      std::span<const std::byte> content(input.data(), length);
+      ASSERT_EQ(Hex::toString(BLAKE3::hash(content, 1, impl)), expected);
+      ASSERT_EQ(Hex::toString(BLAKE3::hash(content, 3, impl)), expected);
+    }
+  }
+
+  ASSERT_EQ(MultiHasher::parseDigests("blake3"),
+            uint32_t(MultiHasher::BLAKE3_DIGEST));
+  ScanResult result = FileIO::scan("../samples/elf/libresolv.so.2",
+                                   MultiHasher::BLAKE3_DIGEST);
+  ASSERT_TRUE(result.sha1_hash.empty());
+  ASSERT_EQ(result.blake3_hash.size(), 64u);
+}
+
+/**
+ * @brief CRC32C check value and the table and SSE4.2 versions agreeing on
+ * unaligned input of odd sizes.
+ */
+TEST(CRC32CTest, Vectors) {
+  std::string longer;
+  for (int i = 0; i < 5000; i++) longer += char(i * 7 + 3);
+
+  CRC32C scalar(CRC32C::SCALAR);
+  for (auto impl : {CRC32C::SCALAR, CRC32C::SSE42}) {
+    if (!CRC32C::isSupported(impl)) continue;
+    CRC32C crc(impl);
+    ASSERT_EQ(crc.finalValue(), 0u);
+    crc.update(reinterpret_cast<const uint8_t*>("123456789"), 9);
+    ASSERT_EQ(crc.final(), "e3069283");
+
+    for (size_t length : {1, 7, 8, 9, 63, 4999}) {
+      const uint8_t* data = reinterpret_cast<const uint8_t*>(longer.data());
+      crc.update(data + 1, length / 2);
+      crc.update(data + 1 + length / 2, length - length / 2);
+      scalar.update(data + 1, length);
+      ASSERT_EQ(crc.finalValue(), scalar.finalValue());
+    }
+  }
+
+  ASSERT_EQ(MultiHasher::parseDigests("crc32c"),
+            uint32_t(MultiHasher::CRC32C_DIGEST));
+  MultiHasher hasher(MultiHasher::CRC32C_DIGEST);
+  hasher.update({reinterpret_cast<const std::byte*>("123456789"), 9});
+  hasher.final();
+  ASSERT_EQ(hasher.getCRC32CValue(), 0xE3069283u);
+  ASSERT_TRUE(hasher.getMD5().empty());
+}
+
 #endif
@@ -78,4 +78,401 @@ TEST_F(PETest, dataVirtualAddress) {
   ASSERT_TRUE(pe.getSection(2).getVirtualAddress() == 0x001B4000);
 }
 
+// an image embedded at an offset inside a larger buffer
+TEST_F(PETest, ParseFromMemory) {
+  MappedFile file("../samples/pe/dbghelp.dll");
+  std::vector<std::byte> buffer(16, std::byte{0xCC});
+  buffer.insert(buffer.end(), file.bytes().begin(), file.bytes().end());
+
+  PE image;
+  image.init(buffer, 16);
+  ASSERT_EQ(image.getElfanew(), pe.getElfanew());
+  ASSERT_EQ(image.getChecksum(), 0x001E7393);
+  ASSERT_EQ(image.getSection(2).getVirtualAddress(), 0x001B4000);
+
+  PE past;
+  EXPECT_THROW(past.init(buffer, buffer.size() + 1), std::out_of_range);
+}
+
+/**
+ * @brief A unit test checking RVAs are translated through the sections,
+ * including the headers below the first section and addresses no section
+ * covers.
+ */
+TEST_F(PETest, RvaToOffset) {
+  // the import table, inside .rdata (RVA 0x15b000, raw data at 0x159600)
+  ASSERT_EQ(pe.getDataDirectory(PE::IMPORT_TABLE).getVA(), 0x1b2168);
+  ASSERT_EQ(pe.getDataDirectory(PE::IMPORT_TABLE).getOffset(), 0x1b0768);
+  ASSERT_EQ(pe.rvaToOffset(0x15b000), 0x159600);
+  ASSERT_EQ(pe.rvaToOffset(0x40), 0x40);
+  EXPECT_THROW(pe.rvaToOffset(0xfffffff0), std::runtime_error);
+}
+
+/**
+ * @brief A unit test checking the imports of a PE32+ DLL and of a PE32
+ * driver, whose lookup tables hold 64 and 32 bit entries.
+ */
+TEST_F(PETest, Imports) {
+  const std::vector<ImportDirectory>& imports = pe.getImports();
+  ASSERT_EQ(imports.size(), 28);
+  ASSERT_EQ(imports[0].getName(), "api-ms-win-crt-string-l1-1-0.dll");
+  ASSERT_EQ(imports[0].getAddressTableRVA(), 0x173ea8);
+
+  const ImportedFunction& strncmp = imports[0].getFunctions()[0];
+  ASSERT_FALSE(strncmp.isByOrdinal());
+  ASSERT_EQ(strncmp.getName(), "strncmp");
+  ASSERT_EQ(strncmp.getHint(), 142);
+  ASSERT_EQ(strncmp.getAddressRVA(), 0x173ea8);
+  ASSERT_EQ(imports[0].getFunctions()[1].getAddressRVA(), 0x173eb0);
+
+  PE driver;
+  driver.init("../samples/pe/win32k.sys");
+  const std::vector<ImportDirectory>& driverImports = driver.getImports();
+  ASSERT_EQ(driverImports.size(), 6);
+  ASSERT_EQ(driverImports[0].getName(), "ntoskrnl.exe");
+  ASSERT_EQ(driverImports[0].getFunctions()[1].getName(),
+            "IoGetDeviceObjectPointer");
+  ASSERT_EQ(driverImports[0].getFunctions()[1].getHint(), 769);
+  ASSERT_EQ(driverImports[0].getFunctions()[1].getAddressRVA(), 0x2a4ac);
+
+  OutputBuffer out;
+  pe.printImports(out);
+  ASSERT_EQ(out.view().rfind("Import: api-ms-win-crt-string-l1-1-0.dll\n"
+                             " strncmp (hint 142)\n", 0), 0);
+}
+
+/**
+ * @brief A unit test checking a damaged import table is reported on its
+ * own: the headers, the other directories and the digests are kept.
+ */
+TEST_F(PETest, DamagedImports) {
+  MappedFile file("../samples/pe/dbghelp.dll");
+  std::vector<std::byte> image(file.bytes().begin(), file.bytes().end());
+
+  // names aren't copied, they point into the image
+  PE copy;
+  copy.init(image);
+  std::string_view name = copy.getImports()[0].getFunctions()[0].getName();
+  ASSERT_EQ(name, "strncmp");
+  ASSERT_TRUE(reinterpret_cast<const std::byte*>(name.data()) >= image.data() &&
+              reinterpret_cast<const std::byte*>(name.data()) <
+                  image.data() + image.size());
+
+  // a DLL name without a NUL in its first 4K
+  std::vector<std::byte> longName = image;
+  uint64_t offset = pe.rvaToOffset(pe.getImports()[0].getNameRVA());
+  std::fill_n(longName.begin() + offset, 5000, std::byte('A'));
+  PE damaged;
+  damaged.init(longName);
+  ASSERT_EQ(damaged.getDirectoryError(PE::IMPORT_TABLE).code,
+            ErrorCode::MALFORMED_TABLE);
+  ASSERT_TRUE(damaged.getImports().empty());
+  ASSERT_EQ(damaged.getNumberOfSections(), pe.getNumberOfSections());
+
+  // an import table outside of every section, the directory entry is at
+  // e_lfanew + 24 + 112 + 8 in a PE32+ image.
+  std::vector<std::byte> unmapped = image;
+  uint32_t rva = 0x7ffffff0;
+  std::memcpy(unmapped.data() + 0x1a0, &rva, 4);
+  ScanResult result = FileIO::scan(unmapped, "unmapped",
+                                   MultiHasher::AUTHENTICODE_SHA256_DIGEST);
+  ASSERT_FALSE(result.error);
+  ASSERT_EQ(result.pe->getDirectoryError(PE::IMPORT_TABLE).code,
+            ErrorCode::MALFORMED_TABLE);
+  ASSERT_FALSE(result.pe->getDirectoryError(PE::EXPORT_TABLE));
+  ASSERT_EQ(result.authenticode_sha256_hash.size(), 64u);
+
+  OutputBuffer out;
+  FileIO::render(result, out, FileIO::IMPORT_DETAILS);
+  ASSERT_NE(out.view().find("Number of sections: "), std::string_view::npos);
+  ASSERT_NE(out.view().find("Import table not read: "),
+            std::string_view::npos);
+}
+
+/**
+ * @brief A unit test checking import descriptors sharing one thunk table
+ * are read until a cap on imported functions, then the directory fails.
+ */
+TEST_F(PETest, AliasedImports) {
+  MappedFile file("../samples/pe/dbghelp.dll");
+  std::vector<std::byte> image(file.bytes().begin(), file.bytes().end());
+  const uint8_t* descriptor = reinterpret_cast<const uint8_t*>(
+      image.data() + pe.getDataDirectory(PE::IMPORT_TABLE).getOffset());
+  uint64_t functions = pe.getImports()[0].getFunctions().size();
+
+  // copies of the first descriptor at the start of .text, the import
+  // directory entry is at 0x1a0.
+  PESection text = pe.getSection(0);
+  auto alias = [&](uint64_t copies) {
+    std::vector<std::byte> aliased = image;
+    std::byte* table = aliased.data() + text.getRawDataPointer();
+    for (uint64_t i = 0; i < copies; ++i) {
+      std::memcpy(table + 20 * i, descriptor, 20);
+    }
+    std::memset(table + 20 * copies, 0, 20);
+    uint32_t rva = text.getVirtualAddress();
+    std::memcpy(aliased.data() + 0x1a0, &rva, 4);
+    return aliased;
+  };
+
+  std::vector<std::byte> few = alias(3);
+  PE shared;
+  shared.init(few);
+  ASSERT_FALSE(shared.getDirectoryError(PE::IMPORT_TABLE));
+  ASSERT_EQ(shared.getImports().size(), 3);
+  ASSERT_EQ(shared.getImports()[2].getFunctions().size(), functions);
+
+  uint64_t copies = (1 << 16) / functions + 2;
+  ASSERT_LE(20 * (copies + 1), text.getRawDataSize());
+  std::vector<std::byte> many = alias(copies);
+  PE damaged;
+  damaged.init(many);
+  ASSERT_EQ(damaged.getDirectoryError(PE::IMPORT_TABLE).code,
+            ErrorCode::MALFORMED_TABLE);
+  uint64_t read = 0;
+  for (const ImportDirectory& dll : damaged.getImports()) {
+    read += dll.getFunctions().size();
+  }
+  ASSERT_LE(read, 1u << 16);
+  ASSERT_EQ(damaged.getNumberOfSections(), pe.getNumberOfSections());
+}
+
+/**
+ * @brief A unit test checking exports are found by name and by ordinal,
+ * including forwarded exports and ordinals that have no name.
+ */
+TEST_F(PETest, Exports) {
+  const ExportDirectory& exports = pe.getExports();
+  ASSERT_EQ(exports.getName(), "dbghelp.dll");
+  ASSERT_EQ(exports.getOrdinalBase(), 1101);
+  ASSERT_EQ(exports.getFunctions().size(), 256);
+
+  const ExportedFunction* dump = exports.findByName("DbgHelpCreateUserDump");
+  ASSERT_NE(dump, nullptr);
+  ASSERT_EQ(dump->getOrdinal(), 1125);
+  ASSERT_FALSE(dump->isForwarded());
+
+  const ExportedFunction* forwarded = exports.findByName("MiniDumpWriteDump");
+  ASSERT_NE(forwarded, nullptr);
+  ASSERT_EQ(forwarded->getOrdinal(), 1154);
+  ASSERT_EQ(forwarded->getForwarder(), "dbgcore.MiniDumpWriteDump");
+
+  const ExportedFunction* unnamed = exports.findByOrdinal(1101);
+  ASSERT_NE(unnamed, nullptr);
+  ASSERT_TRUE(unnamed->getName().empty());
+  ASSERT_EQ(unnamed->getAddressRVA(), 0x263e0);
+  ASSERT_EQ(exports.findByOrdinal(1154), forwarded);
+
+  ASSERT_EQ(exports.findByName("NoSuchExport"), nullptr);
+  ASSERT_EQ(exports.findByOrdinal(1100), nullptr);
+
+  PE driver;
+  driver.init("../samples/pe/win32k.sys");
+  ASSERT_EQ(driver.getExports().getFunctions().size(), 1584);
+  ASSERT_EQ(driver.getExports().findByName("EngBugCheckEx")->getForwarder(),
+            "NTOSKRNL.KeBugCheckEx");
+}
+
+/**
+ * @brief A unit test checking damaged export tables are reported per
+ * directory without exhausting memory, and that names are shared by RVA.
+ */
+TEST_F(PETest, DamagedExports) {
+  MappedFile file("../samples/pe/dbghelp.dll");
+  std::vector<std::byte> image(file.bytes().begin(), file.bytes().end());
+  const ExportDirectory& exports = pe.getExports();
+  uint64_t directory = pe.getDataDirectory(PE::EXPORT_TABLE).getOffset();
+  uint64_t pointers = pe.rvaToOffset(exports.getNamePointerRVA());
+  uint32_t first;
+  std::memcpy(&first, image.data() + pointers, 4);
+
+  // every name pointer at the same RVA reads that name once
+  std::vector<std::byte> shared = image;
+  for (uint32_t i = 0; i < exports.getNumberOfNamePointers(); ++i) {
+    std::memcpy(shared.data() + pointers + 4 * i, &first, 4);
+  }
+  PE aliased;
+  aliased.init(shared);
+  ASSERT_FALSE(aliased.getDirectoryError(PE::EXPORT_TABLE));
+  const char* data = nullptr;
+  for (const ExportedFunction& function :
+       aliased.getExports().getFunctions()) {
+    if (function.getName().empty()) continue;
+    if (!data) data = function.getName().data();
+    ASSERT_EQ(function.getName().data(), data);
+  }
+  ASSERT_NE(data, nullptr);
+
+  // ... and a name without a NUL in its first 4K fails the directory
+  std::fill_n(shared.begin() + pe.rvaToOffset(first), 5000, std::byte('A'));
+  PE longName;
+  longName.init(shared);
+  ASSERT_EQ(longName.getDirectoryError(PE::EXPORT_TABLE).code,
+            ErrorCode::MALFORMED_TABLE);
+  ASSERT_EQ(longName.getNumberOfSections(), pe.getNumberOfSections());
+
+  // NumberOfNames past the end of the file is not reserved
+  std::vector<std::byte> huge = image;
+  uint32_t count = 0xffffffff;
+  std::memcpy(huge.data() + directory + 24, &count, 4);
+  PE truncated;
+  truncated.init(huge);
+  ASSERT_EQ(truncated.getDirectoryError(PE::EXPORT_TABLE).code,
+            ErrorCode::TRUNCATED);
+  ASSERT_EQ(truncated.getNumberOfSections(), pe.getNumberOfSections());
+
+  OutputBuffer out;
+  pe.printExports(out);
+  ASSERT_NE(out.view().find("Export: dbghelp.dll\n"), std::string_view::npos);
+  ASSERT_NE(out.view().find(" 1101 (no name) 0x263e0\n"),
+            std::string_view::npos);
+  ASSERT_NE(out.view().find(" 1154 MiniDumpWriteDump -> "
+                            "dbgcore.MiniDumpWriteDump\n"),
+            std::string_view::npos);
+}
+
+/**
+ * @brief A unit test checking resources are looked up by path straight
+ * from the mapped image, and the version resource is decoded.
+ */
+TEST_F(PETest, Resources) {
+  MappedFile file("../samples/pe/dbghelp.dll");
+  ResourceDirectory root = pe.getResources(file.bytes());
+  ASSERT_EQ(root.size(), 2);
+  ASSERT_FALSE(root.lookup(PE::RT_ICON));
+
+  ResourceEntry version = root.lookup(PE::RT_VERSION, 1, 0x409);
+  ASSERT_TRUE(version);
+  ASSERT_EQ(version.getData().getDataRVA(), 0x1ed7c0);
+  ASSERT_EQ(version.getData().getSize(), 0x388);
+
+  VersionInfo info = pe.getVersionInfo(file.bytes());
+  ASSERT_EQ(info.getFileVersion(), 0x000a000047ba0001);
+  ASSERT_EQ(info.getString("FileVersion"), "10.0.18362.1 (WinBuild.160101.0800)");
+  ASSERT_EQ(info.getString("CompanyName"), "Microsoft Corporation");
+  ASSERT_EQ(info.getString("ProductName"),
+            "Microsoft\u00ae Windows\u00ae Operating System");
+  ASSERT_TRUE(info.getString("Comments").empty());
+
+  // a manifest, but no version resource
+  MappedFile tool("../samples/pe/gimptool-2.0.exe");
+  PE gimptool;
+  gimptool.init(tool.bytes());
+  ResourceEntry manifest =
+      gimptool.getResources(tool.bytes()).lookup(PE::RT_MANIFEST);
+  ASSERT_TRUE(manifest);
+  ASSERT_EQ(manifest.getData().getSize(), 0x48f);
+  ASSERT_TRUE(gimptool.getVersionInfo(tool.bytes()).empty());
+}
+
+/**
+ * @brief A unit test checking base relocations, TLS callbacks and load
+ * config tables are iterated straight from the mapped image.
+ */
+TEST_F(PETest, StreamedDirectories) {
+  MappedFile file("../samples/pe/dbghelp.dll");
+  uint64_t blocks = 0;
+  uint64_t fixups = 0;
+  for (RelocationBlock block : pe.getRelocations(file.bytes())) {
+    if (blocks++ == 0) {
+      ASSERT_EQ(block.getPageRVA(), 0x15b000);
+      ASSERT_EQ(block.getBlockSize(), 0x408);
+      ASSERT_EQ(block.getEntries()[1].getRVA(), 0x15b008);
+      ASSERT_EQ(block.getEntries()[1].getType(), 10);  // DIR64
+    }
+    for (Relocation relocation : block.getEntries()) {
+      fixups += relocation.getType() != 0;
+    }
+  }
+  ASSERT_EQ(blocks, 37);
+  ASSERT_EQ(fixups, 9920);
+
+  LoadConfig config = pe.getLoadConfig(file.bytes());
+  ASSERT_EQ(config.getSize(), 0x108);
+  ASSERT_EQ(config.getSecurityCookie(), 0x1031ba300);
+  ASSERT_TRUE(config.getSafeSehHandlers().empty());
+  ASSERT_EQ(config.getGuardCFFunctions().size(), 3174);
+  ASSERT_EQ(config.getGuardCFFunctions()[2].getAddress(), 0x1330);
+  ASSERT_TRUE(pe.getTls(file.bytes()).empty());
+
+  // PE32 driver with a SafeSEH table
+  MappedFile sys("../samples/pe/win32k.sys");
+  PE driver;
+  driver.init(sys.bytes());
+  LoadConfig driverConfig = driver.getLoadConfig(sys.bytes());
+  ASSERT_EQ(driverConfig.getSecurityCookie(), 0x48ad0);
+  ASSERT_EQ(driverConfig.getSafeSehHandlers().size(), 1);
+  ASSERT_EQ(driverConfig.getSafeSehHandlers()[0].getAddress(), 0x286e8);
+
+  MappedFile tool("../samples/pe/gimptool-2.0.exe");
+  PE gimptool;
+  gimptool.init(tool.bytes());
+  TlsDirectory tls = gimptool.getTls(tool.bytes());
+  ASSERT_FALSE(tls.empty());
+  ASSERT_EQ(tls.getCallbacks().size(), 2);
+  ASSERT_EQ(tls.getCallbacks()[0].getAddress(), 0x140002400);
+  ASSERT_TRUE(gimptool.getLoadConfig(tool.bytes()).empty());
+}
+
+/**
+ * @brief A unit test checking the certificate table is iterated in place
+ * and the Authenticode digests match the ones the signatures hold.
+ */
+TEST_F(PETest, Authenticode) {
+  MappedFile file("../samples/pe/dbghelp.dll");
+  uint32_t count = 0;
+  for (WinCertificate certificate : pe.getCertificates(file.bytes())) {
+    ASSERT_EQ(certificate.getLength(), 0x2298);
+    ASSERT_EQ(certificate.getRevision(), 0x200);
+    ASSERT_EQ(certificate.getType(),
+              WinCertificate::WIN_CERT_TYPE_PKCS_SIGNED_DATA);
+    ASSERT_EQ(certificate.getData().size(), 0x2290);
+    ASSERT_EQ(certificate.getData()[0], std::byte(0x30));  // DER SEQUENCE
+    count++;
+  }
+  ASSERT_EQ(count, 1);
+  ASSERT_EQ(pe.getAuthenticodeGaps()[2].first, 0x1d7000);
+
+  uint32_t digests = MultiHasher::MD5_DIGEST |
+                     MultiHasher::AUTHENTICODE_DIGESTS;
+  ScanResult signedDll = FileIO::scan("../samples/pe/dbghelp.dll", digests);
+  ASSERT_EQ(signedDll.authenticode_sha1_hash,
+            "d7fec186fd1f96db496f33bb35c581a5532e2035");
+  ASSERT_EQ(signedDll.authenticode_sha256_hash,
+            "abc989ff7aaf20bf253ca5c85c3ce5867e6693ef484165f99571e5e13e5f45ea");
+  ASSERT_EQ(signedDll.md5_hash.size(), 32u);
+
+  ScanResult signedExe =
+      FileIO::scan("../samples/pe/gimptool-2.0.exe", digests);
+  ASSERT_EQ(signedExe.authenticode_sha256_hash,
+            "c2c1f8361c3514b8fdc5879d274aec451776e3d10f82c1db3c7ee862f32697f0");
+
+  // PE32 and unsigned: only the checksum and the empty entry are skipped
+  ScanResult driver = FileIO::scan("../samples/pe/win32k.sys", digests);
+  ASSERT_EQ(driver.authenticode_sha1_hash,
+            "6db2a52f25c64ebc05c99ffc9503e033e9174804");
+  MappedFile sys("../samples/pe/win32k.sys");
+  ASSERT_TRUE(driver.pe->getCertificates(sys.bytes()).empty());
+
+  ScanResult elf = FileIO::scan("../samples/elf/libresolv.so.2", digests);
+  ASSERT_TRUE(elf.authenticode_sha256_hash.empty());
+}
+
+/**
+ * @brief A unit test checking flag tables keep the first name given for a
+ * value and return nothing for values they don't know.
+ */
+TEST(FlagTableTest, Lookup) {
+  constexpr FlagTable table({{0x20, "second"}, {0x1, "first"},
+                             {0x20, "duplicate"}, {0x4, "third"}});
+  static_assert(table.size() == 3);
+
+  ASSERT_EQ(table.find(0x1), "first");
+  ASSERT_EQ(table.find(0x20), "second");
+  ASSERT_TRUE(table.find(0x2).empty());
+  ASSERT_EQ(PE::getFlagName(PE::MACHINETYPE, 0x8664), "IMAGE_FILE_MACHINE_AMD64");
+  ASSERT_EQ(ELF::getFlagName(ELF::EMACHINE, 62), "64bit (EM_X86_64)");
+  ASSERT_TRUE(ELF::getFlagName(ELF::ETYPE, 0x1234).empty());
+}
+
 #endif
\ No newline at end of file
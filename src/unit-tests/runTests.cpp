@@ -12,6 +12,7 @@
 #include "mach_o-test.h"
 #include "hashtest.h"
 #include "fileio_test.h"
+#include "batch_test.h"
 
 int main(int argc, char* argv[]) {
   testing::InitGoogleTest(&argc, argv);